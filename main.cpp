@@ -1,21 +1,158 @@
 //
 // Created by Johnny Gonzales on 8/19/25.
 //
+#include <chrono>
 #include <filesystem>
 #include <iostream>
+#include <optional>
+#include <string>
 
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "spdlog/spdlog.h"
+#include "src/allocation_stats.h"
 #include "src/application.h"
+#include "src/board_sync.h"
+#include "src/board_transfer.h"
+#include "src/card_store.h"
+#include "src/trace.h"
 
 
-int main()
+// `import <file>` / `export <file>` run headless against the app's database and exit
+static std::optional<int> runTransferCommand(int argc, char *argv[])
 {
-    try
+    if (argc != 3) return std::nullopt;
+
+    const std::string command = argv[1];
+    if (command != "import" && command != "export") return std::nullopt;
+
+    const std::string path = argv[2];
+    const auto format = todo::transferFormatForPath(path);
+    if (!format)
+    {
+        std::cerr << "Unknown file type (expected .jsonl, .csv or a Trello/Jira .json export): " << path << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    todo::CardDatabase db(getDatabasePath());
+    if (command == "import")
+    {
+        // Sessions only see their own connection: like the app's import job, record the import
+        // so the other devices of a synced board receive it
+        std::optional<todo::BoardSync> sync;
+        if (const std::string folder = todo::BoardSync::configuredFolder(db); !folder.empty()) sync.emplace(db, folder);
+
+        const bool imported = todo::importBoard(db, path, *format);
+        if (sync) sync->exportChanges();
+        return imported ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Attaching the archive lets archived cards go out with the rest of the board
+    todo::CardArchiver archiver(db, getArchivePath());
+    return todo::exportBoard(db.handle(), path, *format) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// `sync <folder>` joins the board to a sync folder shared with other devices and applies
+// their changes; the app keeps syncing through that folder from then on
+static std::optional<int> runSyncCommand(int argc, char *argv[])
+{
+    if (argc != 3 || std::string(argv[1]) != "sync") return std::nullopt;
+
+    todo::CardDatabase db(getDatabasePath());
+    todo::BoardSync sync(db, argv[2]);
+    todo::BoardSync::Stats stats;
+    const int applied = sync.importChanges(&stats);
+    if (applied < 0) return EXIT_FAILURE;
+
+    std::cout << "Device " << sync.device() << ": applied " << applied << " changesets (" << stats.bytes
+              << " bytes, " << stats.conflicts << " conflicts)" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+// `alloc-check [frames] [limit]` opens the board, draws `frames` frames (600 by default) and fails
+// when steady-state frames made more than `limit` heap allocations on average (0 by default)
+static std::optional<int> runAllocationCheck(int argc, char *argv[])
+{
+    if (argc < 2 || argc > 4 || std::string(argv[1]) != "alloc-check") return std::nullopt;
+
+    const int frames = argc > 2 ? std::stoi(argv[2]) : 600;
+    const double limit = argc > 3 ? std::stod(argv[3]) : 0.0;
+
+    todo::AllocationTally tally;
     {
         todo::Application app;
+        app.limitFrames(frames);
         app.run();
+        tally = app.steadyStateAllocations();
+    }
+
+    if (tally.frames == 0)
+    {
+        std::cerr << "No steady-state frames in " << frames << "; the board did not load in time" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << tally.frames << " steady-state frames: " << tally.meanCount() << " allocations per frame on average ("
+              << tally.maxCount << " max, " << tally.bytes / tally.frames << " bytes per frame)" << std::endl;
+    if (tally.meanCount() > limit)
+    {
+        std::cerr << "Over the limit of " << limit << " allocations per frame" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+// `memory-bench [cards]` builds a synthetic board of `cards` cards (1M by default) and reports
+// what it takes in memory as TodoCards and packed into a CardStore
+static std::optional<int> runMemoryBenchmark(int argc, char *argv[])
+{
+    if (argc < 2 || argc > 3 || std::string(argv[1]) != "memory-bench") return std::nullopt;
+
+    const int count = argc > 2 ? std::stoi(argv[2]) : 1000000;
+    const char *descriptions[] = {
+        "", "Check with design before the next planning session", "Waiting on review",
+        "Reproduce on the release build, then bisect the regression and write up what changed"
+    };
+
+    const todo::AllocationCount before = todo::threadAllocations();
+    std::vector<todo::TodoCard> cards;
+    cards.reserve(count);
+    for (int i = 0; i < count; i++)
+    {
+        const auto status = todo::intToStatus(i % 3);
+        cards.emplace_back(i + 1, "Card " + std::to_string(i + 1) + ": update the release checklist",
+                           descriptions[i % std::size(descriptions)], status, i, i % 20, "2025-08-19 09:30:00",
+                           status == todo::CardStatus::Done ? "2025-09-02 17:45:12" : "");
+    }
+    const std::uint64_t cardBytes = (todo::threadAllocations() - before).bytes;
+
+    todo::CardStore store;
+    const auto start = std::chrono::steady_clock::now();
+    store.assign(cards);
+    const double packMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << count << " cards" << std::endl;
+    std::cout << "TodoCard:  " << cardBytes / count << " bytes per card (" << cardBytes / (1024 * 1024) << " MiB)"
+              << std::endl;
+    std::cout << "CardStore: " << store.memoryUsage() / count << " bytes per card ("
+              << store.memoryUsage() / (1024 * 1024) << " MiB), packed in " << packMs << " ms" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        if (const auto exitCode = runTransferCommand(argc, argv)) return *exitCode;
+        if (const auto exitCode = runSyncCommand(argc, argv)) return *exitCode;
+        if (const auto exitCode = runAllocationCheck(argc, argv)) return *exitCode;
+        if (const auto exitCode = runMemoryBenchmark(argc, argv)) return *exitCode;
+
+        {
+            todo::Application app;
+            app.run();
+        }
+        // After the Application is gone, so the trace covers the whole shutdown
+        todo::writeChromeTrace(getTracePath());
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
         return EXIT_FAILURE;
@@ -0,0 +1,114 @@
+#include "allocation_stats.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace todo {
+    namespace {
+        // Constant-initialized, so touching them from operator new never allocates or recurses
+        thread_local AllocationCount counts;
+
+        void *allocate(std::size_t size)
+        {
+            if (size == 0) size = 1;
+            counts.count++;
+            counts.bytes += size;
+            return std::malloc(size);
+        }
+
+        void *allocateAligned(std::size_t size, const std::size_t alignment)
+        {
+            if (size == 0) size = 1;
+            counts.count++;
+            counts.bytes += size;
+#ifdef _WIN32
+            return _aligned_malloc(size, alignment);
+#else
+            void *pointer = nullptr;
+            return posix_memalign(&pointer, std::max(alignment, sizeof(void *)), size) == 0 ? pointer : nullptr;
+#endif
+        }
+
+        void freeAligned(void *pointer)
+        {
+#ifdef _WIN32
+            _aligned_free(pointer);
+#else
+            std::free(pointer);
+#endif
+        }
+    }
+
+    AllocationCount threadAllocations()
+    {
+        return counts;
+    }
+
+    void *countedAlloc(const std::size_t size, void *)
+    {
+        return allocate(size);
+    }
+
+    void countedFree(void *pointer, void *)
+    {
+        std::free(pointer);
+    }
+}
+
+void *operator new(const std::size_t size)
+{
+    if (void *pointer = todo::allocate(size)) return pointer;
+    throw std::bad_alloc();
+}
+
+void *operator new[](const std::size_t size)
+{
+    if (void *pointer = todo::allocate(size)) return pointer;
+    throw std::bad_alloc();
+}
+
+void *operator new(const std::size_t size, const std::nothrow_t &) noexcept
+{
+    return todo::allocate(size);
+}
+
+void *operator new[](const std::size_t size, const std::nothrow_t &) noexcept
+{
+    return todo::allocate(size);
+}
+
+void *operator new(const std::size_t size, const std::align_val_t alignment)
+{
+    if (void *pointer = todo::allocateAligned(size, static_cast<std::size_t>(alignment))) return pointer;
+    throw std::bad_alloc();
+}
+
+void *operator new[](const std::size_t size, const std::align_val_t alignment)
+{
+    if (void *pointer = todo::allocateAligned(size, static_cast<std::size_t>(alignment))) return pointer;
+    throw std::bad_alloc();
+}
+
+void *operator new(const std::size_t size, const std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return todo::allocateAligned(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](const std::size_t size, const std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return todo::allocateAligned(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::align_val_t) noexcept { todo::freeAligned(pointer); }
+void operator delete[](void *pointer, std::align_val_t) noexcept { todo::freeAligned(pointer); }
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept { todo::freeAligned(pointer); }
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept { todo::freeAligned(pointer); }
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { todo::freeAligned(pointer); }
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { todo::freeAligned(pointer); }
@@ -0,0 +1,46 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace todo {
+    struct AllocationCount
+    {
+        std::uint64_t count = 0;
+        std::uint64_t bytes = 0;
+
+        AllocationCount operator-(const AllocationCount &other) const
+        {
+            return {count - other.count, bytes - other.bytes};
+        }
+    };
+
+    // Allocations made by the calling thread through the global operator new, and through ImGui
+    // once it uses countedAlloc/countedFree, since the thread started. allocation_stats.cpp
+    // replaces operator new to keep these; the counters are plain thread-locals, so reading and
+    // updating them costs next to nothing.
+    AllocationCount threadAllocations();
+
+    // For ImGui::SetAllocatorFunctions()
+    void *countedAlloc(std::size_t size, void *userData);
+    void countedFree(void *pointer, void *userData);
+
+    // Running totals over a series of frames
+    struct AllocationTally
+    {
+        std::uint64_t frames = 0;
+        std::uint64_t count = 0;
+        std::uint64_t bytes = 0;
+        std::uint64_t maxCount = 0;
+
+        void add(const AllocationCount &frame)
+        {
+            frames++;
+            count += frame.count;
+            bytes += frame.bytes;
+            maxCount = std::max(maxCount, frame.count);
+        }
+
+        [[nodiscard]] double meanCount() const { return frames ? static_cast<double>(count) / frames : 0.0; }
+    };
+}
@@ -5,10 +5,15 @@
 #include "application.h"
 #include "card_database.h"
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <thread>
 #include "graphics.h"
 #include "imgui.h"
 #include "imgui_impl_vulkan.h"
 #include "imgui_renderer.h"
+#include "startup_graph.h"
+#include "trace.h"
 
 
 #include "audio_engine.h"
@@ -27,63 +32,551 @@ static void framebufferResizeCallback(GLFWwindow *window, int width, int height)
 
 
 namespace todo {
+    struct BoardState
+    {
+        CardStore cards; // packed on the reader, off the UI thread
+        std::vector<proj::Project> projects;
+        std::int64_t changeSeq = 0;
+    };
+
     void Application::reloadAppState()
     {
-        loadCards();
-        loadProjects();
+        // Read on a worker connection; the UI keeps drawing the current board until it lands
+        const std::uint64_t generation = ++reloadGeneration_;
+        reader_.query<BoardState>(
+            [](sqlite3 *db)
+            {
+                BoardState state;
+                sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+                state.changeSeq = CardDatabase::readChangeSeq(db);
+                state.cards.assign(CardDatabase::readAllCards(db));
+                state.projects = CardDatabase::readAllProjects(db);
+                sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+                return state;
+            },
+            [this, generation](BoardState &state)
+            {
+                if (generation < appliedReloadGeneration_) return;
+                appliedReloadGeneration_ = generation;
+
+                cards_ = std::move(state.cards);
+                projects_ = std::move(state.projects);
+                projects_.push_back(defaultProject_);
+                snapshotDirty_ = true;
+
+                // A refresh may already have applied newer changes than this reload saw
+                const std::int64_t previous = changeCursor_.exchange(state.changeSeq);
+                if (previous > state.changeSeq) requestRefresh();
+                updateCycleTimes();
+            });
     }
-    void Application::loadCards()
+
+    void Application::requestRefresh()
     {
-        cards_.clear();
-        cards_ = db_.getAllCards();
+        // Called from the watcher thread as well; one queued refresh covers every change before it runs
+        if (refreshQueued_.exchange(true)) return;
+
+        reader_.submit([this](sqlite3 *db) -> DatabaseReader::Completion
+        {
+            // Cleared before reading so a commit that lands during the read queues another refresh
+            refreshQueued_ = false;
+            auto delta = std::make_shared<CardDelta>(CardDatabase::readCardChanges(db, changeCursor_));
+            auto projects = std::make_shared<std::vector<proj::Project>>(CardDatabase::readAllProjects(db));
+            return [this, delta, projects]() { applyChanges(*delta, *projects); };
+        }, [this] { refreshQueued_ = false; });
     }
 
-    void Application::loadProjects()
+    void Application::applyChanges(const CardDelta &delta, std::vector<proj::Project> &projects)
     {
-        projects_.clear();
-        projects_ = db_.getAllProjects();
+        if (boardLoading_)
+        {
+            refreshAfterLoad_ = true;
+            return;
+        }
+        if (!delta.complete)
+        {
+            reloadAppState();
+            return;
+        }
+        if (delta.fromSeq != changeCursor_)
+        {
+            // A reload or another refresh moved the cursor while this one was reading
+            if (delta.toSeq > changeCursor_) requestRefresh();
+            return;
+        }
+        changeCursor_ = delta.toSeq;
+
+        projects_ = std::move(projects);
         projects_.push_back(defaultProject_);
+        if (delta.changed.empty() && delta.removed.empty()) return;
+
+        std::unordered_map<int, size_t> indexById;
+        indexById.reserve(cards_.size());
+        for (size_t i = 0; i < cards_.size(); i++) indexById[cards_[i].id] = i;
+
+        for (const auto &card: delta.changed)
+        {
+            const auto found = indexById.find(card.id);
+            if (found != indexById.end()) cards_.set(found->second, card);
+            else cards_.push_back(card);
+        }
+
+        if (!delta.removed.empty())
+        {
+            const std::unordered_set<int> removed(delta.removed.begin(), delta.removed.end());
+            cards_.eraseIf([&](const CompactCard &card) { return removed.contains(card.id); });
+        }
+
+        cards_.sortBySequence();
+        snapshotDirty_ = true;
+
+        // Status changes from other windows and synced devices reach the sketches here
+        updateCycleTimes();
     }
 
-    void Application::run()
+    void Application::saveSnapshotInBackground()
+    {
+        snapshotDirty_ = false;
+        nextSnapshot_ = std::chrono::steady_clock::now() + kSnapshotInterval;
+
+        // Read straight from a worker connection so the snapshot matches the stamp it is written with
+        reader_.submit([path = getSnapshotPath()](sqlite3 *db) -> DatabaseReader::Completion
+        {
+            writeBoardSnapshot(path, currentSnapshotStamp(db), CardDatabase::readAllCards(db),
+                               CardDatabase::readAllProjects(db));
+            return nullptr;
+        });
+    }
+
+    void Application::trimHistoryInBackground()
     {
-        initWindow();
+        // Same cadence as the snapshot; a window further behind on the change log reloads in full.
+        // Deleting thousands of rows is a write of its own, so it gets its own connection.
+        jobs_.submit([]
+        {
+            try
+            {
+                CardDatabase maintenanceDb(getDatabasePath());
+                maintenanceDb.pruneChangeLog(kChangeLogKeep);
+                OperationJournal(maintenanceDb).compact(kJournalKeep);
+            } catch (const std::exception &e)
+            {
+                spdlog::warn("History maintenance skipped: {}", e.what());
+            }
+        });
+    }
+
+    void Application::applyCard(const TodoCard &card)
+    {
+        // Optimistic local update so the board reflects a write before the reload lands
+        snapshotDirty_ = true;
+        for (size_t i = 0; i < cards_.size(); i++)
+        {
+            if (cards_[i].id == card.id)
+            {
+                cards_.set(i, card);
+                return;
+            }
+        }
+    }
+    bool Application::applyEdit(const CardBatch &batch, const std::string &label)
+    {
+        // Behind edits still waiting for the lock, so edits land in the order they were made
+        if (busyEdits_.empty() && journal_.apply(batch, label))
+        {
+            // Cards moved to Done land in the percentiles right away, not after the refresh
+            updateCycleTimes();
+            // Only the rows in the change log are read back, so the render cache keeps every
+            // column the edit did not touch (a full reload would replace the whole store)
+            requestRefresh();
+            return true;
+        }
+        // The UI connection only waits a few ms for the lock (BEGIN IMMEDIATE fails before
+        // anything is written), so another writer's commit is retried rather than reported
+        if (!busyEdits_.empty() || sqlite3_errcode(db_.handle()) == SQLITE_BUSY)
+        {
+            if (busyEdits_.empty())
+            {
+                lastEditProgress_ = std::chrono::steady_clock::now();
+                nextEditRetry_ = lastEditProgress_ + kEditRetryInterval;
+            }
+            busyEdits_.push_back({batch, label});
+            return true;
+        }
+        return false;
+    }
 
-        // Initialize database
-        loadCards();
-        loadProjects();
+    void Application::retryBusyEdits()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (busyEdits_.empty() || now < nextEditRetry_) return;
 
-        // Initialize graphics system
-        graphics_ = std::make_unique<Graphics>(window_);
-        graphics_->initialize();
+        bool applied = false;
+        bool dropped = false;
+        while (!busyEdits_.empty())
+        {
+            const QueuedEdit &edit = busyEdits_.front();
+            if (journal_.apply(edit.batch, edit.label))
+            {
+                busyEdits_.pop_front();
+                lastEditProgress_ = now;
+                applied = true;
+                continue;
+            }
 
-        // Initialize ImGui renderer after graphics
-        imguiRenderer_ = std::make_unique<ImGuiRenderer>(graphics_.get(), this);
-        imguiRenderer_->initialize();
+            if (sqlite3_errcode(db_.handle()) == SQLITE_BUSY)
+            {
+                if (now - lastEditProgress_ < kBusyEditTimeout)
+                {
+                    nextEditRetry_ = now + kEditRetryInterval;
+                    break;
+                }
+                spdlog::error("Dropped {} edits; the database stayed locked for {} s", busyEdits_.size(),
+                              kBusyEditTimeout.count());
+                busyEdits_.clear();
+            } else
+            {
+                spdlog::error("Failed to apply queued edit \"{}\"", edit.label);
+                busyEdits_.pop_front();
+            }
+            dropped = true;
+        }
 
-        // Initialize sound system
-        if (!audio_.initialize())
+        if (applied)
         {
-            spdlog::error("Failed to initialize audio engine!");
-            throw std::runtime_error("Failed to initialize audio engine!");
+            updateCycleTimes();
+            requestRefresh();
         }
+        // A dropped edit was already shown on the board and left no change log entry to
+        // refresh from; the reload puts back what is stored
+        if (dropped) reloadAppState();
+    }
+
+    bool Application::undo()
+    {
+        // The journal does not hold the queued edits yet, so undo would skip past them
+        if (!busyEdits_.empty() || !journal_.undo()) return false;
+        requestRefresh();
+        return true;
+    }
+
+    bool Application::redo()
+    {
+        if (!busyEdits_.empty() || !journal_.redo()) return false;
+        requestRefresh();
+        return true;
+    }
+
+    void Application::rebuildCycleTimes()
+    {
+        if (sketches_.isRebuilding()) return;
+        sketches_.setRebuilding(true);
+
+        const unsigned threads = std::max(1u, std::thread::hardware_concurrency() / 2);
+        reader_.query<CycleTimeSketches::Built>(
+            [threads](sqlite3 *db)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                auto built = CycleTimeSketches::build(db, threads);
+                spdlog::info("Rebuilt {} cycle-time sketches on {} threads in {:.1f} ms", built.sketches.size(),
+                             threads, std::chrono::duration<double, std::milli>(
+                                 std::chrono::steady_clock::now() - start).count());
+                return built;
+            },
+            [this](CycleTimeSketches::Built &built)
+            {
+                sketches_.replace(std::move(built));
+                updateCycleTimes();
+            },
+            [this] { sketches_.setRebuilding(false); });
+    }
+
+    void Application::updateCycleTimes()
+    {
+        if (!sketches_.update() && sketches_.needsRebuild()) rebuildCycleTimes();
+    }
+
+    bool Application::restoreLatestBackup()
+    {
+        // User-initiated and blocking anyway, so it may wait out other writers like the CLI does
+        db_.setBusyBudget(CardDatabase::kBusyMaxTotalMs);
+        const bool restored = backup_.restoreLatest();
+        db_.setBusyBudget(CardDatabase::kInteractiveBusyMaxTotalMs);
+        if (!restored) return false;
+        // An older main may still hold cards archived since, and its id counters predate them
+        if (sync_) sync_->pauseRecording();
+        const bool reconciled = archiver_.reconcileRestored();
+        if (sync_) sync_->resumeRecording();
+        if (!reconciled) spdlog::warn("Restored backup is out of step with the card archive");
+        reloadAppState();
+        return true;
+    }
+
+    bool Application::restoreArchivedCard(int cardId)
+    {
+        if (!archiver_.restoreCard(cardId)) return false;
+        reloadAppState();
+        return true;
+    }
+
+    bool Application::startImport(const std::string &path)
+    {
+        const auto format = transferFormatForPath(path);
+        if (!format || importing_) return false;
+
+        importing_ = true;
+        importDone_ = 0;
+        importTotal_ = 0;
+        cancelImport_ = false;
+        jobs_.run<bool>(
+            [this, path, format = *format, syncFolder = sync_ ? sync_->folder() : std::string()]
+            {
+                try
+                {
+                    // A writer connection of its own keeps the UI thread's connection free between chunks
+                    CardDatabase importDb(getDatabasePath());
+
+                    // Sessions only see their own connection, so the import records its own changeset
+                    std::optional<BoardSync> importSync;
+                    if (!syncFolder.empty()) importSync.emplace(importDb, syncFolder);
+
+                    const bool imported = importBoard(importDb, path, format, nullptr,
+                                                      [this](const std::uint64_t done, const std::uint64_t total)
+                                                      {
+                                                          importDone_ = done;
+                                                          importTotal_ = total;
+                                                          return !cancelImport_.load();
+                                                      });
+                    if (importSync) importSync->exportChanges();
+                    return imported;
+                } catch (const std::exception &e)
+                {
+                    spdlog::error("Import failed: {}", e.what());
+                    return false;
+                }
+            },
+            [this](bool &) { finishImport(); },
+            [this] { finishImport(); });
+        return true;
+    }
+
+    void Application::finishImport()
+    {
+        // Pick up the imported cards, also after a failure: chunks already written stay
+        importing_ = false;
+        reloadAppState();
+    }
+
+    bool Application::startExport(const std::string &path)
+    {
+        const auto format = transferFormatForPath(path);
+        if (!format) return false;
+
+        reader_.submit([path, format = *format](sqlite3 *db) -> DatabaseReader::Completion
+        {
+            exportBoard(db, path, format);
+            return nullptr;
+        });
+        return true;
+    }
+
+    bool Application::syncNow()
+    {
+        nextSync_ = std::chrono::steady_clock::now() + kSyncInterval;
+        if (!sync_ || syncInFlight_) return false;
+
+        // Only taking the session's edits touches the UI connection. The folder, the files and
+        // the write transaction that applies other devices' changes are the job's.
+        auto changeset = std::make_shared<std::vector<char>>(sync_->takeChanges());
+        syncInFlight_ = changeset;
+        jobs_.run<bool>(
+            [changeset, folder = sync_->folder()]
+            {
+                try
+                {
+                    CardDatabase syncDb(getDatabasePath());
+                    BoardSync sync(syncDb, folder);
+                    if (sync.writeChanges(*changeset)) changeset->clear();
+                    return sync.importChanges() >= 0;
+                } catch (const std::exception &e)
+                {
+                    spdlog::error("Sync failed: {}", e.what());
+                    return false;
+                }
+            },
+            [this, changeset](bool &) { finishSync(*changeset); },
+            [this, changeset] { finishSync(*changeset); });
+        return true;
+    }
+
+    void Application::finishSync(std::vector<char> &unsent)
+    {
+        syncInFlight_.reset();
+        // Sent with the next sync instead
+        if (!unsent.empty()) sync_->returnChanges(std::move(unsent));
+
+        // Applied rows reach the board through the change log like any other write
+        requestRefresh();
+    }
+
+    float Application::importProgress() const
+    {
+        const std::uint64_t total = importTotal_;
+        return total ? static_cast<float>(static_cast<double>(importDone_) / static_cast<double>(total)) : 0.0f;
+    }
+
+    void Application::run()
+    {
+        setTraceThreadName("main");
+        TRACE_SCOPE("Application::run");
+        launchTime_ = std::chrono::steady_clock::now();
+
+        // Streams in while the window and Vulkan come up; chunks are applied from the main loop
+        projects_ = {defaultProject_};
+        loadBoardInBackground();
+
+        // Only what the first frame needs runs here, each part as soon as what it needs is ready.
+        // Sounds and fonts are loaded after the first frame (onFirstFrame).
+        using Affinity = StartupGraph::Affinity;
+        StartupGraph startup(jobs_);
+        graphics_ = std::make_unique<Graphics>();
+
+        const auto glfw = startup.add("glfw", Affinity::Main, [] { glfwInit(); });
+        const auto window = startup.add("window", Affinity::Main, [this]
+        {
+            initWindow();
+            graphics_->setWindow(window_);
+        }, {glfw});
+        const auto instance = startup.add("vk-instance", Affinity::Worker,
+                                          [this] { graphics_->initializeInstance(); }, {glfw});
+        const auto surface = startup.add("vk-surface", Affinity::Main,
+                                         [this] { graphics_->initializeSurface(); }, {window, instance});
+        const auto device = startup.add("vk-device", Affinity::Worker,
+                                        [this] { graphics_->initializeDevice(); }, {surface});
+        const auto shaders = startup.add("shaders", Affinity::Worker, [this] { graphics_->loadShaders(); });
+        const auto swapChain = startup.add("swapchain", Affinity::Main,
+                                           [this] { graphics_->initializeSwapChain(); }, {device, shaders});
+        startup.add("imgui", Affinity::Main, [this]
+        {
+            imguiRenderer_ = std::make_unique<ImGuiRenderer>(graphics_.get(), this);
+            imguiRenderer_->initialize();
+        }, {swapChain});
 
-        if (!audio_.loadSound("timer_finished", getResourcesPath() + "sounds/ringtone_fixed.wav"))
         {
-            spdlog::error("Failed to load sound!");
+            TRACE_SCOPE("Application::startup");
+            startup.run();
         }
+        startup.logTimeline();
 
         mainLoop();
 
         shutdown();
     }
 
-    void Application::initWindow()
+    void Application::loadBoardInBackground()
     {
-        glfwWindowHint(GLFW_SCALE_TO_MONITOR, GLFW_FALSE);
+        boardLoading_ = true;
+        const std::uint64_t generation = ++reloadGeneration_;
+        reader_.submit([this, generation](sqlite3 *db) -> DatabaseReader::Completion
+        {
+            TRACE_SCOPE("Application::loadBoard");
+            auto snapshot = std::make_shared<BoardState>();
+            if (loadBoardSnapshot(getSnapshotPath(), currentSnapshotStamp(db), snapshot->cards, snapshot->projects))
+            {
+                return [this, generation, snapshot]
+                {
+                    if (generation >= appliedReloadGeneration_)
+                    {
+                        appliedReloadGeneration_ = generation;
+                        projects_ = std::move(snapshot->projects);
+                        projects_.push_back(defaultProject_);
+                        cards_ = std::move(snapshot->cards);
+                    }
+                    finishBoardLoad(generation, true);
+                };
+            }
+
+            // One read transaction, so the chunks and the change cursor describe the same board
+            sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+            const std::int64_t changeSeq = CardDatabase::readChangeSeq(db);
+            auto projects = std::make_shared<std::vector<proj::Project>>(CardDatabase::readAllProjects(db));
+            jobs_.post([this, generation, changeSeq, projects]
+            {
+                if (generation < appliedReloadGeneration_) return;
+                projects_ = std::move(*projects);
+                projects_.push_back(defaultProject_);
+                changeCursor_ = changeSeq;
+            });
+            CardDatabase::readAllCards(db, kLoadChunk, [this, generation](std::vector<TodoCard> &&chunk)
+            {
+                auto cards = std::make_shared<std::vector<TodoCard>>(std::move(chunk));
+                jobs_.post([this, generation, cards] { appendLoadedCards(generation, *cards); });
+            });
+            sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+
+            // Posted after the last chunk by the reader
+            return [this, generation] { finishBoardLoad(generation, false); };
+        }, [this]
+        {
+            // Whatever chunks arrived stay on screen until the next reload
+            spdlog::error("Board failed to load");
+            boardLoading_ = false;
+        });
+    }
+
+    void Application::appendLoadedCards(const std::uint64_t generation, std::vector<TodoCard> &cards)
+    {
+        // A reload requested since then read the complete board
+        if (generation < appliedReloadGeneration_) return;
+        appliedReloadGeneration_ = generation;
+
+        // Chunks arrive in sequence order and refreshes wait for the load, so appending keeps cards_ sorted
+        cards_.append(cards);
+    }
+
+    void Application::finishBoardLoad(const std::uint64_t generation, const bool fromSnapshot)
+    {
+        boardLoading_ = false;
+        spdlog::info("Interactive after {:.1f} ms: {} cards{}",
+                     std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - launchTime_).count(),
+                     cards_.size(), fromSnapshot ? " from snapshot" : "");
+
+        nextSnapshot_ = std::chrono::steady_clock::now() + kSnapshotInterval;
+        if (fromSnapshot)
+        {
+            // Snapshots only have to be compatible, not current. The reload also covers any
+            // refresh that was held back.
+            refreshAfterLoad_ = false;
+            reloadAppState();
+        } else if (generation >= appliedReloadGeneration_)
+        {
+            snapshotDirty_ = true;
+        }
+        if (refreshAfterLoad_)
+        {
+            refreshAfterLoad_ = false;
+            requestRefresh();
+        }
+        updateCycleTimes();
+    }
 
-        glfwInit();
+    void Application::onFirstFrame()
+    {
+        spdlog::info("First frame after {:.1f} ms",
+                     std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - launchTime_).count());
+
+        if (!audio_.initialize())
+        {
+            spdlog::error("Failed to initialize audio engine!");
+            throw std::runtime_error("Failed to initialize audio engine!");
+        }
+        audio_.loadSoundAsync(jobs_, "timer_finished", getResourcesPath() + "sounds/ringtone_fixed.wav");
+        imguiRenderer_->loadFontAsync(jobs_, getResourcesPath() + "fonts/Inter/Inter-VariableFont_opsz,wght.ttf");
+    }
 
+    void Application::initWindow()
+    {
+        glfwWindowHint(GLFW_SCALE_TO_MONITOR, GLFW_FALSE);
         glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
         glfwWindowHint(GLFW_TRANSPARENT_FRAMEBUFFER, GLFW_TRUE); // Enable transparent framebuffer
         // glfwWindowHint(GLFW_DECORATED, GLFW_FALSE); // Remove window decorations (border, title bar, etc.)
@@ -117,36 +610,110 @@ namespace todo {
 
     void Application::mainLoop()
     {
+        using Phase = FlightRecorder::Phase;
         while (!glfwWindowShouldClose(window_))
         {
-            glfwPollEvents();
+            recorder_.beginFrame();
+            {
+                Phase phase(recorder_, "poll events");
+                glfwPollEvents();
+            }
 
-            // Update audio engine to maintain active sounds
-            audio_.update();
+            {
+                // Apply results of jobs and queries that finished off the frame
+                Phase phase(recorder_, "completions");
+                jobs_.drainCompletions();
+            }
+
+            {
+                Phase phase(recorder_, "maintenance");
+
+                retryBusyEdits();
+
+                // Advance any scheduled backup by a small slice of the frame
+                backup_.update(std::chrono::milliseconds(2));
+
+                // Move cold cards out of the hot table, at most one small batch per frame. The
+                // moves stay local; other devices archive by their own policy.
+                // Pausing restarts the sync session, so only when a batch is due
+                if (archiver_.isDue())
+                {
+                    if (sync_) sync_->pauseRecording();
+                    archivedSinceReload_ += std::max(0, archiver_.update());
+                    if (sync_) sync_->resumeRecording();
+                }
+                if (archivedSinceReload_ > 0 && !archiver_.isDraining())
+                {
+                    archivedSinceReload_ = 0;
+                    reloadAppState();
+                }
+
+                if (snapshotDirty_ && std::chrono::steady_clock::now() >= nextSnapshot_)
+                {
+                    saveSnapshotInBackground();
+                    trimHistoryInBackground();
+                }
+
+                if (sync_ && std::chrono::steady_clock::now() >= nextSync_)
+                {
+                    syncNow();
+                }
+
+                // Update audio engine to maintain active sounds
+                audio_.update();
+            }
 
             if (framebufferResized_) {
+                Phase phase(recorder_, "recreate swapchain");
                 framebufferResized_ = false;
                 graphics_->recreateSwapChain();
             }
 
-            // Begin graphics frame
-            graphics_->beginFrame();
+            {
+                // Begin graphics frame
+                Phase phase(recorder_, "acquire");
+                graphics_->beginFrame();
+            }
+
+            {
+                Phase phase(recorder_, "build UI");
 
-            // Begin ImGui frame
-            imguiRenderer_->beginFrame();
+                // Begin ImGui frame
+                imguiRenderer_->beginFrame();
 
-            // Your ImGui UI code here
-            renderUI();
+                // Your ImGui UI code here
+                renderUI();
 
-            // End ImGui frame
-            imguiRenderer_->endFrame();
+                // End ImGui frame
+                imguiRenderer_->endFrame();
+            }
+
+            {
+                // Render ImGui to command buffer
+                Phase phase(recorder_, "record");
+                VkCommandBuffer cmdBuffer = graphics_->getCurrentCommandBuffer();
+                imguiRenderer_->render(cmdBuffer);
+            }
+
+            {
+                // End graphics frame and present
+                Phase phase(recorder_, "present");
+                graphics_->endFrame();
+            }
+            recorder_.endFrame(jobs_);
 
-            // Render ImGui to command buffer
-            VkCommandBuffer cmdBuffer = graphics_->getCurrentCommandBuffer();
-            imguiRenderer_->render(cmdBuffer);
+            framesDrawn_++;
+            if (!boardLoading_ && ++framesSinceLoad_ > kSettleFrames)
+            {
+                steadyState_.add(recorder_.lastFrame().allocations);
+            }
+            if (frameLimit_ > 0 && framesDrawn_ >= frameLimit_) glfwSetWindowShouldClose(window_, GLFW_TRUE);
 
-            // End graphics frame and present
-            graphics_->endFrame();
+            if (firstFrame_)
+            {
+                firstFrame_ = false;
+                onFirstFrame();
+            }
         }
         vkDeviceWaitIdle(graphics_->getDevice());
     }
@@ -154,6 +721,7 @@ namespace todo {
 
     void Application::shutdown()
     {
+        TRACE_SCOPE("Application::shutdown");
         if (graphics_)
         {
             if (graphics_->getDevice())
@@ -165,6 +733,42 @@ namespace todo {
         graphics_.reset(); // This will call Graphics destructor
 
         audio_.shutdown();
+
+        // Jobs still running (an import, maintenance) finish before the connections close
+        cancelImport_ = true;
+        jobs_.waitIdle();
+
+        // Nothing else draws now, so edits still waiting for the lock get the long wait
+        if (!busyEdits_.empty())
+        {
+            db_.setBusyBudget(CardDatabase::kBusyMaxTotalMs);
+            nextEditRetry_ = {};
+            lastEditProgress_ = std::chrono::steady_clock::now();
+            retryBusyEdits();
+        }
+
+        // Edits since the last sync would otherwise be lost with the session, along with any the
+        // last sync job failed to write
+        if (sync_)
+        {
+            if (syncInFlight_ && !syncInFlight_->empty()) sync_->returnChanges(std::move(*syncInFlight_));
+            sync_->exportChanges();
+        }
+
+        // The next launch starts from what is on screen now; the reconcile catches anything newer.
+        // A board still loading is partial, and a clean one is already on disk, so either way the
+        // previous file stays.
+        if (!boardLoading_ && snapshotDirty_)
+        {
+            std::vector<proj::Project> projects;
+            std::ranges::copy_if(projects_, std::back_inserter(projects),
+                                 [this](const proj::Project &project) { return project.id != defaultProject_.id; });
+            writeBoardSnapshot(getSnapshotPath(), currentSnapshotStamp(db_.handle()), cards_.unpackAll(), projects);
+        }
+
+        profiler_.sampleCacheStats(db_.handle());
+        profiler_.logSummary();
+
         if (window_)
         {
             glfwDestroyWindow(window_);
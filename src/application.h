@@ -3,6 +3,9 @@
 //
 
 #pragma once
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <optional>
 #include <stdexcept>
 #include <vector>
@@ -11,10 +14,25 @@
 #include <GLFW/glfw3.h>
 
 #include "audio_engine.h"
+#include "board_queries.h"
+#include "board_snapshot.h"
+#include "board_sync.h"
+#include "board_transfer.h"
+#include "card_archiver.h"
 #include "card_database.h"
+#include "card_search.h"
+#include "card_store.h"
+#include "cycle_time_sketches.h"
+#include "database_backup.h"
+#include "database_profiler.h"
+#include "database_reader.h"
+#include "database_watcher.h"
+#include "flight_recorder.h"
 #include "glm/vec2.hpp"
 #include "graphics.h"
 #include "imgui_renderer.h"
+#include "job_system.h"
+#include "operation_journal.h"
 #include "spdlog/spdlog.h"
 #include "utilities.h"  // Add this include
 
@@ -30,8 +48,34 @@ namespace todo {
     {
     public:
         Application()
-            : db_(getDatabasePath()) // <--- initialize here, or in constructor body
+            : recorder_(getAppDataPath())
+            , db_(getDatabasePath()) // <--- initialize here, or in constructor body
+            , journal_(db_)
+            , sketches_(db_.handle())
+            , archiver_(db_, getArchivePath())
+            , reader_(jobs_, getDatabasePath(), &profiler_, {{CardArchiver::kSchema, getArchivePath()}})
+            , watcher_(getDatabasePath(), [this] { requestRefresh(); })
+            , queries_(reader_)
+            , search_(reader_)
+            , backup_(db_.handle(), getAppDataPath() + "/backups")
         {
+            profiler_.attach(db_.handle(), "writer");
+            profiler_.setFlightRecorder(&recorder_);
+
+            // Rejoin the sync folder set up with `sync <folder>`
+            if (const std::string folder = BoardSync::configuredFolder(db_); !folder.empty())
+            {
+                try
+                {
+                    sync_ = std::make_unique<BoardSync>(db_, folder);
+                } catch (const std::exception &e)
+                {
+                    spdlog::warn("Sync disabled: {}", e.what());
+                }
+            }
+
+            // Opened with the long budget so startup migrations wait for other writers; frames don't
+            db_.setBusyBudget(CardDatabase::kInteractiveBusyMaxTotalMs);
         }
 
         void run();
@@ -40,34 +84,165 @@ namespace todo {
         void shutdown();
 
         void reloadAppState();
-        void loadCards();
-        void loadProjects();
+
+        // Live reload: the watcher sees commits from any window, script or thread, and only the
+        // cards listed in card_changes past changeCursor_ are read back
+        void requestRefresh();
+        void applyChanges(const CardDelta &delta, std::vector<proj::Project> &projects);
+        // Progressive startup: the board streams in from a read worker in kLoadChunk-card chunks
+        // that are appended as they land, so the first frame does not wait for it. A compatible
+        // snapshot is used instead when there is one, and reconciled by a reload.
+        void loadBoardInBackground();
+        [[nodiscard]] bool isBoardLoading() const { return boardLoading_; }
+        void saveSnapshotInBackground();
+        void trimHistoryInBackground();
+        void applyCard(const TodoCard &card);
+
+        // Board edits the user can undo: applied and journaled in one transaction, then picked up
+        // through the change log like any other commit (requestRefresh).
+        // An edit that finds the write lock taken is queued and retried from later frames, so it
+        // still counts as applied; the board is reloaded if it is dropped in the end.
+        bool applyEdit(const CardBatch &batch, const std::string &label);
+        bool undo();
+        bool redo();
+
+        // Rebuilds the cycle-time sketches from the whole card history, reading it in parallel on
+        // a worker; they keep updating incrementally from card_events otherwise
+        void rebuildCycleTimes();
+        // Folds in new card_events, or hands a large backlog to rebuildCycleTimes()
+        void updateCycleTimes();
+        bool restoreLatestBackup();
+        bool restoreArchivedCard(int cardId);
+
+        // Board import/export (board_transfer.h). Imports run as a job on their own writer
+        // connection; exports run on a read worker. The board reloads when an import finishes.
+        bool startImport(const std::string &path);
+        bool startExport(const std::string &path);
+        [[nodiscard]] bool isImporting() const { return importing_; }
+        [[nodiscard]] float importProgress() const;
+
+        // Exchanges changesets with the other devices in the sync folder (board_sync.h) on a job
+        // with its own connection. Also runs every kSyncInterval, and the export at shutdown.
+        // Returns false if sync is off or a sync is already running.
+        bool syncNow();
+        [[nodiscard]] bool isSyncEnabled() const { return sync_ != nullptr; }
+
+        // Per-frame allocations once the board has loaded and kSettleFrames more have gone by,
+        // when nothing in a frame should need the heap. `alloc-check` quits after limitFrames()
+        // frames and compares the tally against its limit.
+        void limitFrames(int frames) { frameLimit_ = frames; }
+        [[nodiscard]] const AllocationTally &steadyStateAllocations() const { return steadyState_; }
 
         // Getters for other classes to access what they need
         [[nodiscard]] GLFWwindow *getWindow() const { return window_; }
         [[nodiscard]] Graphics *getGraphics() const { return graphics_.get(); }
 
         CardDatabase &db() { return db_; }
+        OperationJournal &journal() { return journal_; }
+        [[nodiscard]] const CycleTimeSketches &cycleTimes() const { return sketches_; }
+        DatabaseReader &reader() { return reader_; }
+        BoardQueries &queries() { return queries_; }
+        JobSystem &jobs() { return jobs_; }
         AudioEngine &audio() { return audio_; }
+        CardSearch &search() { return search_; }
+        DatabaseBackup &backup() { return backup_; }
+        DatabaseProfiler &profiler() { return profiler_; }
+        FlightRecorder &recorder() { return recorder_; }
 
         bool framebufferResized_ = true;
 
         // Getters
         void getWindowSize(glm::ivec2 &size) const;
-        [[nodiscard]] const std::vector<TodoCard> &getCards() const { return cards_; }
+        [[nodiscard]] const CardStore &getCards() const { return cards_; }
         [[nodiscard]] const std::vector<proj::Project> &getProjects() const { return projects_; }
 
     private:
+        // Declared first so they outlive every connection they are attached to
+        DatabaseProfiler profiler_;
+        FlightRecorder recorder_;
         CardDatabase db_;
+        OperationJournal journal_;
+        CycleTimeSketches sketches_;
+        CardArchiver archiver_;
+
+        // Shared with the reader, watcher and job threads, so declared to outlive all of them
+        std::atomic<bool> refreshQueued_ = false;
+        std::atomic<std::int64_t> changeCursor_ = 0;
+        std::atomic<std::uint64_t> importDone_ = 0;
+        std::atomic<std::uint64_t> importTotal_ = 0;
+        std::atomic<bool> cancelImport_ = false;
+
+        // Before the reader, which posts its completions here
+        JobSystem jobs_;
+        DatabaseReader reader_;
+        DatabaseWatcher watcher_;
+
+        BoardQueries queries_;
+        CardSearch search_;
+        DatabaseBackup backup_;
         AudioEngine audio_;
 
         GLFWwindow *window_ = VK_NULL_HANDLE;
 
-        std::vector<TodoCard> cards_{};
+        CardStore cards_{};
         std::vector<proj::Project> projects_{};
 
         proj::Project defaultProject_;
 
+        // Bumped per reload request so a slow, older reload never overwrites a newer one
+        std::uint64_t reloadGeneration_ = 0;
+        std::uint64_t appliedReloadGeneration_ = 0;
+
+        // The startup snapshot is refreshed from a read worker while the board keeps changing
+        static constexpr std::chrono::minutes kSnapshotInterval{5};
+        bool snapshotDirty_ = false;
+        std::chrono::steady_clock::time_point nextSnapshot_{};
+        static constexpr int kChangeLogKeep = 10000;
+        static constexpr int kJournalKeep = 200;
+
+        // Startup timings are measured from launchTime_; refreshes that arrive while the board
+        // is still streaming in are applied once it is complete
+        static constexpr std::size_t kLoadChunk = 2000;
+        std::chrono::steady_clock::time_point launchTime_{};
+        bool boardLoading_ = true;
+        bool refreshAfterLoad_ = false;
+        bool firstFrame_ = true;
+
+        static constexpr int kSettleFrames = 120;
+        int frameLimit_ = 0; // 0 = run until the window closes
+        int framesDrawn_ = 0;
+        int framesSinceLoad_ = 0;
+        AllocationTally steadyState_;
+
+        // Cards archived since the last reload; the board is refreshed once a drain finishes
+        int archivedSinceReload_ = 0;
+
+        // Edits that found the write lock taken, retried in order every kEditRetryInterval until
+        // the lock has not moved for kBusyEditTimeout
+        struct QueuedEdit
+        {
+            CardBatch batch;
+            std::string label;
+        };
+        std::deque<QueuedEdit> busyEdits_;
+        std::chrono::steady_clock::time_point lastEditProgress_{};
+        std::chrono::steady_clock::time_point nextEditRetry_{};
+        static constexpr std::chrono::milliseconds kEditRetryInterval{100};
+        static constexpr std::chrono::seconds kBusyEditTimeout{10};
+        void retryBusyEdits();
+
+        bool importing_ = false;
+
+        std::unique_ptr<BoardSync> sync_;
+        static constexpr std::chrono::seconds kSyncInterval{30};
+        std::chrono::steady_clock::time_point nextSync_{};
+        // Edits handed to the running sync job; what it failed to write is left in it
+        std::shared_ptr<std::vector<char>> syncInFlight_;
+
+        // Job continuations, run whether the job returned or threw
+        void finishImport();
+        void finishSync(std::vector<char> &unsent);
+
         std::unique_ptr<Graphics> graphics_;
         std::unique_ptr<ImGuiRenderer> imguiRenderer_;
 
@@ -81,5 +256,9 @@ namespace todo {
 
 
         void renderUI();
+        void appendLoadedCards(std::uint64_t generation, std::vector<TodoCard> &cards);
+        void finishBoardLoad(std::uint64_t generation, bool fromSnapshot);
+        // Sounds and the UI font are only requested once the first frame is on screen
+        void onFirstFrame();
     };
 }
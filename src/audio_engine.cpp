@@ -1,8 +1,11 @@
 #include "audio_engine.h"
 #include <iostream>
 #include <algorithm>
+#include <optional>
 
+#include "job_system.h"
 #include "spdlog/spdlog.h"
+#include "trace.h"
 
 AudioEngine::AudioEngine() : masterVolume_(100.0f), muted_(false) {
 }
@@ -25,6 +28,7 @@ void AudioEngine::shutdown() {
 }
 
 bool AudioEngine::loadSound(const std::string& name, const std::string& filepath) {
+    TRACE_SCOPE("AudioEngine::loadSound");
     // Check if already loaded
     if (soundBuffers_.find(name) != soundBuffers_.end()) {
        spdlog::info("Sound {} already loaded", name);
@@ -42,6 +46,29 @@ bool AudioEngine::loadSound(const std::string& name, const std::string& filepath
     return true;
 }
 
+void AudioEngine::loadSoundAsync(todo::JobSystem& jobs, const std::string& name, const std::string& filepath) {
+    if (soundBuffers_.find(name) != soundBuffers_.end()) {
+        return;
+    }
+
+    // Only the decode runs off the main thread; the buffer map is main-thread state
+    jobs.run<std::optional<sf::SoundBuffer>>(
+        [filepath]() -> std::optional<sf::SoundBuffer> {
+            TRACE_SCOPE("AudioEngine::decodeSound");
+            sf::SoundBuffer buffer;
+            if (!buffer.loadFromFile(filepath)) {
+                spdlog::error("Failed to load sound: {}", filepath);
+                return std::nullopt;
+            }
+            return buffer;
+        },
+        [this, name](std::optional<sf::SoundBuffer>& buffer) {
+            if (buffer && soundBuffers_.find(name) == soundBuffers_.end()) {
+                soundBuffers_[name] = std::move(*buffer);
+            }
+        });
+}
+
 void AudioEngine::unloadSound(const std::string& name) {
     auto it = soundBuffers_.find(name);
     if (it != soundBuffers_.end()) {
@@ -6,6 +6,10 @@
 #include <string>
 #include <utility>
 
+namespace todo {
+    class JobSystem;
+}
+
 class AudioEngine {
 private:
     std::unordered_map<std::string, sf::SoundBuffer> soundBuffers_;
@@ -24,6 +28,8 @@ public:
 
     // Resource management
     bool loadSound(const std::string& name, const std::string& filepath);
+    // Decodes on a job worker; the sound becomes playable once the main loop drains completions
+    void loadSoundAsync(todo::JobSystem& jobs, const std::string& name, const std::string& filepath);
     void unloadSound(const std::string& name);
     void preloadSounds(const std::vector<std::pair<std::string, std::string>>& sounds);
 
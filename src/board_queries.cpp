@@ -0,0 +1,41 @@
+#include "board_queries.h"
+
+#include "card_database.h"
+
+namespace todo {
+    ReadAwaitable<std::vector<TodoCard>> BoardQueries::cards(const int projectId)
+    {
+        return reader_.read<std::vector<TodoCard>>([projectId](sqlite3 *db)
+        {
+            return projectId == kAllCards
+                       ? CardDatabase::readAllCards(db)
+                       : CardDatabase::readProjectCards(db, projectId);
+        });
+    }
+
+    ReadAwaitable<std::vector<proj::Project>> BoardQueries::projects()
+    {
+        return reader_.read<std::vector<proj::Project>>(&CardDatabase::readAllProjects);
+    }
+
+    ReadAwaitable<std::vector<CardSearchResult>> BoardQueries::search(std::string query, const int limit)
+    {
+        return reader_.read<std::vector<CardSearchResult>>([query = std::move(query), limit](sqlite3 *db)
+        {
+            return searchCards(db, query, limit);
+        });
+    }
+
+    ReadAwaitable<StatsSummary> BoardQueries::stats(const int days, const int projectId)
+    {
+        return reader_.read<StatsSummary>([days, projectId](sqlite3 *db)
+        {
+            return summarizeDailyStats(CardDatabase::readDailyStats(db, days, projectId), days);
+        });
+    }
+
+    ReadAwaitable<DeliveryForecast> BoardQueries::forecast(const int projectId)
+    {
+        return reader_.read<DeliveryForecast>([projectId](sqlite3 *db) { return forecastDelivery(db, projectId); });
+    }
+}
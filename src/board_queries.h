@@ -0,0 +1,37 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "board_stats.h"
+#include "card_search.h"
+#include "database_reader.h"
+#include "delivery_forecast.h"
+#include "project.h"
+#include "todo_card.h"
+
+namespace todo {
+    // The board's read queries as awaitables for UI coroutines (ui_task.h). Each one runs on a
+    // DatabaseReader worker and resumes the awaiting coroutine on the UI thread:
+    //
+    //     auto cards = co_await app_->queries().cards(projectId);
+    class BoardQueries
+    {
+    public:
+        explicit BoardQueries(DatabaseReader &reader) : reader_(reader)
+        {
+        }
+
+        // kAllCards for every project
+        static constexpr int kAllCards = -1;
+        ReadAwaitable<std::vector<TodoCard>> cards(int projectId = kAllCards);
+        ReadAwaitable<std::vector<proj::Project>> projects();
+        ReadAwaitable<std::vector<CardSearchResult>> search(std::string query, int limit = 25);
+
+        // Summary of the last `days` days of rollups; projectId < 0 for the whole board
+        ReadAwaitable<StatsSummary> stats(int days, int projectId);
+        ReadAwaitable<DeliveryForecast> forecast(int projectId);
+
+    private:
+        DatabaseReader &reader_;
+    };
+}
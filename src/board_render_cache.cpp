@@ -0,0 +1,108 @@
+#include "board_render_cache.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace todo {
+    const ColumnRenderCache &BoardRenderCache::column(const CardStore &store, const int projectId,
+                                                      const CardStatus status, const float wrapWidth)
+    {
+        ProjectColumns &columns = projects_[projectId];
+        rebuild(store, projectId, columns);
+
+        ColumnRenderCache &column = columns[statusToInt(status)];
+        if (!column.laidOut_ || column.wrapWidth_ != wrapWidth || column.font_ != ImGui::GetFont() ||
+            column.fontSize_ != ImGui::GetFontSize())
+        {
+            layOut(store, column, wrapWidth);
+        }
+        return column;
+    }
+
+    const ColumnRenderCache *BoardRenderCache::drawn(const int projectId, const CardStatus status) const
+    {
+        const auto it = projects_.find(projectId);
+        return it == projects_.end() ? nullptr : &it->second[statusToInt(status)];
+    }
+
+    void BoardRenderCache::rebuild(const CardStore &store, const int projectId, ProjectColumns &columns)
+    {
+        // Every stale column of the project is gathered in the same pass over the store
+        bool stale[3];
+        bool anyStale = false;
+        for (int s = 0; s < 3; s++)
+        {
+            stale[s] = columns[s].revision_ != store.columnRevision(projectId, intToStatus(s));
+            anyStale |= stale[s];
+        }
+        if (!anyStale) return;
+
+        std::vector<const CompactCard *> members[3];
+        for (const CompactCard &card: store)
+        {
+            if (card.projectId == projectId && card.status < 3 && stale[card.status]) members[card.status].push_back(&card);
+        }
+
+        for (int s = 0; s < 3; s++)
+        {
+            if (!stale[s]) continue;
+
+            auto &cards = members[s];
+            std::ranges::stable_sort(cards, {}, &CompactCard::sequence);
+
+            ColumnRenderCache &column = columns[s];
+            column.status = intToStatus(s);
+            column.ids.clear();
+            column.titles.clear();
+            column.colors.clear();
+            column.completedAt.clear();
+            for (const CompactCard *card: cards)
+            {
+                column.ids.push_back(card->id);
+                column.titles.push_back(card->title);
+                column.colors.push_back(card->color);
+                column.completedAt.push_back(card->completedAt);
+            }
+            column.revision_ = store.columnRevision(projectId, column.status);
+            column.laidOut_ = false;
+        }
+    }
+
+    void BoardRenderCache::layOut(const CardStore &store, ColumnRenderCache &column, const float wrapWidth)
+    {
+        ImFont *font = ImGui::GetFont();
+        const float fontSize = ImGui::GetFontSize();
+
+        column.layouts.resize(column.size());
+        for (std::size_t i = 0; i < column.size(); i++)
+        {
+            // Same breaks as AddText's word wrap, without going back over the whole title each frame
+            const std::string_view title = store.text(column.titles[i]);
+            const char *begin = title.data();
+            const char *end = begin + title.size();
+            const char *s = begin;
+
+            ColumnRenderCache::TitleLayout &layout = column.layouts[i];
+            layout.lines = 0;
+            while (s < end && layout.lines < ColumnRenderCache::kTitleLines)
+            {
+                const char *eol = font->CalcWordWrapPosition(fontSize, s, end, wrapWidth);
+                if (eol <= s) eol = s + 1;
+                if (const void *newline = std::memchr(s, '\n', eol - s)) eol = static_cast<const char *>(newline);
+
+                layout.begin[layout.lines] = static_cast<std::uint16_t>(std::min<std::ptrdiff_t>(s - begin, UINT16_MAX));
+                layout.end[layout.lines] = static_cast<std::uint16_t>(std::min<std::ptrdiff_t>(eol - begin, UINT16_MAX));
+                layout.lines++;
+
+                s = eol;
+                while (s < end && (*s == ' ' || *s == '\t')) s++;
+                if (s < end && *s == '\n') s++;
+            }
+        }
+
+        column.laidOut_ = true;
+        column.wrapWidth_ = wrapWidth;
+        column.font_ = font;
+        column.fontSize_ = fontSize;
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "card_store.h"
+#include "imgui.h"
+
+namespace todo {
+    // What drawing one board column needs, one array per field in display order. The per-frame
+    // loop reads a few small contiguous arrays instead of striding through whole cards, and the
+    // title wrapping is worked out once rather than by AddText every frame.
+    struct ColumnRenderCache
+    {
+        // Cards are a fixed height, so titles are cut to what fits above the status line
+        static constexpr int kTitleLines = 3;
+
+        // Byte ranges of the title's wrapped lines
+        struct TitleLayout
+        {
+            std::uint16_t begin[kTitleLines];
+            std::uint16_t end[kTitleLines];
+            std::uint8_t lines;
+        };
+
+        CardStatus status = CardStatus::Todo;
+        std::vector<std::int32_t> ids;
+        std::vector<StringArena::Ref> titles;
+        std::vector<TitleLayout> layouts;
+        std::vector<std::uint8_t> colors; // index into kCardPalette
+        std::vector<std::uint32_t> completedAt;
+
+        [[nodiscard]] std::size_t size() const { return ids.size(); }
+
+    private:
+        friend class BoardRenderCache;
+
+        std::uint64_t revision_ = std::numeric_limits<std::uint64_t>::max(); // CardStore::columnRevision()
+        bool laidOut_ = false;
+        float wrapWidth_ = 0.0f;
+        ImFont *font_ = nullptr;
+        float fontSize_ = 0.0f;
+    };
+
+    // Column caches per (project, status). A column is rebuilt only when the store reports that
+    // its cards changed, and relaid out only when that happens or the wrap width or font change.
+    class BoardRenderCache
+    {
+    public:
+        // Up to date for the current font; must be called inside an ImGui frame
+        const ColumnRenderCache &column(const CardStore &store, int projectId, CardStatus status, float wrapWidth);
+        // As last returned by column(), for handling input on what was drawn; null if never drawn
+        [[nodiscard]] const ColumnRenderCache *drawn(int projectId, CardStatus status) const;
+
+    private:
+        using ProjectColumns = std::array<ColumnRenderCache, 3>;
+
+        static void rebuild(const CardStore &store, int projectId, ProjectColumns &columns);
+        static void layOut(const CardStore &store, ColumnRenderCache &column, float wrapWidth);
+
+        std::unordered_map<int, ProjectColumns> projects_;
+    };
+}
@@ -0,0 +1,301 @@
+#include "board_snapshot.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <thread>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "spdlog/spdlog.h"
+
+namespace todo {
+    namespace {
+        constexpr char kMagic[8] = {'A', 'D', 'D', 'S', 'N', 'A', 'P', '\0'};
+        constexpr std::uint32_t kFormatVersion = 1;
+
+        struct StringRef
+        {
+            std::uint32_t offset;
+            std::uint32_t length;
+        };
+
+        struct SnapshotHeader
+        {
+            char magic[8];
+            std::uint32_t formatVersion;
+            std::int32_t dbVersion;
+            std::int64_t schemaVersion;
+            std::uint32_t projectCount;
+            std::uint32_t cardCount;
+            std::uint64_t arenaSize;
+            std::uint64_t fileSize;
+        };
+
+        struct SnapshotProject
+        {
+            std::int32_t id;
+            std::int32_t status;
+            StringRef name;
+            StringRef createdAt;
+        };
+
+        struct SnapshotCard
+        {
+            std::int32_t id;
+            std::int32_t status;
+            std::int32_t sequence;
+            std::int32_t projectId;
+            StringRef title;
+            StringRef description;
+            StringRef createdAt;
+            StringRef completedAt;
+        };
+
+        // Read-only view of the whole file: mmap where available, a plain read otherwise
+        class MappedFile
+        {
+        public:
+            explicit MappedFile(const std::string &path)
+            {
+#ifdef _WIN32
+                std::ifstream in(path, std::ios::binary | std::ios::ate);
+                if (!in) return;
+                buffer_.resize(static_cast<size_t>(in.tellg()));
+                in.seekg(0);
+                in.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+                if (!in) buffer_.clear();
+                data_ = buffer_.data();
+                size_ = buffer_.size();
+#else
+                const int fd = ::open(path.c_str(), O_RDONLY);
+                if (fd < 0) return;
+
+                struct stat info{};
+                if (::fstat(fd, &info) == 0 && info.st_size > 0)
+                {
+                    void *mapped = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (mapped != MAP_FAILED)
+                    {
+                        data_ = static_cast<const char *>(mapped);
+                        size_ = static_cast<size_t>(info.st_size);
+                    }
+                }
+                ::close(fd);
+#endif
+            }
+
+            ~MappedFile()
+            {
+#ifndef _WIN32
+                if (data_) ::munmap(const_cast<char *>(data_), size_);
+#endif
+            }
+
+            MappedFile(const MappedFile &) = delete;
+            MappedFile &operator=(const MappedFile &) = delete;
+
+            [[nodiscard]] const char *data() const { return data_; }
+            [[nodiscard]] size_t size() const { return size_; }
+
+        private:
+            const char *data_ = nullptr;
+            size_t size_ = 0;
+#ifdef _WIN32
+            std::vector<char> buffer_;
+#endif
+        };
+
+        class ArenaWriter
+        {
+        public:
+            explicit ArenaWriter(std::vector<char> &out) : out_(out), base_(out.size())
+            {
+            }
+
+            StringRef add(const std::string &text)
+            {
+                const StringRef ref{static_cast<std::uint32_t>(out_.size() - base_), static_cast<std::uint32_t>(text.size())};
+                out_.insert(out_.end(), text.begin(), text.end());
+                return ref;
+            }
+
+        private:
+            std::vector<char> &out_;
+            size_t base_;
+        };
+    }
+
+    SnapshotStamp currentSnapshotStamp(sqlite3 *db)
+    {
+        SnapshotStamp stamp;
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(db, "PRAGMA schema_version;", -1, &stmt, nullptr) == SQLITE_OK &&
+            sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            stamp.schemaVersion = sqlite3_column_int64(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+
+        stmt = nullptr;
+        if (sqlite3_prepare_v2(db, "SELECT CAST(value AS INTEGER) FROM app_metadata WHERE key = 'db_version';", -1,
+                               &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            stamp.dbVersion = sqlite3_column_int(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+        return stamp;
+    }
+
+    bool writeBoardSnapshot(const std::string &path, const SnapshotStamp &stamp, const std::vector<TodoCard> &cards,
+                            const std::vector<proj::Project> &projects)
+    {
+        size_t arenaSize = 0;
+        for (const auto &project: projects) arenaSize += project.name.size() + project.createdAt.size();
+        for (const auto &card: cards)
+        {
+            arenaSize += card.title.size() + card.description.size() + card.createdAt.size() + card.completedAt.size();
+        }
+        if (arenaSize > UINT32_MAX) return false;
+
+        const size_t tableSize = sizeof(SnapshotHeader) + projects.size() * sizeof(SnapshotProject) +
+                                 cards.size() * sizeof(SnapshotCard);
+
+        // Records first, then the arena appended behind them, all in one buffer and one write.
+        // The full size is reserved up front so the record pointers below stay valid.
+        std::vector<char> out(tableSize);
+        out.reserve(tableSize + arenaSize);
+        ArenaWriter arena(out);
+
+        auto *projectRecords = reinterpret_cast<SnapshotProject *>(out.data() + sizeof(SnapshotHeader));
+        for (size_t i = 0; i < projects.size(); i++)
+        {
+            const auto &project = projects[i];
+            projectRecords[i] = {project.id, proj::statusToInt(project.status), arena.add(project.name),
+                                 arena.add(project.createdAt)};
+        }
+
+        auto *cardRecords = reinterpret_cast<SnapshotCard *>(out.data() + sizeof(SnapshotHeader) +
+                                                             projects.size() * sizeof(SnapshotProject));
+        for (size_t i = 0; i < cards.size(); i++)
+        {
+            const auto &card = cards[i];
+            cardRecords[i] = {
+                card.id, statusToInt(card.status), card.sequence, card.projectId, arena.add(card.title),
+                arena.add(card.description), arena.add(card.createdAt), arena.add(card.completedAt)
+            };
+        }
+
+        SnapshotHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.formatVersion = kFormatVersion;
+        header.dbVersion = stamp.dbVersion;
+        header.schemaVersion = stamp.schemaVersion;
+        header.projectCount = static_cast<std::uint32_t>(projects.size());
+        header.cardCount = static_cast<std::uint32_t>(cards.size());
+        header.arenaSize = arenaSize;
+        header.fileSize = out.size();
+        std::memcpy(out.data(), &header, sizeof(header));
+
+        // Unique per thread: a background save and the one at shutdown may overlap
+        const std::string tempPath =
+                path + ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        std::FILE *file = std::fopen(tempPath.c_str(), "wb");
+        if (!file)
+        {
+            spdlog::error("Failed to write board snapshot {}", tempPath);
+            return false;
+        }
+        bool success = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+        success = std::fclose(file) == 0 && success;
+
+        std::error_code ec;
+        if (success) std::filesystem::rename(tempPath, path, ec);
+        if (!success || ec)
+        {
+            spdlog::error("Failed to write board snapshot {}", path);
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+    bool loadBoardSnapshot(const std::string &path, const SnapshotStamp &stamp, CardStore &cards,
+                           std::vector<proj::Project> &projects)
+    {
+        const MappedFile file(path);
+        if (!file.data() || file.size() < sizeof(SnapshotHeader)) return false;
+
+        SnapshotHeader header{};
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.formatVersion != kFormatVersion ||
+            header.fileSize != file.size())
+        {
+            spdlog::warn("Ignoring damaged board snapshot {}", path);
+            return false;
+        }
+        if (header.dbVersion != stamp.dbVersion || header.schemaVersion != stamp.schemaVersion)
+        {
+            spdlog::info("Board snapshot was written for another schema; loading from the database");
+            return false;
+        }
+
+        const std::uint64_t tableSize = sizeof(SnapshotHeader) +
+                                        std::uint64_t{header.projectCount} * sizeof(SnapshotProject) +
+                                        std::uint64_t{header.cardCount} * sizeof(SnapshotCard);
+        if (tableSize + header.arenaSize != header.fileSize) return false;
+
+        const char *arena = file.data() + tableSize;
+        bool inBounds = true;
+        auto text = [&](const StringRef ref)
+        {
+            if (std::uint64_t{ref.offset} + ref.length > header.arenaSize)
+            {
+                inBounds = false;
+                return std::string_view();
+            }
+            return std::string_view(arena + ref.offset, ref.length);
+        };
+
+        std::vector<proj::Project> loadedProjects;
+        loadedProjects.reserve(header.projectCount);
+        const char *records = file.data() + sizeof(SnapshotHeader);
+        for (std::uint32_t i = 0; i < header.projectCount; i++)
+        {
+            SnapshotProject record{};
+            std::memcpy(&record, records + i * sizeof(SnapshotProject), sizeof(record));
+            loadedProjects.emplace_back(record.id, std::string(text(record.name)), proj::intToStatus(record.status),
+                                        std::string(text(record.createdAt)));
+        }
+
+        CardStore loadedCards;
+        loadedCards.reserve(header.cardCount);
+        records += header.projectCount * sizeof(SnapshotProject);
+        for (std::uint32_t i = 0; i < header.cardCount; i++)
+        {
+            SnapshotCard record{};
+            std::memcpy(&record, records + i * sizeof(SnapshotCard), sizeof(record));
+            loadedCards.emplace_back(record.id, text(record.title), text(record.description),
+                                     intToStatus(record.status), record.sequence, record.projectId,
+                                     text(record.createdAt), text(record.completedAt));
+        }
+
+        if (!inBounds)
+        {
+            spdlog::warn("Ignoring damaged board snapshot {}", path);
+            return false;
+        }
+
+        cards = std::move(loadedCards);
+        projects = std::move(loadedProjects);
+        return true;
+    }
+}
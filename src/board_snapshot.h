@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "card_store.h"
+#include "project.h"
+#include "sqlite3.h"
+#include "todo_card.h"
+
+namespace todo {
+    // Binary image of the board, memory-mapped at startup so the first frame does not wait on
+    // SQL. Layout, native endianness:
+    //   SnapshotHeader
+    //   SnapshotProject[projectCount]    fixed-size records (the offset table)
+    //   SnapshotCard[cardCount]
+    //   string arena                     UTF-8, referenced by {offset, length} from the records
+    //
+    // A snapshot only has to be compatible, not current: the app draws it and then reconciles
+    // with SQLite in the background. PRAGMA data_version is per connection and cannot be
+    // carried across runs, so compatibility is the persistent schema cookie plus db_version.
+    struct SnapshotStamp
+    {
+        std::int64_t schemaVersion = 0; // PRAGMA schema_version
+        std::int32_t dbVersion = 0; // app_metadata db_version
+
+        bool operator==(const SnapshotStamp &) const = default;
+    };
+
+    SnapshotStamp currentSnapshotStamp(sqlite3 *db);
+
+    // Written to a temporary file and renamed over `path`, so readers never see a partial file
+    bool writeBoardSnapshot(const std::string &path, const SnapshotStamp &stamp, const std::vector<TodoCard> &cards,
+                            const std::vector<proj::Project> &projects);
+
+    // False when the file is missing, damaged or was written for a different schema. Cards are
+    // packed into `cards` straight from the mapped string table.
+    bool loadBoardSnapshot(const std::string &path, const SnapshotStamp &stamp, CardStore &cards,
+                           std::vector<proj::Project> &projects);
+}
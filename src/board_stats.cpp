@@ -0,0 +1,40 @@
+#include "board_stats.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace todo {
+    StatsSummary summarizeDailyStats(const std::vector<DailyStats> &stats, const int days)
+    {
+        using namespace std::chrono;
+
+        StatsSummary summary;
+        summary.completedPerDay.assign(static_cast<size_t>(std::max(days, 0)), 0.0f);
+
+        const sys_days today = floor<std::chrono::days>(system_clock::now());
+        std::int64_t cycleSeconds = 0;
+        for (const auto &day: stats)
+        {
+            summary.created += day.created;
+            summary.started += day.started;
+            summary.completed += day.completed;
+            cycleSeconds += day.cycleSeconds;
+
+            int y = 0;
+            unsigned m = 0, d = 0;
+            if (std::sscanf(day.day.c_str(), "%d-%u-%u", &y, &m, &d) != 3) continue;
+            const auto age = (today - sys_days(year{y} / month{m} / d)).count();
+            if (age >= 0 && age < days)
+            {
+                summary.completedPerDay[static_cast<size_t>(days - 1 - age)] = static_cast<float>(day.completed);
+            }
+        }
+
+        if (summary.completed > 0)
+        {
+            summary.meanCycleHours = static_cast<double>(cycleSeconds) / summary.completed / 3600.0;
+        }
+        return summary;
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace todo {
+    // One row of project_daily_stats, or their sum over projects (CardDatabase::readDailyStats)
+    struct DailyStats
+    {
+        std::string day; // YYYY-MM-DD, UTC
+        int created = 0;
+        int started = 0;
+        int completed = 0;
+        std::int64_t cycleSeconds = 0; // summed over the cards completed that day
+    };
+
+    // Dashboard view of a range of rollups
+    struct StatsSummary
+    {
+        int created = 0;
+        int started = 0;
+        int completed = 0;
+        double meanCycleHours = 0.0;
+        // One entry per day of the range, oldest first, zero on days without activity
+        std::vector<float> completedPerDay;
+    };
+
+    // `stats` as returned for the last `days` days, ending today (UTC)
+    StatsSummary summarizeDailyStats(const std::vector<DailyStats> &stats, int days);
+}
@@ -0,0 +1,378 @@
+#include "board_sync.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "card_database.h"
+#include "spdlog/spdlog.h"
+
+namespace todo {
+    namespace {
+        // Only the board itself syncs; search index, change log and metadata stay per device
+        constexpr const char *kSyncedTables[] = {"cards", "projects"};
+
+        struct ConflictContext
+        {
+            int localDevice;
+            int incomingDevice;
+            int conflicts = 0;
+        };
+
+        int filterTable(void *, const char *table)
+        {
+            return std::ranges::any_of(kSyncedTables, [&](const char *synced) { return std::strcmp(synced, table) == 0; });
+        }
+
+        int resolveConflict(void *context, const int type, sqlite3_changeset_iter *iter)
+        {
+            auto &ctx = *static_cast<ConflictContext *>(context);
+            ctx.conflicts++;
+
+            const char *table = nullptr;
+            int columns = 0, op = 0, indirect = 0;
+            sqlite3changeset_op(iter, &table, &columns, &op, &indirect);
+
+            // Both sides must pick the same winner, whichever of them applies the other's file first
+            const bool incomingWins = ctx.incomingDevice > ctx.localDevice;
+            switch (type)
+            {
+                case SQLITE_CHANGESET_DATA:
+                    // Edited here as well (or, for a delete, edited here before the delete arrived)
+                    if (op == SQLITE_DELETE) return SQLITE_CHANGESET_REPLACE;
+                    return incomingWins ? SQLITE_CHANGESET_REPLACE : SQLITE_CHANGESET_OMIT;
+                case SQLITE_CHANGESET_NOTFOUND:
+                    // Edited there, deleted here: it stays deleted
+                    return SQLITE_CHANGESET_OMIT;
+                case SQLITE_CHANGESET_CONFLICT:
+                    // The same id inserted on both sides, only possible for rows from before the sync
+                    return incomingWins ? SQLITE_CHANGESET_REPLACE : SQLITE_CHANGESET_OMIT;
+                default:
+                    spdlog::warn("Sync skipped a change to {} from device {} that violates a constraint", table,
+                                 ctx.incomingDevice);
+                    return SQLITE_CHANGESET_OMIT;
+            }
+        }
+
+        // device-<device>-<serial>.changeset
+        bool parseChangesetName(const std::string_view name, int &device, std::uint64_t &serial)
+        {
+            constexpr std::string_view prefix = "device-", suffix = ".changeset";
+            if (!name.starts_with(prefix) || !name.ends_with(suffix)) return false;
+
+            const char *p = name.data() + prefix.size();
+            const char *end = name.data() + name.size() - suffix.size();
+            auto [afterDevice, ec] = std::from_chars(p, end, device);
+            if (ec != std::errc() || afterDevice == end || *afterDevice != '-') return false;
+            auto [afterSerial, ec2] = std::from_chars(afterDevice + 1, end, serial);
+            return ec2 == std::errc() && afterSerial == end;
+        }
+
+        // device-<device>.claim
+        bool parseClaimName(const std::string_view name, int &device)
+        {
+            constexpr std::string_view prefix = "device-", suffix = ".claim";
+            if (!name.starts_with(prefix) || !name.ends_with(suffix)) return false;
+
+            const char *end = name.data() + name.size() - suffix.size();
+            auto [after, ec] = std::from_chars(name.data() + prefix.size(), end, device);
+            return ec == std::errc() && after == end;
+        }
+
+        // `later` applied after `earlier`, as one changeset
+        void appendChangeset(std::vector<char> &earlier, const void *later, const int laterSize)
+        {
+            if (laterSize == 0) return;
+            if (earlier.empty())
+            {
+                const auto *bytes = static_cast<const char *>(later);
+                earlier.assign(bytes, bytes + laterSize);
+                return;
+            }
+
+            int size = 0;
+            void *combined = nullptr;
+            if (sqlite3changeset_concat(static_cast<int>(earlier.size()), earlier.data(), laterSize,
+                                        const_cast<void *>(later), &size, &combined) != SQLITE_OK)
+            {
+                spdlog::error("Failed to merge sync changesets; the older edits are dropped");
+                const auto *bytes = static_cast<const char *>(later);
+                earlier.assign(bytes, bytes + laterSize);
+                return;
+            }
+            const auto *bytes = static_cast<const char *>(combined);
+            earlier.assign(bytes, bytes + size);
+            sqlite3_free(combined);
+        }
+
+        bool readFile(const std::string &path, std::vector<char> &out)
+        {
+            std::FILE *file = std::fopen(path.c_str(), "rb");
+            if (!file) return false;
+
+            std::error_code ec;
+            out.resize(static_cast<size_t>(std::filesystem::file_size(path, ec)));
+            const bool success = !ec && std::fread(out.data(), 1, out.size(), file) == out.size();
+            std::fclose(file);
+            return success;
+        }
+    }
+
+    BoardSync::BoardSync(CardDatabase &db, std::string folder)
+        : db_(db), handle_(db.handle()), folder_(std::move(folder))
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(folder_, ec);
+        if (ec) throw std::runtime_error("Sync folder unavailable: " + folder_);
+
+        device_ = claimDevice();
+        if (device_ <= 0) throw std::runtime_error("No free device number in sync folder " + folder_);
+
+        if (!startSession()) throw std::runtime_error("Failed to start sync session");
+    }
+
+    BoardSync::~BoardSync()
+    {
+        if (session_) sqlite3session_delete(session_);
+    }
+
+    std::string BoardSync::configuredFolder(const CardDatabase &db)
+    {
+        return db.getMetadata("sync_folder");
+    }
+
+    int BoardSync::claimDevice()
+    {
+        const std::string claimedFolder = db_.getMetadata("sync_folder");
+        const std::string claimedDevice = db_.getMetadata("sync_device");
+        if (claimedFolder == folder_ && !claimedDevice.empty()) return std::stoi(claimedDevice);
+
+        // Devices that have claimed a number or written changesets under it
+        int highest = 0;
+        for (const auto &entry: std::filesystem::directory_iterator(folder_))
+        {
+            const std::string name = entry.path().filename().string();
+            int device = 0;
+            std::uint64_t serial = 0;
+            if (parseClaimName(name, device) || parseChangesetName(name, device, serial))
+            {
+                highest = std::max(highest, device);
+            }
+        }
+
+        for (int device = highest + 1; device <= CardDatabase::kMaxDevices; device++)
+        {
+            // "x": fails if another device created the claim in the meantime
+            const std::string claimPath = folder_ + "/device-" + std::to_string(device) + ".claim";
+            std::FILE *claim = std::fopen(claimPath.c_str(), "wx");
+            if (!claim) continue;
+            std::fclose(claim);
+
+            // Ids restart in the new range; applied serials belong to the old folder
+            const sqlite3_int64 floor = device * CardDatabase::kIdsPerDevice;
+            sqlite3_exec(handle_, "DELETE FROM app_metadata WHERE key LIKE 'sync\\_applied\\_%' ESCAPE '\\';", nullptr,
+                         nullptr, nullptr);
+            db_.setMetadata("sync_last_card_id", std::to_string(floor - 1));
+            db_.setMetadata("sync_last_project_id", std::to_string(floor - 1));
+            db_.setMetadata("sync_exported_serial", "0");
+            db_.setMetadata("sync_device", std::to_string(device));
+            db_.setMetadata("sync_folder", folder_);
+            db_.useDeviceIdRange(device);
+            spdlog::info("Joined sync folder {} as device {}", folder_, device);
+            return device;
+        }
+        return 0;
+    }
+
+    bool BoardSync::startSession()
+    {
+        if (sqlite3session_create(handle_, "main", &session_) != SQLITE_OK) return false;
+        for (const char *table: kSyncedTables)
+        {
+            if (sqlite3session_attach(session_, table) != SQLITE_OK) return false;
+        }
+        return true;
+    }
+
+    void BoardSync::pauseRecording()
+    {
+        collectChanges();
+        if (session_) sqlite3session_enable(session_, 0);
+    }
+
+    void BoardSync::resumeRecording() const
+    {
+        if (session_) sqlite3session_enable(session_, 1);
+    }
+
+    std::string BoardSync::changesetPath(const int device, const std::uint64_t serial) const
+    {
+        return folder_ + "/device-" + std::to_string(device) + "-" + std::to_string(serial) + ".changeset";
+    }
+
+    bool BoardSync::exportChanges(Stats *stats)
+    {
+        std::vector<char> changeset = takeChanges();
+        if (changeset.empty()) return false;
+        if (writeChanges(changeset, stats)) return true;
+
+        returnChanges(std::move(changeset));
+        return false;
+    }
+
+    std::vector<char> BoardSync::takeChanges()
+    {
+        collectChanges();
+        return std::exchange(unsent_, {});
+    }
+
+    void BoardSync::collectChanges()
+    {
+        if (!session_ || sqlite3session_isempty(session_)) return;
+
+        int size = 0;
+        void *changeset = nullptr;
+        if (sqlite3session_changeset(session_, &size, &changeset) != SQLITE_OK)
+        {
+            spdlog::error("Failed to collect sync changes: {}", sqlite3_errmsg(handle_));
+            return;
+        }
+        // Edits that cancel out (a card added and deleted again) leave nothing to send
+        appendChangeset(unsent_, changeset, size);
+        sqlite3_free(changeset);
+
+        // Start recording afresh; what was collected must not be sent again
+        sqlite3session_delete(session_);
+        session_ = nullptr;
+        if (!startSession()) spdlog::error("Failed to restart sync session");
+    }
+
+    void BoardSync::returnChanges(std::vector<char> changeset)
+    {
+        // Anything taken since is newer than what came back
+        appendChangeset(changeset, unsent_.data(), static_cast<int>(unsent_.size()));
+        unsent_ = std::move(changeset);
+    }
+
+    bool BoardSync::writeChanges(const std::vector<char> &changeset, Stats *stats)
+    {
+        if (changeset.empty()) return false;
+        const auto size = changeset.size();
+
+        // The serial is taken under the write lock, so the import thread's session cannot
+        // claim the same one
+        if (sqlite3_exec(handle_, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) return false;
+        const std::uint64_t serial = std::stoull(db_.getMetadata("sync_exported_serial", "0")) + 1;
+        const std::string path = changesetPath(device_, serial);
+
+        // Written under a name other devices ignore, then renamed, so they never read half a file
+        const std::string tempPath = path + ".tmp";
+        bool success = false;
+        if (std::FILE *file = std::fopen(tempPath.c_str(), "wb"))
+        {
+            success = std::fwrite(changeset.data(), 1, size, file) == size;
+            success = std::fclose(file) == 0 && success;
+        }
+
+        std::error_code ec;
+        if (success) std::filesystem::rename(tempPath, path, ec);
+        success = success && !ec && db_.setMetadata("sync_exported_serial", std::to_string(serial)) &&
+                  sqlite3_exec(handle_, "COMMIT;", nullptr, nullptr, nullptr) == SQLITE_OK;
+        if (!success)
+        {
+            spdlog::error("Failed to write sync changeset {}", path);
+            sqlite3_exec(handle_, "ROLLBACK;", nullptr, nullptr, nullptr);
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        if (stats) stats->bytes += static_cast<std::uint64_t>(size);
+        spdlog::info("Exported sync changeset {} ({} bytes)", path, size);
+        return true;
+    }
+
+    int BoardSync::importChanges(Stats *stats)
+    {
+        // Pending serials per device; a gap (a file still on its way) stops that device's chain
+        std::map<int, std::vector<std::uint64_t>> pending;
+        std::error_code ec;
+        for (const auto &entry: std::filesystem::directory_iterator(folder_, ec))
+        {
+            int device = 0;
+            std::uint64_t serial = 0;
+            if (parseChangesetName(entry.path().filename().string(), device, serial) && device != device_)
+            {
+                pending[device].push_back(serial);
+            }
+        }
+        if (ec)
+        {
+            spdlog::error("Failed to read sync folder {}: {}", folder_, ec.message());
+            return -1;
+        }
+
+        int applied = 0;
+        for (auto &[device, serials]: pending)
+        {
+            std::ranges::sort(serials);
+            std::uint64_t last = std::stoull(db_.getMetadata("sync_applied_" + std::to_string(device), "0"));
+            for (const std::uint64_t serial: serials)
+            {
+                if (serial <= last) continue;
+                if (serial != last + 1) break;
+                if (!applyFile(device, serial, changesetPath(device, serial), stats)) return -1;
+                last = serial;
+                applied++;
+            }
+        }
+        if (stats) stats->filesApplied += applied;
+        return applied;
+    }
+
+    bool BoardSync::applyFile(const int device, const std::uint64_t serial, const std::string &path, Stats *stats)
+    {
+        std::vector<char> changeset;
+        if (!readFile(path, changeset))
+        {
+            spdlog::error("Failed to read sync changeset {}", path);
+            return false;
+        }
+
+        if (sqlite3_exec(handle_, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) return false;
+
+        // Incoming rows must not be recorded as local edits and sent back out
+        sqlite3session_enable(session_, 0);
+        ConflictContext context{device_, device};
+        int rc = sqlite3changeset_apply(handle_, static_cast<int>(changeset.size()), changeset.data(), filterTable,
+                                        resolveConflict, &context);
+        sqlite3session_enable(session_, 1);
+
+        const bool success = rc == SQLITE_OK &&
+                              db_.setMetadata("sync_applied_" + std::to_string(device), std::to_string(serial)) &&
+                              sqlite3_exec(handle_, "COMMIT;", nullptr, nullptr, nullptr) == SQLITE_OK;
+        if (!success)
+        {
+            spdlog::error("Failed to apply sync changeset {}: {}", path, sqlite3_errmsg(handle_));
+            sqlite3_exec(handle_, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
+
+        if (context.conflicts > 0)
+        {
+            spdlog::info("Resolved {} sync conflicts from device {}", context.conflicts, device);
+        }
+        if (stats)
+        {
+            stats->conflicts += context.conflicts;
+            stats->bytes += changeset.size();
+        }
+        return true;
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "sqlite3.h"
+
+namespace todo {
+    class CardDatabase;
+
+    // Two-way sync of cards and projects between copies of the board (desktop and laptop)
+    // through a shared folder: Dropbox, Syncthing, a network share. Each device records its own
+    // edits with the SQLite session extension and writes them out as numbered binary changesets,
+    //   <folder>/device-<device>-<serial>.changeset
+    // then applies the changesets of every other device in serial order. Only changed rows
+    // travel, so a day's edits are kilobytes instead of the whole database.
+    //
+    // Every device must start from a copy of the same todos.db. Joining the folder claims a
+    // device number (device-<device>.claim), which also selects the id range new cards and
+    // projects are created in (CardDatabase::useDeviceIdRange), so inserts never collide.
+    //
+    // Conflicts are resolved the same way on both sides, so the copies converge whichever
+    // applies first: a deletion beats an edit, and between two edits of the same row the
+    // device with the higher number wins.
+    //
+    // Only writes made through `db`'s connection are recorded. Use one BoardSync per writer
+    // connection (the import thread has its own).
+    class BoardSync
+    {
+    public:
+        struct Stats
+        {
+            int filesApplied = 0;
+            int conflicts = 0;
+            std::uint64_t bytes = 0;
+        };
+
+        // Claims a device number in `folder` the first time this board joins it. Throws if the
+        // session extension is unavailable or the folder cannot be used.
+        BoardSync(CardDatabase &db, std::string folder);
+        ~BoardSync();
+
+        BoardSync(const BoardSync &) = delete;
+        BoardSync &operator=(const BoardSync &) = delete;
+
+        // Writes the local edits recorded since the last export as one changeset file.
+        // Returns false if there was nothing to write or the write failed.
+        bool exportChanges(Stats *stats = nullptr);
+
+        // exportChanges() in two halves, so the file I/O can run on another connection:
+        // takeChanges() hands over the recorded edits (in memory, no I/O) and restarts recording,
+        // and writeChanges() on a BoardSync of any connection to the board writes them out.
+        // Edits that failed to write go back with returnChanges() and leave with the next take.
+        [[nodiscard]] std::vector<char> takeChanges();
+        void returnChanges(std::vector<char> changeset);
+        bool writeChanges(const std::vector<char> &changeset, Stats *stats = nullptr);
+
+        // Applies every changeset from other devices that has not been applied yet.
+        // Returns the number of files applied, or -1 on error.
+        int importChanges(Stats *stats = nullptr);
+
+        // Writes made on `db` between these are not sent to other devices. Archiving runs
+        // paused: each device archives by its own policy, and a card moved to the archive
+        // would otherwise arrive elsewhere as a delete. Disabling the session is not enough for
+        // rows it already tracks (their final state is read when the changeset is made), so
+        // pausing first moves the recorded edits out and starts a fresh session.
+        void pauseRecording();
+        void resumeRecording() const;
+
+        [[nodiscard]] int device() const { return device_; }
+        [[nodiscard]] const std::string &folder() const { return folder_; }
+
+        // Remembered in app_metadata so the app rejoins on the next start
+        static std::string configuredFolder(const CardDatabase &db);
+
+    private:
+        int claimDevice();
+        bool startSession();
+        // Appends the session's edits to unsent_ and restarts it
+        void collectChanges();
+        bool applyFile(int device, std::uint64_t serial, const std::string &path, Stats *stats);
+        [[nodiscard]] std::string changesetPath(int device, std::uint64_t serial) const;
+
+        CardDatabase &db_;
+        sqlite3 *handle_ = nullptr;
+        std::string folder_;
+        int device_ = 0;
+        sqlite3_session *session_ = nullptr;
+        std::vector<char> unsent_; // taken from the session and not yet written
+    };
+}
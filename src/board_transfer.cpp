@@ -0,0 +1,652 @@
+#include "board_transfer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "card_database.h"
+#include "json_stream.h"
+#include "spdlog/spdlog.h"
+#include "vendor_import.h"
+
+namespace todo {
+    namespace {
+        // Cards per transaction on import
+        constexpr size_t kChunkSize = 16384;
+        constexpr size_t kIoBufferSize = 1 << 20;
+
+        // One parsed row of either format. Buffers are reused from row to row.
+        struct TransferRecord
+        {
+            std::string type;
+            std::string name;
+            std::string description;
+            std::string createdAt;
+            std::string completedAt;
+            int id = 0;
+            int status = 0;
+            int project = 0;
+
+            void clear()
+            {
+                type.clear();
+                name.clear();
+                description.clear();
+                createdAt.clear();
+                completedAt.clear();
+                id = status = project = 0;
+            }
+        };
+
+        enum class Field
+        {
+            None,
+            Type,
+            Id,
+            Name,
+            Description,
+            Status,
+            Sequence,
+            Project,
+            CreatedAt,
+            CompletedAt
+        };
+
+        Field fieldForName(const std::string_view name)
+        {
+            if (name == "type") return Field::Type;
+            if (name == "id") return Field::Id;
+            if (name == "title" || name == "name") return Field::Name;
+            if (name == "description") return Field::Description;
+            if (name == "status") return Field::Status;
+            if (name == "sequence") return Field::Sequence;
+            if (name == "project") return Field::Project;
+            if (name == "created_at") return Field::CreatedAt;
+            if (name == "completed_at") return Field::CompletedAt;
+            return Field::None;
+        }
+
+        int toInt(const std::string_view text)
+        {
+            int value = 0;
+            std::from_chars(text.data(), text.data() + text.size(), value);
+            return value;
+        }
+
+        void assignField(TransferRecord &record, const Field field, const std::string_view value)
+        {
+            switch (field)
+            {
+                case Field::Type: record.type.assign(value);
+                    break;
+                case Field::Id: record.id = toInt(value);
+                    break;
+                case Field::Name: record.name.assign(value);
+                    break;
+                case Field::Description: record.description.assign(value);
+                    break;
+                case Field::Status: record.status = toInt(value);
+                    break;
+                case Field::Project: record.project = toInt(value);
+                    break;
+                case Field::CreatedAt: record.createdAt.assign(value);
+                    break;
+                case Field::CompletedAt: record.completedAt.assign(value);
+                    break;
+                case Field::Sequence: // Imported cards are appended in file order
+                case Field::None:
+                    break;
+            }
+        }
+
+        std::string_view columnText(sqlite3_stmt *stmt, const int column)
+        {
+            const auto *text = reinterpret_cast<const char *>(sqlite3_column_text(stmt, column));
+            return text ? std::string_view(text, sqlite3_column_bytes(stmt, column)) : std::string_view();
+        }
+
+        // Collects imported rows into a CardBatch and applies it once per chunk
+        class RecordSink
+        {
+        public:
+            RecordSink(CardDatabase &db, TransferStats &stats, const TransferProgress &progress,
+                       std::function<std::uint64_t()> position, const std::uint64_t total)
+                : db_(db), stats_(stats), progress_(progress), position_(std::move(position)), total_(total)
+            {
+                batch_.reserve(kChunkSize);
+            }
+
+            bool add(TransferRecord &record)
+            {
+                if (record.type == "project")
+                {
+                    int newId = 0;
+                    if (!db_.addProject(record.name, record.status, &newId))
+                    {
+                        failed_ = true;
+                        return false;
+                    }
+                    projectIds_[record.id] = newId;
+                    stats_.projects++;
+                    return true;
+                }
+
+                if (!record.type.empty() && record.type != "card") return true;
+
+                // Cards of unknown projects land in the default project (0)
+                const auto project = projectIds_.find(record.project);
+                batch_.insert(TodoCard(-1, std::move(record.name), std::move(record.description),
+                                       intToStatus(record.status), -1,
+                                       project != projectIds_.end() ? project->second : 0,
+                                       std::move(record.createdAt), std::move(record.completedAt)));
+
+                return batch_.size() < kChunkSize || flush();
+            }
+
+            bool flush()
+            {
+                if (!batch_.empty())
+                {
+                    if (!db_.applyBatch(batch_.mutations(), nullptr, true))
+                    {
+                        failed_ = true;
+                        return false;
+                    }
+                    stats_.cards += batch_.size();
+                    batch_.clear();
+                }
+
+                if (progress_ && !progress_(position_(), total_))
+                {
+                    cancelled_ = true;
+                    return false;
+                }
+                return true;
+            }
+
+            [[nodiscard]] bool failed() const { return failed_; }
+            [[nodiscard]] bool cancelled() const { return cancelled_; }
+
+        private:
+            CardDatabase &db_;
+            TransferStats &stats_;
+            const TransferProgress &progress_;
+            std::function<std::uint64_t()> position_;
+            std::uint64_t total_;
+
+            CardBatch batch_;
+            std::unordered_map<int, int> projectIds_;
+            bool failed_ = false;
+            bool cancelled_ = false;
+        };
+
+        // Top-level objects of a JSON Lines file become records; nested values are ignored
+        class JsonlHandler final : public JsonReader::Handler
+        {
+        public:
+            explicit JsonlHandler(RecordSink &sink) : sink_(sink)
+            {
+            }
+
+            bool startObject() override
+            {
+                if (++depth_ == 1) record_.clear();
+                return true;
+            }
+
+            bool endObject() override
+            {
+                field_ = Field::None;
+                return --depth_ != 0 || sink_.add(record_);
+            }
+
+            bool startArray() override
+            {
+                depth_++;
+                return true;
+            }
+
+            bool endArray() override
+            {
+                depth_--;
+                field_ = Field::None;
+                return true;
+            }
+
+            bool key(const std::string_view name) override
+            {
+                field_ = depth_ == 1 ? fieldForName(name) : Field::None;
+                return true;
+            }
+
+            bool string(const std::string_view value) override { return assign(value); }
+            bool number(const std::string_view value) override { return assign(value); }
+            bool boolean(bool) override { return assign({}); }
+            bool null() override { return assign({}); }
+
+        private:
+            bool assign(const std::string_view value)
+            {
+                if (depth_ == 1) assignField(record_, field_, value);
+                field_ = Field::None;
+                return true;
+            }
+
+            RecordSink &sink_;
+            TransferRecord record_;
+            Field field_ = Field::None;
+            int depth_ = 0;
+        };
+
+        // RFC 4180 reader: quoted fields may contain separators, doubled quotes and newlines
+        class CsvReader
+        {
+        public:
+            explicit CsvReader(std::FILE *file) : file_(file), buffer_(kIoBufferSize)
+            {
+            }
+
+            // Reads the next record into fields[0, count). Returns false at end of input.
+            bool next(std::vector<std::string> &fields, size_t &count)
+            {
+                count = 0;
+                int c = get();
+                if (c == EOF) return false;
+
+                while (true)
+                {
+                    if (count == fields.size()) fields.emplace_back();
+                    std::string &field = fields[count++];
+                    field.clear();
+
+                    if (c == '"')
+                    {
+                        while ((c = get()) != EOF)
+                        {
+                            if (c == '"')
+                            {
+                                c = get();
+                                if (c != '"') break;
+                            }
+                            field += static_cast<char>(c);
+                        }
+                    } else
+                    {
+                        while (c != ',' && c != '\n' && c != '\r' && c != EOF)
+                        {
+                            field += static_cast<char>(c);
+                            c = get();
+                        }
+                    }
+
+                    if (c == ',')
+                    {
+                        c = get();
+                        continue;
+                    }
+                    if (c == '\r' && peek() == '\n') get();
+                    return true;
+                }
+            }
+
+            [[nodiscard]] std::uint64_t bytesConsumed() const { return bytesRead_ - (end_ - pos_); }
+
+        private:
+            bool refill()
+            {
+                pos_ = 0;
+                end_ = std::fread(buffer_.data(), 1, buffer_.size(), file_);
+                bytesRead_ += end_;
+                return end_ > 0;
+            }
+
+            int get()
+            {
+                if (pos_ == end_ && !refill()) return EOF;
+                return static_cast<unsigned char>(buffer_[pos_++]);
+            }
+
+            int peek()
+            {
+                if (pos_ == end_ && !refill()) return EOF;
+                return static_cast<unsigned char>(buffer_[pos_]);
+            }
+
+            std::FILE *file_;
+            std::vector<char> buffer_;
+            size_t pos_ = 0;
+            size_t end_ = 0;
+            std::uint64_t bytesRead_ = 0;
+        };
+
+        void appendCsvField(std::string &out, const std::string_view value)
+        {
+            if (value.find_first_of(",\"\r\n") == std::string_view::npos)
+            {
+                out.append(value);
+                return;
+            }
+
+            out += '"';
+            for (const char c: value)
+            {
+                if (c == '"') out += '"';
+                out += c;
+            }
+            out += '"';
+        }
+
+        // Column-level view of one exported row; text points into the statement's current row
+        struct RecordView
+        {
+            std::string_view type;
+            int id = 0;
+            std::string_view name;
+            std::string_view description;
+            int status = 0;
+            int sequence = 0;
+            int project = 0;
+            std::string_view createdAt;
+            std::string_view completedAt;
+        };
+
+        class RecordWriter
+        {
+        public:
+            RecordWriter(std::FILE *file, const TransferFormat format) : file_(file), format_(format), json_(file)
+            {
+                if (format_ == TransferFormat::Csv)
+                {
+                    csv_.reserve(kIoBufferSize + 4096);
+                    csv_ += "type,id,name,description,status,sequence,project,created_at,completed_at\n";
+                }
+            }
+
+            void write(const RecordView &row)
+            {
+                const bool card = row.type == "card";
+                if (format_ == TransferFormat::Jsonl)
+                {
+                    json_.startObject();
+                    json_.key("type");
+                    json_.string(row.type);
+                    json_.key("id");
+                    json_.number(row.id);
+                    json_.key(card ? "title" : "name");
+                    json_.string(row.name);
+                    if (card)
+                    {
+                        json_.key("description");
+                        json_.string(row.description);
+                    }
+                    json_.key("status");
+                    json_.number(row.status);
+                    if (card)
+                    {
+                        json_.key("sequence");
+                        json_.number(row.sequence);
+                        json_.key("project");
+                        json_.number(row.project);
+                    }
+                    json_.key("created_at");
+                    json_.string(row.createdAt);
+                    if (card)
+                    {
+                        json_.key("completed_at");
+                        json_.string(row.completedAt);
+                    }
+                    json_.endObject();
+                    json_.newline();
+                    return;
+                }
+
+                csv_.append(row.type);
+                csv_ += ',';
+                csv_ += std::to_string(row.id);
+                csv_ += ',';
+                appendCsvField(csv_, row.name);
+                csv_ += ',';
+                appendCsvField(csv_, row.description);
+                csv_ += ',';
+                csv_ += std::to_string(row.status);
+                csv_ += ',';
+                if (card) csv_ += std::to_string(row.sequence);
+                csv_ += ',';
+                if (card) csv_ += std::to_string(row.project);
+                csv_ += ',';
+                appendCsvField(csv_, row.createdAt);
+                csv_ += ',';
+                appendCsvField(csv_, row.completedAt);
+                csv_ += '\n';
+                if (csv_.size() >= kIoBufferSize) flush();
+            }
+
+            bool flush()
+            {
+                if (format_ == TransferFormat::Jsonl) return json_.flush() && !failed_;
+                if (!csv_.empty() && !failed_)
+                {
+                    failed_ = std::fwrite(csv_.data(), 1, csv_.size(), file_) != csv_.size();
+                }
+                csv_.clear();
+                return !failed_;
+            }
+
+        private:
+            std::FILE *file_;
+            TransferFormat format_;
+            JsonWriter json_;
+            std::string csv_;
+            bool failed_ = false;
+        };
+
+        double secondsSince(const std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    std::optional<TransferFormat> transferFormatForPath(const std::string &path)
+    {
+        std::string extension = std::filesystem::path(path).extension().string();
+        std::ranges::transform(extension, extension.begin(), [](const unsigned char c) { return std::tolower(c); });
+
+        if (extension == ".json")
+        {
+            if (const auto vendor = detectVendorFormat(path))
+            {
+                return *vendor == VendorFormat::Trello ? TransferFormat::Trello : TransferFormat::Jira;
+            }
+            return TransferFormat::Jsonl;
+        }
+        if (extension == ".jsonl" || extension == ".ndjson") return TransferFormat::Jsonl;
+        if (extension == ".csv") return TransferFormat::Csv;
+        return std::nullopt;
+    }
+
+    bool exportBoard(sqlite3 *db, const std::string &path, const TransferFormat format, TransferStats *stats)
+    {
+        if (format != TransferFormat::Jsonl && format != TransferFormat::Csv)
+        {
+            spdlog::error("Boards can only be exported as JSON Lines or CSV");
+            return false;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        TransferStats local;
+        TransferStats &counts = stats ? *stats : local;
+        counts = {};
+
+        std::FILE *file = std::fopen(path.c_str(), "wb");
+        if (!file)
+        {
+            spdlog::error("Failed to open {} for export", path);
+            return false;
+        }
+
+        const char *projectSql =
+                "SELECT id, name, IFNULL(status, 0), IFNULL(CAST(created_at AS TEXT), '') FROM projects ORDER BY id;";
+
+        // Archived cards travel with the board; importing them puts them back in the hot table
+        constexpr auto cardColumns =
+                "SELECT id, title, IFNULL(description, ''), status, sequence, IFNULL(project, 0), "
+                "IFNULL(CAST(created_at AS TEXT), ''), IFNULL(CAST(completed_at AS TEXT), '') ";
+        std::string cardSql = std::string(cardColumns) + "FROM main.cards";
+        if (sqlite3_db_filename(db, "archive") != nullptr)
+        {
+            cardSql += std::string(" UNION ALL ") + cardColumns + "FROM archive.cards";
+        }
+        cardSql += " ORDER BY 5, 1;";
+
+        RecordWriter writer(file, format);
+        bool success = true;
+
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(db, projectSql, -1, &stmt, nullptr) == SQLITE_OK)
+        {
+            while (sqlite3_step(stmt) == SQLITE_ROW)
+            {
+                RecordView row;
+                row.type = "project";
+                row.id = sqlite3_column_int(stmt, 0);
+                row.name = columnText(stmt, 1);
+                row.status = sqlite3_column_int(stmt, 2);
+                row.createdAt = columnText(stmt, 3);
+                writer.write(row);
+                counts.projects++;
+            }
+        } else
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(db));
+            success = false;
+        }
+        sqlite3_finalize(stmt);
+
+        stmt = nullptr;
+        if (success && sqlite3_prepare_v2(db, cardSql.c_str(), -1, &stmt, nullptr) == SQLITE_OK)
+        {
+            while (sqlite3_step(stmt) == SQLITE_ROW)
+            {
+                RecordView row;
+                row.type = "card";
+                row.id = sqlite3_column_int(stmt, 0);
+                row.name = columnText(stmt, 1);
+                row.description = columnText(stmt, 2);
+                row.status = sqlite3_column_int(stmt, 3);
+                row.sequence = sqlite3_column_int(stmt, 4);
+                row.project = sqlite3_column_int(stmt, 5);
+                row.createdAt = columnText(stmt, 6);
+                row.completedAt = columnText(stmt, 7);
+                writer.write(row);
+                counts.cards++;
+            }
+        } else if (success)
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(db));
+            success = false;
+        }
+        sqlite3_finalize(stmt);
+
+        success = writer.flush() && success;
+        counts.bytes = static_cast<std::uint64_t>(std::ftell(file));
+        success = std::fclose(file) == 0 && success;
+        counts.seconds = secondsSince(start);
+
+        if (!success)
+        {
+            spdlog::error("Export to {} failed", path);
+            return false;
+        }
+        spdlog::info("Exported {} projects and {} cards to {} in {:.2f} s", counts.projects, counts.cards, path,
+                     counts.seconds);
+        return true;
+    }
+
+    bool importBoard(CardDatabase &db, const std::string &path, const TransferFormat format, TransferStats *stats,
+                     const TransferProgress &progress)
+    {
+        if (format == TransferFormat::Trello || format == TransferFormat::Jira)
+        {
+            const auto vendor = format == TransferFormat::Trello ? VendorFormat::Trello : VendorFormat::Jira;
+            return importVendorExport(db, path, vendor, stats, progress);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        TransferStats local;
+        TransferStats &counts = stats ? *stats : local;
+        counts = {};
+
+        std::error_code ec;
+        const std::uint64_t total = std::filesystem::file_size(path, ec);
+
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        if (!file)
+        {
+            spdlog::error("Failed to open {} for import", path);
+            return false;
+        }
+
+        bool parsed = true;
+        std::string parseError;
+
+        if (format == TransferFormat::Jsonl)
+        {
+            JsonReader reader(file, kIoBufferSize);
+            RecordSink sink(db, counts, progress, [&reader] { return reader.bytesConsumed(); }, total);
+            JsonlHandler handler(sink);
+
+            parsed = reader.parse(handler, true) && sink.flush();
+            if (!parsed && !sink.failed() && !sink.cancelled()) parseError = reader.error();
+            counts.bytes = reader.bytesConsumed();
+        } else
+        {
+            CsvReader reader(file);
+            RecordSink sink(db, counts, progress, [&reader] { return reader.bytesConsumed(); }, total);
+
+            std::vector<std::string> fields;
+            std::vector<Field> columns;
+            size_t count = 0;
+
+            // The header names the columns, so files written by other tools may order them freely
+            if (reader.next(fields, count))
+            {
+                for (size_t i = 0; i < count; i++) columns.push_back(fieldForName(fields[i]));
+            }
+
+            TransferRecord record;
+            while (parsed && reader.next(fields, count))
+            {
+                if (count == 1 && fields[0].empty()) continue; // Blank line
+
+                record.clear();
+                for (size_t i = 0; i < std::min(count, columns.size()); i++)
+                {
+                    assignField(record, columns[i], fields[i]);
+                }
+                parsed = sink.add(record);
+            }
+            parsed = parsed && sink.flush();
+            counts.bytes = reader.bytesConsumed();
+        }
+
+        std::fclose(file);
+        counts.seconds = secondsSince(start);
+
+        if (!parsed)
+        {
+            spdlog::error("Import from {} stopped after {} cards{}{}", path, counts.cards,
+                          parseError.empty() ? "" : ": ", parseError);
+            return false;
+        }
+
+        spdlog::info("Imported {} projects and {} cards from {} in {:.2f} s ({:.0f} cards/s)", counts.projects,
+                     counts.cards, path, counts.seconds, counts.seconds > 0 ? counts.cards / counts.seconds : 0.0);
+        return true;
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+
+#include "sqlite3.h"
+
+namespace todo {
+    class CardDatabase;
+
+    // Interchange formats for moving a board between machines and tools. Both carry one
+    // record per project or card; projects come first so cards can be remapped on import.
+    //   JSONL: {"type":"card","id":7,"title":"...","description":"...","status":2,"sequence":3,
+    //           "project":1,"created_at":"...","completed_at":"..."}
+    //   CSV:   type,id,name,description,status,sequence,project,created_at,completed_at
+    // Trello and Jira JSON exports can be imported too (vendor_import.h), but not exported.
+    enum class TransferFormat
+    {
+        Jsonl,
+        Csv,
+        Trello,
+        Jira
+    };
+
+    struct TransferStats
+    {
+        std::uint64_t projects = 0;
+        std::uint64_t cards = 0;
+        std::uint64_t bytes = 0;
+        double seconds = 0.0;
+    };
+
+    // Called between chunks with the bytes processed so far and the file size. Return false to cancel.
+    using TransferProgress = std::function<bool(std::uint64_t done, std::uint64_t total)>;
+
+    // Guesses the format from the file extension (.jsonl/.ndjson or .csv). Existing .json files
+    // are sniffed for a Trello or Jira export and are read as JSON Lines otherwise.
+    std::optional<TransferFormat> transferFormatForPath(const std::string &path);
+
+    // Streams every project and card (including the archive, when attached) out of `db`.
+    bool exportBoard(sqlite3 *db, const std::string &path, TransferFormat format, TransferStats *stats = nullptr);
+
+    // Appends the file's projects and cards to the board. Rows are parsed as they are read and
+    // written in fixed-size chunks, one transaction per chunk, so memory use does not grow
+    // with the file. Card and project ids are reassigned; card order is preserved.
+    bool importBoard(CardDatabase &db, const std::string &path, TransferFormat format,
+                     TransferStats *stats = nullptr, const TransferProgress &progress = {});
+}
@@ -0,0 +1,303 @@
+#include "card_archiver.h"
+
+#include <string>
+
+#include "card_database.h"
+#include "project.h"
+#include "spdlog/spdlog.h"
+
+namespace todo {
+    CardArchiver::CardArchiver(CardDatabase &db, const std::string &archivePath)
+        : db_(db), handle_(db.handle())
+    {
+        attach(archivePath);
+
+        // Give startup some room before the first pass
+        nextRun_ = std::chrono::steady_clock::now() + std::chrono::minutes(1);
+    }
+
+    void CardArchiver::attach(const std::string &archivePath)
+    {
+        sqlite3_stmt *stmt = nullptr;
+        const std::string attachSql = std::string("ATTACH DATABASE ? AS ") + kSchema + ";";
+        if (sqlite3_prepare_v2(handle_, attachSql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(handle_));
+            return;
+        }
+        sqlite3_bind_text(stmt, 1, archivePath.c_str(), -1, SQLITE_TRANSIENT);
+        const bool attachedOk = sqlite3_step(stmt) == SQLITE_DONE;
+        sqlite3_finalize(stmt);
+        if (!attachedOk)
+        {
+            spdlog::error("Failed to attach archive {}: {}", archivePath, sqlite3_errmsg(handle_));
+            return;
+        }
+
+        // Same columns as the hot table plus archived_at. Triggers in an attached schema
+        // resolve unqualified names inside that schema, so cards_fts below is archive.cards_fts.
+        const char *schema = R"(
+            CREATE TABLE IF NOT EXISTS archive.cards (
+                id INTEGER PRIMARY KEY,
+                title TEXT NOT NULL,
+                description TEXT,
+                status INTEGER DEFAULT 0,
+                sequence INTEGER NOT NULL DEFAULT 0,
+                project INTEGER DEFAULT 0,
+                created_at TIMESTAMP,
+                completed_at TIMESTAMP NULL,
+                archived_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+            );
+
+            CREATE INDEX IF NOT EXISTS archive.idx_archive_cards_project ON cards(project);
+
+            CREATE VIRTUAL TABLE IF NOT EXISTS archive.cards_fts USING fts5(
+                title,
+                description,
+                content = 'cards',
+                content_rowid = 'id',
+                prefix = '2 3',
+                tokenize = 'unicode61 remove_diacritics 2'
+            );
+
+            CREATE TRIGGER IF NOT EXISTS archive.cards_fts_insert AFTER INSERT ON cards BEGIN
+                INSERT INTO cards_fts(rowid, title, description)
+                VALUES (new.id, new.title, new.description);
+            END;
+
+            CREATE TRIGGER IF NOT EXISTS archive.cards_fts_delete AFTER DELETE ON cards BEGIN
+                INSERT INTO cards_fts(cards_fts, rowid, title, description)
+                VALUES ('delete', old.id, old.title, old.description);
+            END;
+
+            CREATE TRIGGER IF NOT EXISTS archive.cards_fts_update AFTER UPDATE OF title, description ON cards BEGIN
+                INSERT INTO cards_fts(cards_fts, rowid, title, description)
+                VALUES ('delete', old.id, old.title, old.description);
+                INSERT INTO cards_fts(rowid, title, description)
+                VALUES (new.id, new.title, new.description);
+            END;
+
+            INSERT INTO archive.cards_fts(cards_fts, rank) VALUES ('rank', 'bm25(10.0, 1.0)');
+
+            CREATE TEMP TABLE IF NOT EXISTS archive_batch (id INTEGER PRIMARY KEY);
+        )";
+
+        char *err = nullptr;
+        if (sqlite3_exec(handle_, schema, nullptr, nullptr, &err) != SQLITE_OK)
+        {
+            spdlog::error("Archive schema error: {}", err ? err : "unknown error");
+            sqlite3_free(err);
+            return;
+        }
+
+        attached_ = true;
+
+        // Finishes an archive pass that stopped between the archive's commit and main's
+        const int removed = removeArchivedFromMain("SELECT id FROM archive.cards");
+        if (removed > 0) spdlog::info("Removed {} cards from the hot table that were already archived", removed);
+    }
+
+    int CardArchiver::removeArchivedFromMain(const char *candidates) const
+    {
+        const std::string sql = std::string("DELETE FROM main.cards WHERE id IN (SELECT c.id FROM (") + candidates +
+                                ") c JOIN archive.cards a ON a.id = c.id);";
+        if (!exec("BEGIN IMMEDIATE;")) return -1;
+        if (!exec(sql.c_str()))
+        {
+            exec("ROLLBACK;");
+            return -1;
+        }
+        const int removed = sqlite3_changes(handle_);
+        return exec("COMMIT;") ? removed : -1;
+    }
+
+    bool CardArchiver::reconcileRestored()
+    {
+        if (!attached_) return true;
+        if (removeArchivedFromMain("SELECT id FROM archive.cards") < 0) return false;
+
+        // AUTOINCREMENT only looks at sqlite_sequence and main's own rows; device 0 ids are
+        // below kIdsPerDevice. A synced board instead hands out ids from its metadata counter.
+        const char *sequenceSql =
+                "UPDATE main.sqlite_sequence SET seq = MAX(seq, IFNULL("
+                "(SELECT MAX(id) FROM archive.cards WHERE id < ?1), 0)) WHERE name = 'cards';"
+                "INSERT INTO main.sqlite_sequence (name, seq) "
+                "SELECT 'cards', MAX(id) FROM archive.cards WHERE id < ?1 "
+                "HAVING MAX(id) IS NOT NULL AND NOT EXISTS (SELECT 1 FROM main.sqlite_sequence WHERE name = 'cards');";
+        const char *counterSql =
+                "UPDATE main.app_metadata SET value = MAX(CAST(value AS INTEGER), IFNULL("
+                "(SELECT MAX(id) FROM archive.cards WHERE id >= ?2 AND id < ?2 + ?1), 0)) "
+                "WHERE key = 'sync_last_card_id';";
+
+        if (!exec("BEGIN IMMEDIATE;")) return false;
+        bool success = true;
+        for (const char *sql: {sequenceSql, counterSql})
+        {
+            // sequenceSql is two statements; step through each with the same bindings
+            const char *tail = sql;
+            while (success && tail && *tail)
+            {
+                sqlite3_stmt *stmt = nullptr;
+                if (sqlite3_prepare_v2(handle_, tail, -1, &stmt, &tail) != SQLITE_OK)
+                {
+                    spdlog::error("SQL error: {}", sqlite3_errmsg(handle_));
+                    success = false;
+                    break;
+                }
+                if (!stmt) break;
+                sqlite3_bind_int64(stmt, 1, CardDatabase::kIdsPerDevice);
+                if (sqlite3_bind_parameter_count(stmt) >= 2) sqlite3_bind_int64(stmt, 2, db_.idFloor());
+                success = sqlite3_step(stmt) == SQLITE_DONE;
+                if (!success) spdlog::error("SQL error: {}", sqlite3_errmsg(handle_));
+                sqlite3_finalize(stmt);
+            }
+            if (!success) break;
+        }
+
+        if (!success)
+        {
+            exec("ROLLBACK;");
+            return false;
+        }
+        return exec("COMMIT;");
+    }
+
+    bool CardArchiver::exec(const char *sql) const
+    {
+        char *err = nullptr;
+        if (sqlite3_exec(handle_, sql, nullptr, nullptr, &err) != SQLITE_OK)
+        {
+            spdlog::error("SQL error: {}", err ? err : "unknown error");
+            sqlite3_free(err);
+            return false;
+        }
+        return true;
+    }
+
+    int CardArchiver::archiveAfterDays() const
+    {
+        try
+        {
+            return std::stoi(db_.getMetadata("archive_after_days", "30"));
+        } catch (const std::exception &)
+        {
+            return 30;
+        }
+    }
+
+    void CardArchiver::setArchiveAfterDays(const int days)
+    {
+        db_.setMetadata("archive_after_days", std::to_string(days));
+    }
+
+    int CardArchiver::update()
+    {
+        if (!attached_) return 0;
+
+        const auto now = std::chrono::steady_clock::now();
+        if (!draining_ && now < nextRun_) return 0;
+
+        const int moved = archiveBatch(kBatchSize);
+
+        // A full batch means there is probably more; keep going one batch per frame
+        draining_ = moved == kBatchSize;
+        if (!draining_) nextRun_ = now + interval_;
+
+        if (moved > 0) spdlog::info("Archived {} cards", moved);
+        return moved;
+    }
+
+    int CardArchiver::archiveBatch(const int batchSize)
+    {
+        if (!attached_) return -1;
+
+        const std::string age = "-" + std::to_string(archiveAfterDays()) + " days";
+
+        // SQLite does not commit a WAL database and an attached one atomically, so the copy is
+        // committed first and the delete from main follows in a second transaction. A crash in
+        // between leaves the cards in both, never in neither; attach() finishes the move.
+        if (!exec("BEGIN IMMEDIATE;")) return -1;
+
+        // Pick the batch once so the copy and the delete agree on exactly the same rows
+        const char *selectSql = R"(
+            INSERT INTO temp.archive_batch (id)
+            SELECT id FROM main.cards
+            WHERE (restored_at IS NULL OR restored_at < datetime('now', ?1))
+              AND ((status = ?3 AND completed_at IS NOT NULL AND completed_at != ''
+                    AND completed_at < datetime('now', ?1))
+                   OR project IN (SELECT id FROM main.projects WHERE status = ?4))
+            LIMIT ?2;
+        )";
+
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(handle_, selectSql, -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(handle_));
+            exec("ROLLBACK;");
+            return -1;
+        }
+        sqlite3_bind_text(stmt, 1, age.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 2, batchSize);
+        sqlite3_bind_int(stmt, 3, statusToInt(CardStatus::Done));
+        sqlite3_bind_int(stmt, 4, proj::statusToInt(proj::ProjectStatus::ARCHIVED));
+        const bool selected = sqlite3_step(stmt) == SQLITE_DONE;
+        sqlite3_finalize(stmt);
+
+        // An older copy of a card (archived, restored, archived again) is deleted rather than
+        // REPLACEd, which would skip the delete trigger and leave it in the archive's FTS index
+        const bool copied = selected &&
+                            exec("DELETE FROM archive.cards WHERE id IN (SELECT id FROM temp.archive_batch);") &&
+                            exec("INSERT INTO archive.cards "
+                                 "(id, title, description, status, sequence, project, created_at, completed_at) "
+                                 "SELECT id, title, description, status, sequence, project, created_at, completed_at "
+                                 "FROM main.cards WHERE id IN (SELECT id FROM temp.archive_batch);");
+        if (!copied || !exec("COMMIT;"))
+        {
+            exec("ROLLBACK;");
+            exec("DELETE FROM temp.archive_batch;");
+            return -1;
+        }
+
+        // Only what made it into the archive leaves main; repeating this is harmless
+        const int count = removeArchivedFromMain("SELECT id FROM temp.archive_batch");
+        exec("DELETE FROM temp.archive_batch;");
+        return count;
+    }
+
+    bool CardArchiver::restoreCard(const int cardId)
+    {
+        if (!attached_) return false;
+        if (!exec("BEGIN IMMEDIATE;")) return false;
+
+        const char *insertSql =
+                "INSERT INTO main.cards "
+                "(id, title, description, status, sequence, project, created_at, completed_at, restored_at) "
+                "SELECT id, title, description, status, sequence, project, created_at, completed_at, CURRENT_TIMESTAMP "
+                "FROM archive.cards WHERE id = ?;";
+        const char *deleteSql = "DELETE FROM archive.cards WHERE id = ?;";
+
+        bool success = true;
+        for (const char *sql: {insertSql, deleteSql})
+        {
+            sqlite3_stmt *stmt = nullptr;
+            if (sqlite3_prepare_v2(handle_, sql, -1, &stmt, nullptr) != SQLITE_OK)
+            {
+                spdlog::error("SQL error: {}", sqlite3_errmsg(handle_));
+                success = false;
+                break;
+            }
+            sqlite3_bind_int(stmt, 1, cardId);
+            success = sqlite3_step(stmt) == SQLITE_DONE && sqlite3_changes(handle_) == 1;
+            sqlite3_finalize(stmt);
+            if (!success) break;
+        }
+
+        if (!success)
+        {
+            spdlog::error("Failed to restore archived card {}", cardId);
+            exec("ROLLBACK;");
+            return false;
+        }
+        return exec("COMMIT;");
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <chrono>
+#include <string>
+
+#include "sqlite3.h"
+
+namespace todo {
+    class CardDatabase;
+
+    // Moves cold cards out of the hot `cards` table into an ATTACHed archive database:
+    // Done cards older than `archive_after_days` (app_metadata, default 30) and every card
+    // of an ARCHIVED project. Work is done in small batched transactions from update(), so
+    // the writer connection is never held for long and the hot table and its indexes stay
+    // small. Archived cards keep their own FTS index and can be restored by id.
+    class CardArchiver
+    {
+    public:
+        static constexpr const char *kSchema = "archive";
+
+        CardArchiver(CardDatabase &db, const std::string &archivePath);
+
+        CardArchiver(const CardArchiver &) = delete;
+        CardArchiver &operator=(const CardArchiver &) = delete;
+
+        // Runs at most one batch per call when archiving is due. Call once per frame.
+        // Returns the number of cards moved out of the hot table.
+        int update();
+
+        // Moves up to `batchSize` cards: copied into the archive in one transaction, then deleted
+        // from main in another. Returns the number moved, or -1 on error.
+        int archiveBatch(int batchSize);
+
+        // Moves an archived card back into `cards`. It is exempt from archiving for another full period.
+        bool restoreCard(int cardId);
+
+        // After main was restored from a backup: drops rows the archive already holds and moves
+        // the card id counters past the archive's ids, so new cards never reuse an archived id
+        bool reconcileRestored();
+
+        [[nodiscard]] bool isAttached() const { return attached_; }
+        [[nodiscard]] bool isDraining() const { return draining_; }
+        // Whether the next update() runs a batch
+        [[nodiscard]] bool isDue() const
+        {
+            return attached_ && (draining_ || std::chrono::steady_clock::now() >= nextRun_);
+        }
+        [[nodiscard]] int archiveAfterDays() const;
+        void setArchiveAfterDays(int days);
+
+    private:
+        void attach(const std::string &archivePath);
+        // Deletes main's copy of each id from `candidates` (a SELECT of ids) that is in the
+        // archive, in a transaction of its own. Returns the number deleted, or -1 on error.
+        int removeArchivedFromMain(const char *candidates) const;
+        bool exec(const char *sql) const;
+
+        CardDatabase &db_;
+        sqlite3 *handle_ = nullptr;
+        bool attached_ = false;
+
+        static constexpr int kBatchSize = 500;
+        std::chrono::minutes interval_{10};
+        std::chrono::steady_clock::time_point nextRun_;
+        bool draining_ = false;
+    };
+}
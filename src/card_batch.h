@@ -0,0 +1,80 @@
+#pragma once
+#include <span>
+#include <string>
+#include <vector>
+
+#include "todo_card.h"
+
+namespace todo {
+    struct CardMutation
+    {
+        enum class Kind
+        {
+            Insert, // title, description, status, projectId; sequence < 0 appends to the end of the board
+            Update, // every column of the card with this id
+            Move, // status, sequence and completedAt of the card with this id
+            Delete, // only id is used
+            Restore // like Insert, but keeps the card's id, sequence and timestamps (undo of a delete)
+        };
+
+        Kind kind = Kind::Update;
+        TodoCard card;
+    };
+
+    // Collects mutations for CardDatabase::applyBatch, which runs them in one transaction
+    class CardBatch
+    {
+    public:
+        CardBatch &insert(std::string title, std::string description, CardStatus status, int projectId,
+                          int sequence = -1)
+        {
+            mutations_.push_back({
+                CardMutation::Kind::Insert,
+                TodoCard(-1, std::move(title), std::move(description), status, sequence, projectId)
+            });
+            return *this;
+        }
+
+        // Inserts a fully populated card (created/completed timestamps included); its id is ignored
+        CardBatch &insert(TodoCard card)
+        {
+            mutations_.push_back({CardMutation::Kind::Insert, std::move(card)});
+            return *this;
+        }
+
+        CardBatch &update(const TodoCard &card)
+        {
+            mutations_.push_back({CardMutation::Kind::Update, card});
+            return *this;
+        }
+
+        CardBatch &move(const TodoCard &card)
+        {
+            mutations_.push_back({CardMutation::Kind::Move, card});
+            return *this;
+        }
+
+        CardBatch &restore(const TodoCard &card)
+        {
+            mutations_.push_back({CardMutation::Kind::Restore, card});
+            return *this;
+        }
+
+        CardBatch &remove(const int cardId)
+        {
+            TodoCard card;
+            card.id = cardId;
+            mutations_.push_back({CardMutation::Kind::Delete, std::move(card)});
+            return *this;
+        }
+
+        void reserve(const size_t count) { mutations_.reserve(count); }
+        void clear() { mutations_.clear(); }
+        [[nodiscard]] bool empty() const { return mutations_.empty(); }
+        [[nodiscard]] size_t size() const { return mutations_.size(); }
+        [[nodiscard]] std::span<const CardMutation> mutations() const { return mutations_; }
+
+    private:
+        std::vector<CardMutation> mutations_;
+    };
+}
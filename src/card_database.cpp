@@ -4,14 +4,97 @@
 
 #include "card_database.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <objc/objc.h>
+#include <thread>
 
 #include "imgui_renderer.h"
 #include "project.h"
 #include "todo_card.h"
+#include "trace.h"
 #include "spdlog/spdlog.h"
 
 namespace todo {
+    // Kept separate so applyBatch can suspend it for bulk inserts and recreate it verbatim
+    static constexpr const char *kSearchInsertTrigger = R"(
+            CREATE TRIGGER IF NOT EXISTS cards_fts_insert AFTER INSERT ON cards BEGIN
+                INSERT INTO cards_fts(rowid, title, description)
+                VALUES (new.id, new.title, new.description);
+            END;
+        )";
+
+    // Shared by v9, which creates the history, and v11, which replaces the trigger in databases
+    // migrated before it stamped the card's own times. A card created Done (import, sync) gets
+    // its creation as Todo and the completion at completed_at, like the v9 seed; restored cards
+    // (undo, unarchive) already have their creation logged.
+    static constexpr const char *kCardEventsInsertTrigger = R"(
+            CREATE TRIGGER IF NOT EXISTS card_events_insert AFTER INSERT ON cards
+            WHEN NOT EXISTS (SELECT 1 FROM card_events WHERE card_id = new.id) BEGIN
+                INSERT INTO card_events (card_id, project, from_status, to_status, at)
+                VALUES (new.id, IFNULL(new.project, 0), NULL,
+                        CASE WHEN new.status = 2 AND julianday(new.completed_at) IS NOT NULL THEN 0
+                             ELSE new.status END,
+                        CASE WHEN julianday(new.created_at) IS NOT NULL THEN new.created_at
+                             ELSE CURRENT_TIMESTAMP END);
+                INSERT INTO card_events (card_id, project, from_status, to_status, at)
+                SELECT new.id, IFNULL(new.project, 0), 0, 2, new.completed_at
+                WHERE new.status = 2 AND julianday(new.completed_at) IS NOT NULL;
+            END;
+        )";
+
+    // Cards already In Progress when the history starts; when they were started is not stored,
+    // so the start is put at creation, the same point cycle time falls back to without one
+    static constexpr const char *kSeedStartedEvents = R"(
+            INSERT INTO card_events (card_id, project, from_status, to_status, at)
+            SELECT id, IFNULL(project, 0), 0, 1, IFNULL(created_at, CURRENT_TIMESTAMP) FROM cards
+            WHERE status = 1 AND julianday(IFNULL(created_at, CURRENT_TIMESTAMP)) IS NOT NULL
+              AND NOT EXISTS (SELECT 1 FROM card_events e WHERE e.card_id = cards.id AND e.to_status = 1);
+        )";
+
+    // Busy backoff: 1, 2, 4 ... ms per retry, capped per wait and in total (the handler's
+    // context is the connection's total budget in ms)
+    static constexpr int kBusyMaxDelayMs = 50;
+
+    static int busyBackoff(void *budget, const int retries)
+    {
+        const int maxTotalMs = static_cast<int>(reinterpret_cast<std::intptr_t>(budget));
+        int waited = 0;
+        for (int i = 0; i < retries; i++) waited += std::min(1 << std::min(i, 16), kBusyMaxDelayMs);
+        if (waited >= maxTotalMs)
+        {
+            if (maxTotalMs >= CardDatabase::kBusyMaxTotalMs)
+            {
+                spdlog::warn("Database still locked by another connection after {} ms; giving up", waited);
+            }
+            return 0;
+        }
+
+        const int delay = std::min({1 << std::min(retries, 16), kBusyMaxDelayMs, maxTotalMs - waited});
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+        return 1;
+    }
+
+    // Columns read by cardFromRow, starting at its `first` column
+    static constexpr const char *kCardColumns =
+            "c.id, c.title, c.description, c.status, c.sequence, IFNULL(c.project,0), CAST(c.created_at AS TEXT),"
+            " IFNULL(CAST(c.completed_at AS TEXT), '')";
+
+    static TodoCard cardFromRow(sqlite3_stmt *stmt, const int first)
+    {
+        return TodoCard(
+            sqlite3_column_int(stmt, first),
+            reinterpret_cast<const char *>(sqlite3_column_text(stmt, first + 1)),
+            reinterpret_cast<const char *>(sqlite3_column_text(stmt, first + 2)),
+            intToStatus(sqlite3_column_int(stmt, first + 3)),
+            sqlite3_column_int(stmt, first + 4),
+            sqlite3_column_int(stmt, first + 5),
+            (sqlite3_column_text(stmt, first + 6)),
+            (sqlite3_column_text(stmt, first + 7))
+        );
+    }
+
     void CardDatabase::createTablesIfNotExist()
     {
         // Create Cards Table
@@ -59,7 +142,7 @@ namespace todo {
     {
         // Check current database version
         int currentVersion = getDatabaseVersion();
-        const int TARGET_VERSION = 4; // Increment when you make schema changes
+        const int TARGET_VERSION = 11; // Increment when you make schema changes
 
         if (currentVersion < TARGET_VERSION)
         {
@@ -97,8 +180,11 @@ namespace todo {
 
     void CardDatabase::migrateDatabaseToVersion(int targetVersion)
     {
+        TRACE_SCOPE("CardDatabase::migrateDatabaseToVersion");
+        const int currentVersion = getDatabaseVersion();
+
         // Apply migrations based on target version
-        spdlog::info("Migrating database to version {}", targetVersion);
+        spdlog::info("Migrating database from version {} to version {}", currentVersion, targetVersion);
         if (targetVersion >= 1)
         {
             spdlog::info("Migration in progress...");
@@ -111,6 +197,69 @@ namespace todo {
             sqlite3_exec(db_, "ALTER TABLE cards ADD COLUMN completed_at TIMESTAMP NULL", nullptr, nullptr, nullptr);
         }
 
+        if (currentVersion < 5 && targetVersion >= 5)
+        {
+            // v5
+            createSearchIndex();
+        }
+
+        if (currentVersion < 6 && targetVersion >= 6)
+        {
+            // v6: archiving support. projects.status was never added by the v2/v3 migration
+            // on fresh databases, and the archiver needs it; ignore the error where it exists.
+            sqlite3_exec(db_, "ALTER TABLE projects ADD COLUMN status INTEGER DEFAULT 0", nullptr, nullptr, nullptr);
+            sqlite3_exec(db_, "ALTER TABLE cards ADD COLUMN restored_at TIMESTAMP NULL", nullptr, nullptr, nullptr);
+
+            // Lets the archiver find old Done cards without scanning the whole table
+            const char *sql = "CREATE INDEX IF NOT EXISTS idx_cards_status_completed ON cards(status, completed_at);";
+            char *err = nullptr;
+            if (sqlite3_exec(db_, sql, nullptr, nullptr, &err) != SQLITE_OK)
+            {
+                std::string msg = err;
+                sqlite3_free(err);
+                throw std::runtime_error("DB index error: " + msg);
+            }
+        }
+
+        if (currentVersion < 7 && targetVersion >= 7)
+        {
+            // v7: change log for live reload across connections and processes
+            createChangeLog();
+        }
+
+        if (currentVersion < 8 && targetVersion >= 8)
+        {
+            // v8: undo/redo journal
+            createOperationJournal();
+        }
+
+        if (currentVersion < 9 && targetVersion >= 9)
+        {
+            // v9: status history and daily rollups
+            createCardHistory();
+        }
+
+        if (currentVersion < 10 && targetVersion >= 10)
+        {
+            // v10: cycle-time percentile sketches
+            createCycleTimeSketches();
+        }
+
+        if (currentVersion < 11 && targetVersion >= 11)
+        {
+            // v11: creation events at created_at, a completion event for cards created Done, and
+            // start events for cards that were In Progress when v9 seeded the history
+            const std::string sql = std::string("DROP TRIGGER IF EXISTS card_events_insert;") +
+                                    kCardEventsInsertTrigger + kSeedStartedEvents;
+            char *err = nullptr;
+            if (sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, &err) != SQLITE_OK)
+            {
+                const std::string msg = err;
+                sqlite3_free(err);
+                throw std::runtime_error("DB history error: " + msg);
+            }
+        }
+
         // Update version
         const char *updateVersionSQL = R"(
             INSERT OR REPLACE INTO app_metadata (key, value)
@@ -128,64 +277,253 @@ namespace todo {
         spdlog::info("Migration complete!");
     }
 
-    bool CardDatabase::addProject(const std::string &projectName, const int &projectStatus)
+    void CardDatabase::createSearchIndex()
     {
-        // SQL query to fetch the next sequence value
-        const char *sql = "INSERT INTO projects (name, status) VALUES (?, ?);";
+        // External-content FTS5 index: the text lives in `cards`, the index only stores tokens.
+        // prefix='2 3' keeps the "type-as-you-search" prefix queries on the fast path.
+        const std::string schema = std::string(R"(
+            CREATE VIRTUAL TABLE IF NOT EXISTS cards_fts USING fts5(
+                title,
+                description,
+                content = 'cards',
+                content_rowid = 'id',
+                prefix = '2 3',
+                tokenize = 'unicode61 remove_diacritics 2'
+            );
+        )") + kSearchInsertTrigger + R"(
+            CREATE TRIGGER IF NOT EXISTS cards_fts_delete AFTER DELETE ON cards BEGIN
+                INSERT INTO cards_fts(cards_fts, rowid, title, description)
+                VALUES ('delete', old.id, old.title, old.description);
+            END;
 
-        sqlite3_stmt *stmt = nullptr;
-        if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK)
+            CREATE TRIGGER IF NOT EXISTS cards_fts_update AFTER UPDATE OF title, description ON cards BEGIN
+                INSERT INTO cards_fts(cards_fts, rowid, title, description)
+                VALUES ('delete', old.id, old.title, old.description);
+                INSERT INTO cards_fts(rowid, title, description)
+                VALUES (new.id, new.title, new.description);
+            END;
+
+            -- Title matches outweigh description matches when ordering by rank
+            INSERT INTO cards_fts(cards_fts, rank) VALUES ('rank', 'bm25(10.0, 1.0)');
+
+            -- Index the cards that existed before the triggers did
+            INSERT INTO cards_fts(cards_fts) VALUES ('rebuild');
+        )";
+
+        char *err = nullptr;
+        if (sqlite3_exec(db_, schema.c_str(), nullptr, nullptr, &err) != SQLITE_OK)
         {
-            spdlog::error("SQL error: {}", sqlite3_errmsg(db_));
-            return false;
+            const std::string msg = err;
+            sqlite3_free(err);
+            throw std::runtime_error("DB search index error: " + msg);
         }
-        sqlite3_bind_text(stmt, 1, projectName.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_int(stmt, 2, projectStatus);
-        bool success = (sqlite3_step(stmt) == SQLITE_DONE);
-        sqlite3_finalize(stmt);
-        return success;
     }
 
-    CardDatabase::CardDatabase(const std::string &dbPath)
+    void CardDatabase::createChangeLog()
     {
-        if (sqlite3_open(dbPath.c_str(), &db_) != SQLITE_OK)
-            throw std::runtime_error("Failed to open database");
+        // One row per card write, whoever made it. Other windows read the entries past their
+        // cursor and reload just those cards; whether a card was deleted is decided by whether
+        // it still exists, so the triggers do not need to record it. AUTOINCREMENT keeps seq
+        // from being reused once old entries are pruned.
+        const char *schema = R"(
+            CREATE TABLE IF NOT EXISTS card_changes (
+                seq INTEGER PRIMARY KEY AUTOINCREMENT,
+                card_id INTEGER NOT NULL
+            );
 
-        // Check if tables exist, create if they don't
-        createTablesIfNotExist();
+            CREATE TRIGGER IF NOT EXISTS card_changes_insert AFTER INSERT ON cards BEGIN
+                INSERT INTO card_changes(card_id) VALUES (new.id);
+            END;
 
-        // Handle database migrations/updates
-        updateDatabaseSchema();
+            CREATE TRIGGER IF NOT EXISTS card_changes_update AFTER UPDATE ON cards BEGIN
+                INSERT INTO card_changes(card_id) VALUES (new.id);
+            END;
+
+            CREATE TRIGGER IF NOT EXISTS card_changes_delete AFTER DELETE ON cards BEGIN
+                INSERT INTO card_changes(card_id) VALUES (old.id);
+            END;
+        )";
+
+        char *err = nullptr;
+        if (sqlite3_exec(db_, schema, nullptr, nullptr, &err) != SQLITE_OK)
+        {
+            const std::string msg = err;
+            sqlite3_free(err);
+            throw std::runtime_error("DB change log error: " + msg);
+        }
     }
 
-    CardDatabase::~CardDatabase()
+    void CardDatabase::createOperationJournal()
     {
-        // Close Connectins
-        if (db_) sqlite3_close(db_);
+        // One entry per user action (OperationJournal). Changes hold only the fields that
+        // differed, encoded as compact blobs; a NULL `before` means the action created the card,
+        // a NULL `after` that it deleted it. Entries with undone = 1 form the redo stack.
+        const char *schema = R"(
+            CREATE TABLE IF NOT EXISTS journal (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                label TEXT NOT NULL,
+                undone INTEGER NOT NULL DEFAULT 0,
+                created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+            );
+
+            CREATE TABLE IF NOT EXISTS journal_changes (
+                entry INTEGER NOT NULL,
+                card_id INTEGER NOT NULL,
+                before BLOB,
+                after BLOB
+            );
+
+            CREATE INDEX IF NOT EXISTS idx_journal_changes_entry ON journal_changes(entry);
+        )";
+
+        char *err = nullptr;
+        if (sqlite3_exec(db_, schema, nullptr, nullptr, &err) != SQLITE_OK)
+        {
+            const std::string msg = err;
+            sqlite3_free(err);
+            throw std::runtime_error("DB journal error: " + msg);
+        }
     }
 
-    bool CardDatabase::addCard(const std::string &title, const std::string &desc, const int &status,
-                               const int sequence, const int &project) const
+    void CardDatabase::createCardHistory()
     {
-        // SQL query to fetch the next sequence value
-        const char *selectSql = "SELECT MAX(sequence) + 1 AS next_sequence FROM cards";
+        // card_events logs every status transition, written by triggers in the same transaction
+        // as the change itself. project_daily_stats rolls them up per project and UTC day as
+        // they are logged, so dashboards read one row per day instead of aggregating events.
+        // Cycle time runs from the last move to In Progress (or creation, for cards never
+        // started) to Done, and is booked on the day the card is completed.
+        const std::string schema = std::string(R"(
+            CREATE TABLE IF NOT EXISTS card_events (
+                id INTEGER PRIMARY KEY,
+                card_id INTEGER NOT NULL,
+                project INTEGER NOT NULL DEFAULT 0,
+                from_status INTEGER,
+                to_status INTEGER NOT NULL,
+                at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP
+            );
+
+            CREATE INDEX IF NOT EXISTS idx_card_events_card ON card_events(card_id, to_status);
+
+            CREATE TABLE IF NOT EXISTS project_daily_stats (
+                project INTEGER NOT NULL,
+                day TEXT NOT NULL,
+                created INTEGER NOT NULL DEFAULT 0,
+                started INTEGER NOT NULL DEFAULT 0,
+                completed INTEGER NOT NULL DEFAULT 0,
+                cycle_seconds INTEGER NOT NULL DEFAULT 0,
+                PRIMARY KEY (project, day)
+            ) WITHOUT ROWID;
+        )") + kCardEventsInsertTrigger + R"(
+            CREATE TRIGGER IF NOT EXISTS card_events_status AFTER UPDATE OF status ON cards
+            WHEN old.status IS NOT new.status BEGIN
+                INSERT INTO card_events (card_id, project, from_status, to_status)
+                VALUES (new.id, IFNULL(new.project, 0), old.status, new.status);
+            END;
+
+            CREATE TRIGGER IF NOT EXISTS project_daily_stats_rollup AFTER INSERT ON card_events BEGIN
+                INSERT INTO project_daily_stats (project, day, created, started, completed, cycle_seconds)
+                VALUES (
+                    new.project,
+                    date(new.at),
+                    new.from_status IS NULL,
+                    new.to_status = 1,
+                    new.to_status = 2,
+                    CASE WHEN new.to_status = 2 THEN MAX(0, CAST(ROUND((julianday(new.at) - julianday(COALESCE(
+                        (SELECT MAX(at) FROM card_events
+                         WHERE card_id = new.card_id AND to_status = 1 AND id < new.id),
+                        (SELECT MIN(at) FROM card_events WHERE card_id = new.card_id),
+                        new.at))) * 86400) AS INTEGER)) ELSE 0 END)
+                ON CONFLICT (project, day) DO UPDATE SET
+                    created = created + excluded.created,
+                    started = started + excluded.started,
+                    completed = completed + excluded.completed,
+                    cycle_seconds = cycle_seconds + excluded.cycle_seconds;
+            END;
+
+            -- Seed the history of existing cards from what the cards table still knows
+            INSERT INTO card_events (card_id, project, from_status, to_status, at)
+            SELECT id, IFNULL(project, 0), NULL, 0, IFNULL(created_at, CURRENT_TIMESTAMP) FROM cards
+            WHERE NOT EXISTS (SELECT 1 FROM card_events);
+
+            INSERT INTO card_events (card_id, project, from_status, to_status, at)
+            SELECT id, IFNULL(project, 0), 0, 2, completed_at FROM cards
+            WHERE status = 2 AND julianday(completed_at) IS NOT NULL
+              AND NOT EXISTS (SELECT 1 FROM card_events WHERE to_status = 2);
+        )" + kSeedStartedEvents;
+
+        char *err = nullptr;
+        if (sqlite3_exec(db_, schema.c_str(), nullptr, nullptr, &err) != SQLITE_OK)
+        {
+            const std::string msg = err;
+            sqlite3_free(err);
+            throw std::runtime_error("DB history error: " + msg);
+        }
+    }
+
+    void CardDatabase::createCycleTimeSketches()
+    {
+        // Serialized t-digests per project and metric (CycleTimeSketches), maintained from
+        // card_events. They start out empty and are rebuilt from the history on first use.
+        const char *schema = R"(
+            CREATE TABLE IF NOT EXISTS cycle_time_sketches (
+                project INTEGER NOT NULL,
+                metric INTEGER NOT NULL,
+                digest BLOB NOT NULL,
+                PRIMARY KEY (project, metric)
+            ) WITHOUT ROWID;
+        )";
+
+        char *err = nullptr;
+        if (sqlite3_exec(db_, schema, nullptr, nullptr, &err) != SQLITE_OK)
+        {
+            const std::string msg = err;
+            sqlite3_free(err);
+            throw std::runtime_error("DB sketch error: " + msg);
+        }
+    }
 
-        sqlite3_stmt *selectStmt = nullptr;
-        if (sqlite3_prepare_v2(db_, selectSql, -1, &selectStmt, nullptr) != SQLITE_OK)
+    std::string CardDatabase::getMetadata(const std::string &key, const std::string &defaultValue) const
+    {
+        const char *sql = "SELECT value FROM app_metadata WHERE key = ?;";
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK)
         {
             spdlog::error("SQL error: {}", sqlite3_errmsg(db_));
-            return false;
+            return defaultValue;
         }
+        sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_TRANSIENT);
 
-        // Execute the SELECT statement
-        int nextSequence = -1;
-        while (sqlite3_step(selectStmt) == SQLITE_ROW)
+        std::string value = defaultValue;
+        if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_text(stmt, 0))
         {
-            nextSequence = sqlite3_column_int(selectStmt, 0);
+            value = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
         }
+        sqlite3_finalize(stmt);
+        return value;
+    }
+
+    bool CardDatabase::setMetadata(const std::string &key, const std::string &value) const
+    {
+        const char *sql = "INSERT OR REPLACE INTO app_metadata (key, value) VALUES (?, ?);";
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(db_));
+            return false;
+        }
+        sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, value.c_str(), -1, SQLITE_TRANSIENT);
+        bool success = (sqlite3_step(stmt) == SQLITE_DONE);
+        sqlite3_finalize(stmt);
+        return success;
+    }
+
+    bool CardDatabase::addProject(const std::string &projectName, const int &projectStatus, int *newId)
+    {
+        const sqlite3_int64 id = idFloor_ > 0 ? reserveIds("sync_last_project_id", 1) : 0;
+        if (idFloor_ > 0 && id == 0) return false;
 
-        // SQL query with a CTE and INSERT statement
-        const char *sql = "INSERT INTO cards (title, description, status, sequence, project) VALUES (?, ?, ?, ?, ?);";
+        const char *sql = "INSERT INTO projects (id, name, status) VALUES (?, ?, ?);";
 
         sqlite3_stmt *stmt = nullptr;
         if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK)
@@ -193,16 +531,51 @@ namespace todo {
             spdlog::error("SQL error: {}", sqlite3_errmsg(db_));
             return false;
         }
-        sqlite3_bind_text(stmt, 1, title.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 2, desc.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_int(stmt, 3, status);
-        sqlite3_bind_int(stmt, 4, nextSequence);
-        sqlite3_bind_int(stmt, 5, project);
+        if (id > 0) sqlite3_bind_int64(stmt, 1, id);
+        else sqlite3_bind_null(stmt, 1);
+        sqlite3_bind_text(stmt, 2, projectName.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 3, projectStatus);
         bool success = (sqlite3_step(stmt) == SQLITE_DONE);
         sqlite3_finalize(stmt);
+        if (success && newId) *newId = static_cast<int>(sqlite3_last_insert_rowid(db_));
         return success;
     }
 
+    CardDatabase::CardDatabase(const std::string &dbPath)
+    {
+        TRACE_SCOPE("CardDatabase::CardDatabase");
+        if (sqlite3_open(dbPath.c_str(), &db_) != SQLITE_OK)
+            throw std::runtime_error("Failed to open database");
+
+        // Another window, the import thread or a script may hold the write lock
+        installBusyHandler(db_);
+
+        // WAL lets the read-only worker connections (DatabaseReader) query a snapshot
+        // while this connection writes, instead of readers and the writer blocking each other.
+        // synchronous=NORMAL is durable across app crashes in WAL mode and avoids an fsync per commit.
+        char *err = nullptr;
+        if (sqlite3_exec(db_, "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;", nullptr, nullptr, &err) != SQLITE_OK)
+        {
+            spdlog::warn("Failed to enable WAL mode: {}", err ? err : "unknown error");
+            sqlite3_free(err);
+        }
+
+        // Check if tables exist, create if they don't
+        createTablesIfNotExist();
+
+        // Handle database migrations/updates
+        updateDatabaseSchema();
+
+        // Set once this copy of the board joins a sync folder (BoardSync)
+        const std::string device = getMetadata("sync_device");
+        if (!device.empty()) useDeviceIdRange(std::stoi(device));
+    }
+
+    CardDatabase::~CardDatabase()
+    {
+        // Close Connectins
+        if (db_) sqlite3_close(db_);
+    }
 
     bool CardDatabase::updateCard(TodoCard &card) const
     {
@@ -246,15 +619,252 @@ namespace todo {
         return success;
     }
 
+    bool CardDatabase::applyBatch(const std::span<const CardMutation> mutations, std::vector<int> *insertedIds,
+                                  const bool bulkIndex) const
+    {
+        if (mutations.empty()) return true;
+
+        // Indexed by CardMutation::Kind; each is prepared on first use and reused for the rest of the batch
+        const char *sqls[] = {
+            "INSERT INTO cards (id, title, description, status, sequence, project, created_at, completed_at) "
+            "VALUES (?, ?, ?, ?, ?, ?, COALESCE(?, CURRENT_TIMESTAMP), ?);",
+            "UPDATE cards SET title = ?, description = ?, status = ?, sequence = ?, project = ?, completed_at = ? "
+            "WHERE id = ?;",
+            "UPDATE cards SET status = ?, sequence = ?, completed_at = ? WHERE id = ?;",
+            "DELETE FROM cards WHERE id = ?;",
+            "INSERT INTO cards (id, title, description, status, sequence, project, created_at, completed_at) "
+            "VALUES (?, ?, ?, ?, ?, ?, COALESCE(?, CURRENT_TIMESTAMP), ?);"
+        };
+        sqlite3_stmt *stmts[std::size(sqls)] = {};
+
+        const size_t insertedBefore = insertedIds ? insertedIds->size() : 0;
+        sqlite3_int64 firstInserted = 0, lastInserted = -1;
+
+        // Inside a caller's transaction (e.g. a whole import) the batch becomes a savepoint
+        const bool nested = sqlite3_get_autocommit(db_) == 0;
+        const char *beginSql = nested ? "SAVEPOINT apply_batch;" : "BEGIN IMMEDIATE;";
+        const char *commitSql = nested ? "RELEASE apply_batch;" : "COMMIT;";
+        const char *rollbackSql = nested ? "ROLLBACK TO apply_batch; RELEASE apply_batch;" : "ROLLBACK;";
+
+        auto finish = [&](bool commit)
+        {
+            for (sqlite3_stmt *stmt: stmts) sqlite3_finalize(stmt);
+            if (commit && bulkIndex && !reindexInserted(firstInserted, lastInserted))
+            {
+                commit = false;
+            }
+            if (commit && sqlite3_exec(db_, commitSql, nullptr, nullptr, nullptr) != SQLITE_OK)
+            {
+                spdlog::error("SQL error: {}", sqlite3_errmsg(db_));
+                commit = false;
+            }
+            if (!commit)
+            {
+                sqlite3_exec(db_, rollbackSql, nullptr, nullptr, nullptr);
+                if (insertedIds) insertedIds->resize(insertedBefore);
+            }
+            return commit;
+        };
+
+        if (sqlite3_exec(db_, beginSql, nullptr, nullptr, nullptr) != SQLITE_OK)
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(db_));
+            return false;
+        }
+
+        // Indexing row by row through the trigger costs several times more than one
+        // INSERT ... SELECT at the end. DDL is transactional, so a failed batch restores it.
+        if (bulkIndex && sqlite3_exec(db_, "DROP TRIGGER IF EXISTS cards_fts_insert;", nullptr, nullptr, nullptr) !=
+            SQLITE_OK)
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(db_));
+            return finish(false);
+        }
+
+        // One lookup for the whole batch; appended cards then count up from here in-process
+        int nextSequence = 0;
+        const bool appends = std::ranges::any_of(mutations, [](const CardMutation &m)
+        {
+            return m.kind == CardMutation::Kind::Insert && m.card.sequence < 0;
+        });
+        if (appends)
+        {
+            sqlite3_stmt *stmt = nullptr;
+            if (sqlite3_prepare_v2(db_, "SELECT IFNULL(MAX(sequence) + 1, 0) FROM cards;", -1, &stmt, nullptr) ==
+                SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW)
+            {
+                nextSequence = sqlite3_column_int(stmt, 0);
+            }
+            sqlite3_finalize(stmt);
+        }
+
+        // Synced boards take ids from this device's range (see useDeviceIdRange), reserved once per batch
+        sqlite3_int64 nextId = 0;
+        if (idFloor_ > 0)
+        {
+            const auto inserts = std::ranges::count_if(mutations, [](const CardMutation &m)
+            {
+                return m.kind == CardMutation::Kind::Insert;
+            });
+            if (inserts > 0 && (nextId = reserveIds("sync_last_card_id", static_cast<int>(inserts))) == 0)
+            {
+                return finish(false);
+            }
+        }
+
+        auto bindOptionalText = [](sqlite3_stmt *stmt, const int index, const std::string &value)
+        {
+            if (value.empty()) sqlite3_bind_null(stmt, index);
+            else sqlite3_bind_text(stmt, index, value.c_str(), -1, SQLITE_STATIC);
+        };
+
+        for (const auto &mutation: mutations)
+        {
+            const auto kind = static_cast<size_t>(mutation.kind);
+            sqlite3_stmt *&stmt = stmts[kind];
+            if (!stmt && sqlite3_prepare_v2(db_, sqls[kind], -1, &stmt, nullptr) != SQLITE_OK)
+            {
+                spdlog::error("SQL error: {}", sqlite3_errmsg(db_));
+                return finish(false);
+            }
+
+            // The card outlives the step, so text can be bound without copying
+            const TodoCard &card = mutation.card;
+            switch (mutation.kind)
+            {
+                case CardMutation::Kind::Insert:
+                case CardMutation::Kind::Restore:
+                    if (mutation.kind == CardMutation::Kind::Restore) sqlite3_bind_int(stmt, 1, card.id);
+                    else if (nextId > 0) sqlite3_bind_int64(stmt, 1, nextId++);
+                    else sqlite3_bind_null(stmt, 1);
+                    sqlite3_bind_text(stmt, 2, card.title.c_str(), -1, SQLITE_STATIC);
+                    sqlite3_bind_text(stmt, 3, card.description.c_str(), -1, SQLITE_STATIC);
+                    sqlite3_bind_int(stmt, 4, statusToInt(card.status));
+                    sqlite3_bind_int(stmt, 5, card.sequence < 0 ? nextSequence++ : card.sequence);
+                    sqlite3_bind_int(stmt, 6, card.projectId);
+                    bindOptionalText(stmt, 7, card.createdAt);
+                    bindOptionalText(stmt, 8, card.completedAt);
+                    break;
+                case CardMutation::Kind::Update:
+                    sqlite3_bind_text(stmt, 1, card.title.c_str(), -1, SQLITE_STATIC);
+                    sqlite3_bind_text(stmt, 2, card.description.c_str(), -1, SQLITE_STATIC);
+                    sqlite3_bind_int(stmt, 3, statusToInt(card.status));
+                    sqlite3_bind_int(stmt, 4, card.sequence);
+                    sqlite3_bind_int(stmt, 5, card.projectId);
+                    sqlite3_bind_text(stmt, 6, card.completedAt.c_str(), -1, SQLITE_STATIC);
+                    sqlite3_bind_int(stmt, 7, card.id);
+                    break;
+                case CardMutation::Kind::Move:
+                    sqlite3_bind_int(stmt, 1, statusToInt(card.status));
+                    sqlite3_bind_int(stmt, 2, card.sequence);
+                    sqlite3_bind_text(stmt, 3, card.completedAt.c_str(), -1, SQLITE_STATIC);
+                    sqlite3_bind_int(stmt, 4, card.id);
+                    break;
+                case CardMutation::Kind::Delete:
+                    sqlite3_bind_int(stmt, 1, card.id);
+                    break;
+            }
+
+            if (sqlite3_step(stmt) != SQLITE_DONE)
+            {
+                spdlog::error("Batch mutation failed for card {}: {}", card.id, sqlite3_errmsg(db_));
+                return finish(false);
+            }
+            sqlite3_reset(stmt);
+            sqlite3_clear_bindings(stmt);
+
+            if (mutation.kind == CardMutation::Kind::Insert)
+            {
+                const sqlite3_int64 rowId = sqlite3_last_insert_rowid(db_);
+                if (lastInserted < firstInserted) firstInserted = rowId;
+                lastInserted = rowId;
+                if (insertedIds) insertedIds->push_back(static_cast<int>(rowId));
+            }
+        }
+
+        return finish(true);
+    }
+
+    void CardDatabase::useDeviceIdRange(const int device)
+    {
+        idFloor_ = device > 0 ? sqlite3_int64{device} * kIdsPerDevice : 0;
+    }
+
+    sqlite3_int64 CardDatabase::reserveIds(const char *counterKey, const int count) const
+    {
+        // A single statement, so two writers on the same device never hand out the same ids
+        const char *sql = "INSERT INTO app_metadata (key, value) VALUES (?1, ?2 + ?3) "
+                "ON CONFLICT(key) DO UPDATE SET value = CAST(value AS INTEGER) + ?3 "
+                "RETURNING CAST(value AS INTEGER);";
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(db_));
+            return 0;
+        }
+        sqlite3_bind_text(stmt, 1, counterKey, -1, SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 2, idFloor_ - 1);
+        sqlite3_bind_int(stmt, 3, count);
+
+        sqlite3_int64 last = 0;
+        if (sqlite3_step(stmt) == SQLITE_ROW) last = sqlite3_column_int64(stmt, 0);
+        else spdlog::error("Failed to reserve ids: {}", sqlite3_errmsg(db_));
+        sqlite3_finalize(stmt);
+
+        if (last >= idFloor_ + kIdsPerDevice)
+        {
+            spdlog::error("Id range of this device is exhausted");
+            return 0;
+        }
+        return last > 0 ? last - count + 1 : 0;
+    }
+
+    bool CardDatabase::reindexInserted(const sqlite3_int64 firstId, const sqlite3_int64 lastId) const
+    {
+        // Ids only grow (AUTOINCREMENT or the device range counter) and this connection holds
+        // the write lock, so the range covers exactly the rows inserted by the current batch
+        sqlite3_stmt *stmt = nullptr;
+        const char *sql = "INSERT INTO cards_fts(rowid, title, description) "
+                "SELECT id, title, description FROM cards WHERE id BETWEEN ? AND ?;";
+        if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(db_));
+            return false;
+        }
+        sqlite3_bind_int64(stmt, 1, firstId);
+        sqlite3_bind_int64(stmt, 2, lastId);
+        const bool indexed = sqlite3_step(stmt) == SQLITE_DONE;
+        sqlite3_finalize(stmt);
+
+        char *err = nullptr;
+        if (!indexed || sqlite3_exec(db_, kSearchInsertTrigger, nullptr, nullptr, &err) != SQLITE_OK)
+        {
+            spdlog::error("Failed to reindex inserted cards: {}", err ? err : sqlite3_errmsg(db_));
+            sqlite3_free(err);
+            return false;
+        }
+        return true;
+    }
+
     std::vector<proj::Project> CardDatabase::getAllProjects() const
+    {
+        return readAllProjects(db_);
+    }
+
+    std::vector<TodoCard> CardDatabase::getAllCards() const
+    {
+        return readAllCards(db_);
+    }
+
+    std::vector<proj::Project> CardDatabase::readAllProjects(sqlite3 *db)
     {
         std::vector<proj::Project> projects = {};
         const char *sql =
-                "SELECT id, name, created_at, status FROM projects ORDER BY id ASC;";
+                "SELECT id, name, IFNULL(status, 0), IFNULL(CAST(created_at AS TEXT), '') FROM projects ORDER BY id ASC;";
         sqlite3_stmt *stmt = nullptr;
-        if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK)
+        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK)
         {
-            spdlog::error("SQL error: {}", sqlite3_errmsg(db_));
+            spdlog::error("SQL error: {}", sqlite3_errmsg(db));
             return projects;
         }
         while (sqlite3_step(stmt) == SQLITE_ROW)
@@ -271,36 +881,199 @@ namespace todo {
         return projects;
     }
 
-    std::vector<TodoCard> CardDatabase::getAllCards() const
+    std::vector<TodoCard> CardDatabase::readAllCards(sqlite3 *db)
     {
         std::vector<TodoCard> cards;
-        const char *sql =
-                "SELECT id, title, description, status, sequence, IFNULL(project,0), CAST(created_at AS TEXT), IFNULL(CAST(completed_at AS TEXT), '')"
-                " FROM cards ORDER BY sequence ASC;";
+        const std::string sql = std::string("SELECT ") + kCardColumns + " FROM cards c ORDER BY c.sequence ASC;";
         sqlite3_stmt *stmt = nullptr;
-        if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK)
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
         {
-            spdlog::error("SQL error: {}", sqlite3_errmsg(db_));
+            spdlog::error("SQL error: {}", sqlite3_errmsg(db));
             return cards;
         }
         while (sqlite3_step(stmt) == SQLITE_ROW)
         {
-            TodoCard card(
-                sqlite3_column_int(stmt, 0),
-                reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1)),
-                reinterpret_cast<const char *>(sqlite3_column_text(stmt, 2)),
-                intToStatus(sqlite3_column_int(stmt, 3)),
-                sqlite3_column_int(stmt, 4),
-                sqlite3_column_int(stmt, 5),
-                (sqlite3_column_text(stmt, 6)),
-                (sqlite3_column_text(stmt, 7))
-            );
-            cards.push_back(card);
+            cards.push_back(cardFromRow(stmt, 0));
         }
         sqlite3_finalize(stmt);
         return cards;
     }
 
+    void CardDatabase::readAllCards(sqlite3 *db, const std::size_t chunkSize,
+                                    const std::function<void(std::vector<TodoCard> &&)> &chunk)
+    {
+        const std::string sql = std::string("SELECT ") + kCardColumns + " FROM cards c ORDER BY c.sequence ASC;";
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(db));
+            return;
+        }
+        std::vector<TodoCard> cards;
+        cards.reserve(chunkSize);
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            cards.push_back(cardFromRow(stmt, 0));
+            if (cards.size() < chunkSize) continue;
+            chunk(std::move(cards));
+            cards = {};
+            cards.reserve(chunkSize);
+        }
+        sqlite3_finalize(stmt);
+        if (!cards.empty()) chunk(std::move(cards));
+    }
+
+    std::vector<TodoCard> CardDatabase::readProjectCards(sqlite3 *db, const int projectId)
+    {
+        std::vector<TodoCard> cards;
+        const std::string sql = std::string("SELECT ") + kCardColumns +
+                                " FROM cards c WHERE c.project = ? ORDER BY c.sequence ASC;";
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(db));
+            return cards;
+        }
+        sqlite3_bind_int(stmt, 1, projectId);
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            cards.push_back(cardFromRow(stmt, 0));
+        }
+        sqlite3_finalize(stmt);
+        return cards;
+    }
+
+    std::vector<TodoCard> CardDatabase::readCards(sqlite3 *db, const std::span<const int> ids)
+    {
+        std::vector<TodoCard> cards;
+        const std::string sql = std::string("SELECT ") + kCardColumns + " FROM cards c WHERE c.id = ?;";
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(db));
+            return cards;
+        }
+
+        cards.reserve(ids.size());
+        for (const int id: ids)
+        {
+            sqlite3_bind_int(stmt, 1, id);
+            if (sqlite3_step(stmt) == SQLITE_ROW) cards.push_back(cardFromRow(stmt, 0));
+            sqlite3_reset(stmt);
+        }
+        sqlite3_finalize(stmt);
+        return cards;
+    }
+
+    std::vector<DailyStats> CardDatabase::readDailyStats(sqlite3 *db, const int days, const int projectId)
+    {
+        std::vector<DailyStats> stats;
+        const char *sql =
+                "SELECT day, SUM(created), SUM(started), SUM(completed), SUM(cycle_seconds) FROM project_daily_stats "
+                "WHERE day > date('now', '-' || ?1 || ' days') AND (?2 < 0 OR project = ?2) "
+                "GROUP BY day ORDER BY day;";
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(db));
+            return stats;
+        }
+        sqlite3_bind_int(stmt, 1, days);
+        sqlite3_bind_int(stmt, 2, projectId);
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            stats.push_back({
+                reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0)),
+                sqlite3_column_int(stmt, 1),
+                sqlite3_column_int(stmt, 2),
+                sqlite3_column_int(stmt, 3),
+                sqlite3_column_int64(stmt, 4)
+            });
+        }
+        sqlite3_finalize(stmt);
+        return stats;
+    }
+
+    std::int64_t CardDatabase::readChangeSeq(sqlite3 *db)
+    {
+        std::int64_t seq = 0;
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(db, "SELECT IFNULL(MAX(seq), 0) FROM card_changes;", -1, &stmt, nullptr) == SQLITE_OK &&
+            sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            seq = sqlite3_column_int64(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+        return seq;
+    }
+
+    CardDelta CardDatabase::readCardChanges(sqlite3 *db, const std::int64_t sinceSeq)
+    {
+        CardDelta delta;
+        delta.fromSeq = sinceSeq;
+        delta.toSeq = sinceSeq;
+
+        // One read transaction, so toSeq matches the rows returned
+        sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(db, "SELECT IFNULL(MIN(seq), 0), IFNULL(MAX(seq), 0) FROM card_changes;", -1, &stmt,
+                               nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            const std::int64_t oldest = sqlite3_column_int64(stmt, 0);
+            delta.toSeq = std::max<std::int64_t>(sinceSeq, sqlite3_column_int64(stmt, 1));
+            delta.complete = oldest == 0 || oldest <= sinceSeq + 1;
+        }
+        sqlite3_finalize(stmt);
+
+        if (delta.complete && delta.toSeq > sinceSeq)
+        {
+            // Each card once, however often it changed; a missing row means it was deleted
+            const std::string sql = std::string("SELECT ch.card_id, c.id IS NULL, ") + kCardColumns +
+                                    " FROM (SELECT DISTINCT card_id FROM card_changes WHERE seq > ?1 AND seq <= ?2) ch"
+                                    " LEFT JOIN cards c ON c.id = ch.card_id;";
+            stmt = nullptr;
+            if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK)
+            {
+                sqlite3_bind_int64(stmt, 1, sinceSeq);
+                sqlite3_bind_int64(stmt, 2, delta.toSeq);
+                while (sqlite3_step(stmt) == SQLITE_ROW)
+                {
+                    if (sqlite3_column_int(stmt, 1)) delta.removed.push_back(sqlite3_column_int(stmt, 0));
+                    else delta.changed.push_back(cardFromRow(stmt, 2));
+                }
+            }
+            else
+            {
+                spdlog::error("SQL error: {}", sqlite3_errmsg(db));
+                delta.complete = false;
+            }
+            sqlite3_finalize(stmt);
+        }
+
+        sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+        return delta;
+    }
+
+    void CardDatabase::pruneChangeLog(const int keep) const
+    {
+        const char *sql = "DELETE FROM card_changes WHERE seq <= (SELECT MAX(seq) FROM card_changes) - ?;";
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(db_));
+            return;
+        }
+        sqlite3_bind_int(stmt, 1, keep);
+        if (sqlite3_step(stmt) != SQLITE_DONE) spdlog::error("SQL error: {}", sqlite3_errmsg(db_));
+        sqlite3_finalize(stmt);
+    }
+
+    void CardDatabase::installBusyHandler(sqlite3 *db, const int maxTotalMs)
+    {
+        sqlite3_busy_handler(db, busyBackoff, reinterpret_cast<void *>(static_cast<std::intptr_t>(maxTotalMs)));
+    }
+
     void CardDatabase::updateSequence(int card_id, int new_sequence) const
     {
         const char *sql = "UPDATE cards SET sequence = ? WHERE id = ?";
@@ -315,54 +1088,48 @@ namespace todo {
         sqlite3_finalize(stmt);
     }
 
-    void CardDatabase::reorderCards(int from_index, int to_index) const
+    CardBatch CardDatabase::reorderBatch(int from_index, int to_index) const
     {
         auto cards = getAllCards();
 
+        CardBatch batch;
         if (from_index == to_index || from_index < 0 || to_index < 0 ||
             from_index >= cards.size() || to_index >= cards.size())
         {
-            return;
+            return batch;
         }
 
-        sqlite3_exec(db_, "BEGIN TRANSACTION", NULL, NULL, NULL);
-
-        try
+        // Only the cards between the two positions change; write them as one batch of moves
+        if (from_index < to_index)
         {
-            // Update sequences for affected cards
-            if (from_index < to_index)
+            // Moving down: shift cards up
+            for (int i = from_index + 1; i <= to_index; i++)
             {
-                // Moving down: shift cards up
-                for (int i = from_index + 1; i <= to_index; i++)
-                {
-                    cards[i].sequence--;
-                    updateSequence(cards[i].id, cards[i].sequence);
-                }
-            } else
+                cards[i].sequence--;
+                batch.move(cards[i]);
+            }
+        } else
+        {
+            // Moving up: shift cards down
+            for (int i = to_index; i < from_index; i++)
             {
-                // Moving up: shift cards down
-                for (int i = to_index; i < from_index; i++)
-                {
-                    cards[i].sequence++;
-                    updateSequence(cards[i].id, cards[i].sequence);
-                }
+                cards[i].sequence++;
+                batch.move(cards[i]);
             }
+        }
 
-            // Update the moved card
-            cards[from_index].sequence = to_index;
-            updateSequence(cards[from_index].id, to_index);
-
-            // Update local vector
-            TodoCard temp = cards[from_index];
-            cards.erase(cards.begin() + from_index);
-            cards.insert(cards.begin() + to_index, temp);
+        // Update the moved card
+        cards[from_index].sequence = to_index;
+        batch.move(cards[from_index]);
+        return batch;
+    }
 
-            sqlite3_exec(db_, "COMMIT", NULL, NULL, NULL);
-        } catch (char **e)
+    void CardDatabase::reorderCards(int from_index, int to_index) const
+    {
+        const CardBatch batch = reorderBatch(from_index, to_index);
+        if (!applyBatch(batch.mutations()))
         {
-            sqlite3_exec(db_, "ROLLBACK", NULL, NULL, e);
-            spdlog::error("Error: {}", *e);
-            throw;
+            spdlog::error("Failed to reorder card {} to {}", from_index, to_index);
         }
     }
 }
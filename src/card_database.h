@@ -3,13 +3,28 @@
 //
 
 #pragma once
+#include <cstdint>
+#include <functional>
+#include <span>
 #include <vector>
 
+#include "board_stats.h"
+#include "card_batch.h"
 #include "imgui_renderer.h"
 #include "project.h"
 #include "sqlite3.h"
 
 namespace todo {
+    // Cards touched by other connections since a change_log cursor (see readCardChanges)
+    struct CardDelta
+    {
+        std::int64_t fromSeq = 0;
+        std::int64_t toSeq = 0;
+        std::vector<TodoCard> changed; // inserted or updated, current row contents
+        std::vector<int> removed; // deleted or archived
+        bool complete = true; // false when the log was pruned past fromSeq; reload everything instead
+    };
+
     class CardDatabase
     {
     public:
@@ -17,21 +32,85 @@ namespace todo {
         void updateDatabaseSchema();
         int getDatabaseVersion();
         void migrateDatabaseToVersion(int targetVersion);
-        bool addProject(const std::string &projectName, const int &projectStatus);
+        void createSearchIndex();
+        void createChangeLog();
+        void createOperationJournal();
+        void createCardHistory();
+        void createCycleTimeSketches();
+        bool addProject(const std::string &projectName, const int &projectStatus, int *newId = nullptr);
+
+        // Key/value settings stored alongside db_version in app_metadata
+        std::string getMetadata(const std::string &key, const std::string &defaultValue = "") const;
+        bool setMetadata(const std::string &key, const std::string &value) const;
         explicit CardDatabase(const std::string& dbPath);
         ~CardDatabase();
 
-        bool addCard(const std::string &title, const std::string &desc, const int &status, int sequence, const int &project) const;
         bool updateCard(TodoCard& card) const;
         [[nodiscard]] bool removeCard(int cardId) const;
+
+        // Applies every mutation in a single transaction (a savepoint when the caller already has
+        // one open) with one prepared statement per kind. Nothing is written unless all of them
+        // succeed. Ids of inserted cards are appended to `insertedIds` in batch order when it is
+        // given. `bulkIndex` adds inserted cards to the search index in one pass at commit
+        // instead of row by row (for imports).
+        bool applyBatch(std::span<const CardMutation> mutations, std::vector<int> *insertedIds = nullptr,
+                        bool bulkIndex = false) const;
         std::vector<proj::Project> getAllProjects() const;
         std::vector<TodoCard> getAllCards() const;
 
+        // Connection-agnostic readers, shared with the DatabaseReader worker connections
+        static std::vector<proj::Project> readAllProjects(sqlite3 *db);
+        static std::vector<TodoCard> readAllCards(sqlite3 *db);
+        // The same rows handed to `chunk` `chunkSize` at a time, for a board that fills in as it loads
+        static void readAllCards(sqlite3 *db, std::size_t chunkSize,
+                                 const std::function<void(std::vector<TodoCard> &&)> &chunk);
+        static std::vector<TodoCard> readProjectCards(sqlite3 *db, int projectId);
+        // The cards with these ids that exist, in `ids` order
+        static std::vector<TodoCard> readCards(sqlite3 *db, std::span<const int> ids);
+
+        // Rollups of the last `days` days, oldest first; days without activity are absent.
+        // projectId < 0 sums over every project.
+        static std::vector<DailyStats> readDailyStats(sqlite3 *db, int days, int projectId = -1);
+
+        // Newest card_changes entry; read it in the same transaction as the rows it describes
+        static std::int64_t readChangeSeq(sqlite3 *db);
+        static CardDelta readCardChanges(sqlite3 *db, std::int64_t sinceSeq);
+
+        // Keeps the newest `keep` card_changes entries
+        void pruneChangeLog(int keep) const;
+
+        // Copies of the board that sync with each other (BoardSync) create rows with ids from
+        // disjoint per-device ranges, [device * kIdsPerDevice, (device + 1) * kIdsPerDevice),
+        // so cards made on two machines never collide. Device 0 is the unsynced AUTOINCREMENT range.
+        static constexpr sqlite3_int64 kIdsPerDevice = sqlite3_int64{1} << 24;
+        static constexpr int kMaxDevices = 127;
+        void useDeviceIdRange(int device);
+        [[nodiscard]] sqlite3_int64 idFloor() const { return idFloor_; }
+
+        // Retries SQLITE_BUSY with exponential backoff instead of failing immediately when
+        // another connection or process holds the write lock, for up to `maxTotalMs`. Background
+        // and CLI connections can afford the long wait; the UI's writer gives up within a
+        // fraction of a frame and Application retries the edit from a later frame.
+        static constexpr int kBusyMaxTotalMs = 3000;
+        static constexpr int kInteractiveBusyMaxTotalMs = 8;
+        static void installBusyHandler(sqlite3 *db, int maxTotalMs = kBusyMaxTotalMs);
+        void setBusyBudget(const int maxTotalMs) const { installBusyHandler(db_, maxTotalMs); }
+
+        // Raw writer connection, for SQLite APIs that operate on a whole connection (backup)
+        [[nodiscard]] sqlite3 *handle() const { return db_; }
+
         void updateSequence(int card_id, int new_sequence) const;
         void reorderCards(int from_index, int to_index) const;
+        // The moves reorderCards applies, for callers that run them through the journal
+        CardBatch reorderBatch(int from_index, int to_index) const;
 
     private:
+        bool reindexInserted(sqlite3_int64 firstId, sqlite3_int64 lastId) const;
+        // First of `count` consecutive ids from this device's range; 0 on failure
+        sqlite3_int64 reserveIds(const char *counterKey, int count) const;
+
         sqlite3* db_ = nullptr;
+        sqlite3_int64 idFloor_ = 0;
 
     };
 }
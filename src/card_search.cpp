@@ -0,0 +1,141 @@
+#include "card_search.h"
+
+#include <utility>
+
+#include "database_reader.h"
+#include "spdlog/spdlog.h"
+
+namespace todo {
+    std::string buildFtsQuery(const std::string &input)
+    {
+        std::string query;
+        std::string term;
+
+        auto flushTerm = [&]()
+        {
+            if (term.empty()) return;
+            if (!query.empty()) query += ' ';
+            query += '"';
+            query += term;
+            query += "\"*";
+            term.clear();
+        };
+
+        for (const char c: input)
+        {
+            if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+            {
+                flushTerm();
+            } else if (c == '"')
+            {
+                // Quotes would close the phrase early; escape them FTS5-style
+                term += "\"\"";
+            } else
+            {
+                term += c;
+            }
+        }
+        flushTerm();
+        return query;
+    }
+
+    std::vector<CardSearchResult> searchCards(sqlite3 *db, const std::string &input, const int limit)
+    {
+        std::vector<CardSearchResult> results;
+        const std::string ftsQuery = buildFtsQuery(input);
+        if (ftsQuery.empty()) return results;
+
+        // ORDER BY rank uses the bm25 weights configured on cards_fts; with a LIMIT,
+        // FTS5 only keeps the top `limit` rows instead of sorting every match.
+        const char *hotSql =
+                "SELECT c.id, IFNULL(c.project, 0), c.status, c.title,"
+                " snippet(cards_fts, 1, '[', ']', '...', 8), cards_fts.rank, 0"
+                " FROM cards_fts JOIN cards c ON c.id = cards_fts.rowid"
+                " WHERE cards_fts MATCH ?1"
+                " ORDER BY cards_fts.rank LIMIT ?2;";
+
+        // Archived cards are ranked in their own index, whose bm25 scores are not comparable with
+        // the hot index's, so hot matches come first and each source keeps its own rank order
+        const char *withArchiveSql =
+                "SELECT * FROM ("
+                "  SELECT c.id, IFNULL(c.project, 0), c.status, c.title,"
+                "  snippet(hot.cards_fts, 1, '[', ']', '...', 8), hot.rank, 0"
+                "  FROM main.cards_fts AS hot JOIN main.cards c ON c.id = hot.rowid"
+                "  WHERE hot.cards_fts MATCH ?1 ORDER BY hot.rank LIMIT ?2)"
+                " UNION ALL SELECT * FROM ("
+                "  SELECT a.id, IFNULL(a.project, 0), a.status, a.title,"
+                "  snippet(cold.cards_fts, 1, '[', ']', '...', 8), cold.rank, 1"
+                "  FROM archive.cards_fts AS cold JOIN archive.cards a ON a.id = cold.rowid"
+                "  WHERE cold.cards_fts MATCH ?1 ORDER BY cold.rank LIMIT ?2)"
+                " ORDER BY 7, 6 LIMIT ?2;";
+
+        const bool hasArchive = sqlite3_db_filename(db, "archive") != nullptr;
+        const char *sql = hasArchive ? withArchiveSql : hotSql;
+
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(db));
+            return results;
+        }
+        sqlite3_bind_text(stmt, 1, ftsQuery.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 2, limit);
+
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            CardSearchResult result;
+            result.cardId = sqlite3_column_int(stmt, 0);
+            result.projectId = sqlite3_column_int(stmt, 1);
+            result.status = intToStatus(sqlite3_column_int(stmt, 2));
+            if (const auto *title = sqlite3_column_text(stmt, 3))
+                result.title = reinterpret_cast<const char *>(title);
+            if (const auto *snippet = sqlite3_column_text(stmt, 4))
+                result.snippet = reinterpret_cast<const char *>(snippet);
+            result.rank = sqlite3_column_double(stmt, 5);
+            result.archived = sqlite3_column_int(stmt, 6) != 0;
+            results.push_back(std::move(result));
+        }
+        sqlite3_finalize(stmt);
+        return results;
+    }
+
+    void CardSearch::submit(const std::string &query)
+    {
+        pendingQuery_ = query;
+        pendingGeneration_++;
+        lastSubmit_ = std::chrono::steady_clock::now();
+    }
+
+    bool CardSearch::pollResults(std::vector<CardSearchResult> &results)
+    {
+        // Debounce: only dispatch once the user has stopped typing for `debounce_`, and keep
+        // at most one query in flight so fast typists cannot pile work onto the readers.
+        const bool debounced = std::chrono::steady_clock::now() - lastSubmit_ >= debounce_;
+        if (!inFlight_ && debounced && dispatchedGeneration_ != pendingGeneration_)
+        {
+            const std::uint64_t generation = pendingGeneration_;
+            dispatchedGeneration_ = generation;
+            inFlight_ = true;
+
+            reader_.query<std::vector<CardSearchResult> >(
+                [query = pendingQuery_](sqlite3 *db)
+                {
+                    return searchCards(db, query, kResultLimit);
+                },
+                [this, generation](std::vector<CardSearchResult> &found)
+                {
+                    inFlight_ = false;
+                    finishedResults_ = std::move(found);
+                    finishedGeneration_ = generation;
+                },
+                [this] { inFlight_ = false; });
+        }
+
+        if (finishedGeneration_ == deliveredGeneration_) return false;
+
+        results.swap(finishedResults_);
+        finishedResults_.clear();
+        deliveredGeneration_ = finishedGeneration_;
+        return true;
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "sqlite3.h"
+#include "todo_card.h"
+
+namespace todo {
+    struct CardSearchResult
+    {
+        int cardId = -1;
+        int projectId = 0;
+        CardStatus status = CardStatus::Todo;
+        std::string title;
+        std::string snippet;
+        double rank = 0.0;
+        bool archived = false;
+    };
+
+    // Turns raw user input into an FTS5 query: every word becomes a quoted prefix term,
+    // so partially typed words still match and FTS5 operators in the input are inert.
+    std::string buildFtsQuery(const std::string &input);
+
+    // Runs a ranked (bm25) full-text query against cards_fts on the given connection, and
+    // against archive.cards_fts as well when the archive database is attached. Hot matches come
+    // before archived ones; `rank` only orders results from the same source.
+    std::vector<CardSearchResult> searchCards(sqlite3 *db, const std::string &input, int limit);
+
+    class DatabaseReader;
+
+    // Debounced search. Debouncing happens on the UI thread (no SQL involved); the query
+    // itself runs on the DatabaseReader pool, so typing never executes SQL on the render thread.
+    class CardSearch
+    {
+    public:
+        explicit CardSearch(DatabaseReader &reader) : reader_(reader)
+        {
+        }
+
+        CardSearch(const CardSearch &) = delete;
+        CardSearch &operator=(const CardSearch &) = delete;
+
+        // Called from the UI whenever the query text changes. Cheap; never touches SQLite.
+        void submit(const std::string &query);
+
+        // Dispatches the pending query once the debounce has elapsed and swaps in the newest
+        // finished results, if any. Returns true when `results` changed.
+        bool pollResults(std::vector<CardSearchResult> &results);
+
+        void setDebounce(std::chrono::milliseconds debounce) { debounce_ = debounce; }
+
+    private:
+        DatabaseReader &reader_;
+        std::chrono::milliseconds debounce_{120};
+        static constexpr int kResultLimit = 25;
+
+        std::string pendingQuery_;
+        std::uint64_t pendingGeneration_ = 0;
+        std::uint64_t dispatchedGeneration_ = 0;
+        std::chrono::steady_clock::time_point lastSubmit_;
+        bool inFlight_ = false;
+
+        std::vector<CardSearchResult> finishedResults_;
+        std::uint64_t finishedGeneration_ = 0;
+        std::uint64_t deliveredGeneration_ = 0;
+    };
+}
@@ -0,0 +1,291 @@
+#include "card_store.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+
+namespace todo {
+    namespace {
+        std::uint64_t nextRevision()
+        {
+            static std::atomic<std::uint64_t> revision{0};
+            return ++revision;
+        }
+
+        std::uint64_t columnKey(const std::int32_t projectId, const std::uint8_t status)
+        {
+            return static_cast<std::uint64_t>(static_cast<std::uint32_t>(projectId)) << 8 | status;
+        }
+    }
+
+    StringArena::Ref StringArena::intern(const std::string_view text)
+    {
+        if (text.empty()) return {};
+        if ((used_ + 1) * 10 > slots_.size() * 7) grow();
+
+        const std::size_t mask = slots_.size() - 1;
+        std::size_t slot = std::hash<std::string_view>{}(text) & mask;
+        for (; slots_[slot].length != 0; slot = (slot + 1) & mask)
+        {
+            if (view(slots_[slot]) == text) return slots_[slot];
+        }
+
+        const Ref ref{static_cast<std::uint32_t>(bytes_.size()), static_cast<std::uint32_t>(text.size())};
+        bytes_.insert(bytes_.end(), text.begin(), text.end());
+        slots_[slot] = ref;
+        used_++;
+        return ref;
+    }
+
+    void StringArena::grow()
+    {
+        std::vector<Ref> old = std::move(slots_);
+        slots_.assign(std::max<std::size_t>(1024, old.size() * 2), Ref{});
+
+        const std::size_t mask = slots_.size() - 1;
+        for (const Ref &ref: old)
+        {
+            if (ref.length == 0) continue;
+            std::size_t slot = std::hash<std::string_view>{}(view(ref)) & mask;
+            while (slots_[slot].length != 0) slot = (slot + 1) & mask;
+            slots_[slot] = ref;
+        }
+    }
+
+    void StringArena::clear()
+    {
+        bytes_.clear();
+        slots_.clear();
+        used_ = 0;
+    }
+
+    std::size_t StringArena::memoryUsage() const
+    {
+        return bytes_.capacity() + slots_.capacity() * sizeof(Ref);
+    }
+
+    std::uint32_t parseTimestamp(const std::string_view text)
+    {
+        auto number = [&](const std::size_t pos, const std::size_t length, int &out)
+        {
+            const char *first = text.data() + pos;
+            const auto [end, ec] = std::from_chars(first, first + length, out);
+            return ec == std::errc{} && end == first + length;
+        };
+
+        int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+        if (text.size() < 10 || !number(0, 4, year) || text[4] != '-' || !number(5, 2, month) || text[7] != '-' ||
+            !number(8, 2, day))
+        {
+            return 0;
+        }
+        if (text.size() >= 19 && (text[10] == ' ' || text[10] == 'T') &&
+            (!number(11, 2, hour) || text[13] != ':' || !number(14, 2, minute) || text[16] != ':' ||
+             !number(17, 2, second)))
+        {
+            return 0;
+        }
+
+        const std::chrono::year_month_day date{
+            std::chrono::year(year), std::chrono::month(month), std::chrono::day(day)
+        };
+        if (!date.ok()) return 0;
+        const auto time = std::chrono::sys_days(date) + std::chrono::hours(hour) + std::chrono::minutes(minute) +
+                          std::chrono::seconds(second);
+        const std::int64_t seconds = std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+        return seconds > 0 && seconds <= UINT32_MAX ? static_cast<std::uint32_t>(seconds) : 0;
+    }
+
+    std::size_t formatTimestamp(const std::uint32_t seconds, char *out, const std::size_t size)
+    {
+        if (size == 0) return 0;
+        if (seconds == 0)
+        {
+            out[0] = '\0';
+            return 0;
+        }
+
+        const std::chrono::sys_seconds time{std::chrono::seconds(seconds)};
+        const auto days = std::chrono::floor<std::chrono::days>(time);
+        const std::chrono::year_month_day date{days};
+        const std::chrono::hh_mm_ss clock{time - days};
+        const int written = std::snprintf(out, size, "%04d-%02u-%02u %02d:%02d:%02d", static_cast<int>(date.year()),
+                                          static_cast<unsigned>(date.month()), static_cast<unsigned>(date.day()),
+                                          static_cast<int>(clock.hours().count()),
+                                          static_cast<int>(clock.minutes().count()),
+                                          static_cast<int>(clock.seconds().count()));
+        return written < 0 ? 0 : std::min(static_cast<std::size_t>(written), size - 1);
+    }
+
+    CompactCard CardStore::pack(const TodoCard &card)
+    {
+        return pack(card.id, card.title, card.description, card.status, card.sequence, card.projectId,
+                    card.createdAt, card.completedAt);
+    }
+
+    CompactCard CardStore::pack(const int id, const std::string_view title, const std::string_view description,
+                                const CardStatus status, const int sequence, const int projectId,
+                                const std::string_view createdAt, const std::string_view completedAt)
+    {
+        CompactCard packed;
+        packed.createdAt = parseTimestamp(createdAt);
+        packed.completedAt = parseTimestamp(completedAt);
+        if (packed.createdAt == 0 && !createdAt.empty()) packed.unparsed |= CompactCard::kUnparsedCreatedAt;
+        if (packed.completedAt == 0 && !completedAt.empty()) packed.unparsed |= CompactCard::kUnparsedCompletedAt;
+        if (packed.unparsed != 0)
+        {
+            UnparsedTimes &times = unparsedTimes_[id];
+            times.createdAt = text_.intern(packed.unparsed & CompactCard::kUnparsedCreatedAt ? createdAt : "");
+            times.completedAt = text_.intern(packed.unparsed & CompactCard::kUnparsedCompletedAt ? completedAt : "");
+        }
+        packed.id = id;
+        packed.sequence = sequence;
+        packed.projectId = projectId;
+        packed.title = text_.intern(title);
+        packed.description = text_.intern(description);
+        packed.status = static_cast<std::uint8_t>(statusToInt(status));
+        packed.color = status == CardStatus::Done ? 1 : 0;
+        return packed;
+    }
+
+    void CardStore::assign(const std::vector<TodoCard> &cards)
+    {
+        cards_.clear();
+        text_.clear();
+        unparsedTimes_.clear();
+        packedTextSize_ = 0;
+        columnRevisions_.clear();
+        append(cards);
+        cards_.shrink_to_fit();
+        text_.shrinkToFit();
+    }
+
+    void CardStore::append(const std::vector<TodoCard> &cards)
+    {
+        const std::size_t before = text_.size();
+        cards_.reserve(cards_.size() + cards.size());
+        for (const auto &card: cards) cards_.push_back(pack(card));
+        packedTextSize_ += text_.size() - before;
+        touchAll();
+    }
+
+    void CardStore::push_back(const TodoCard &card)
+    {
+        const std::size_t before = text_.size();
+        cards_.push_back(pack(card));
+        packedTextSize_ += text_.size() - before;
+        touch(cards_.back());
+    }
+
+    void CardStore::emplace_back(const int id, const std::string_view title, const std::string_view description,
+                                 const CardStatus status, const int sequence, const int projectId,
+                                 const std::string_view createdAt, const std::string_view completedAt)
+    {
+        const std::size_t before = text_.size();
+        cards_.push_back(pack(id, title, description, status, sequence, projectId, createdAt, completedAt));
+        packedTextSize_ += text_.size() - before;
+        touch(cards_.back());
+    }
+
+    void CardStore::set(const std::size_t index, const TodoCard &card)
+    {
+        touch(cards_[index]);
+        cards_[index] = pack(card);
+        touch(cards_[index]);
+        repackIfWasteful();
+    }
+
+    void CardStore::sortBySequence()
+    {
+        std::ranges::stable_sort(cards_, {}, &CompactCard::sequence);
+    }
+
+    void CardStore::repackIfWasteful()
+    {
+        constexpr std::size_t kSlack = 64 * 1024;
+        if (text_.size() <= 2 * packedTextSize_ + kSlack) return;
+
+        StringArena old = std::move(text_);
+        text_.clear();
+        std::unordered_map<std::int32_t, UnparsedTimes> oldTimes = std::move(unparsedTimes_);
+        unparsedTimes_.clear();
+        for (auto &card: cards_)
+        {
+            card.title = text_.intern(old.view(card.title));
+            card.description = text_.intern(old.view(card.description));
+            if (card.unparsed != 0)
+            {
+                const UnparsedTimes &times = oldTimes[card.id];
+                unparsedTimes_[card.id] = {text_.intern(old.view(times.createdAt)),
+                                           text_.intern(old.view(times.completedAt))};
+            }
+        }
+        packedTextSize_ = text_.size();
+        touchAll();
+    }
+
+    void CardStore::touch(const CompactCard &card)
+    {
+        columnRevisions_[columnKey(card.projectId, card.status)] = nextRevision();
+    }
+
+    void CardStore::touchAll()
+    {
+        boardRevision_ = nextRevision();
+    }
+
+    const CompactCard *CardStore::find(const int id) const
+    {
+        const auto it = std::ranges::find(cards_, id, &CompactCard::id);
+        return it == cards_.end() ? nullptr : &*it;
+    }
+
+    std::uint64_t CardStore::columnRevision(const int projectId, const CardStatus status) const
+    {
+        const auto it = columnRevisions_.find(columnKey(projectId, static_cast<std::uint8_t>(statusToInt(status))));
+        return it == columnRevisions_.end() ? boardRevision_ : std::max(boardRevision_, it->second);
+    }
+
+    TodoCard CardStore::unpack(const CompactCard &card) const
+    {
+        char createdAt[32];
+        char completedAt[32];
+        formatTimestamp(card.createdAt, createdAt, sizeof(createdAt));
+        formatTimestamp(card.completedAt, completedAt, sizeof(completedAt));
+        TodoCard unpacked{
+            card.id, std::string(title(card)), std::string(description(card)), card.cardStatus(), card.sequence,
+            card.projectId, createdAt, completedAt
+        };
+
+        if (card.unparsed != 0)
+        {
+            const auto times = unparsedTimes_.find(card.id);
+            if (times != unparsedTimes_.end())
+            {
+                if (card.unparsed & CompactCard::kUnparsedCreatedAt) unpacked.createdAt = text(times->second.createdAt);
+                if (card.unparsed & CompactCard::kUnparsedCompletedAt)
+                {
+                    unpacked.completedAt = text(times->second.completedAt);
+                }
+            }
+        }
+        return unpacked;
+    }
+
+    std::vector<TodoCard> CardStore::unpackAll() const
+    {
+        std::vector<TodoCard> cards;
+        cards.reserve(cards_.size());
+        for (const auto &card: cards_) cards.push_back(unpack(card));
+        return cards;
+    }
+
+    std::size_t CardStore::memoryUsage() const
+    {
+        return cards_.capacity() * sizeof(CompactCard) + text_.memoryUsage() +
+               unparsedTimes_.size() * (sizeof(std::int32_t) + sizeof(UnparsedTimes));
+    }
+}
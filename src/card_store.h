@@ -0,0 +1,150 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "glm/vec4.hpp"
+#include "todo_card.h"
+
+namespace todo {
+    // Append-only UTF-8 text referenced by {offset, length}. Interning means a title or
+    // description that many cards share is stored once.
+    class StringArena
+    {
+    public:
+        struct Ref
+        {
+            std::uint32_t offset = 0;
+            std::uint32_t length = 0;
+        };
+
+        Ref intern(std::string_view text);
+        [[nodiscard]] std::string_view view(Ref ref) const { return {bytes_.data() + ref.offset, ref.length}; }
+
+        void clear();
+        void shrinkToFit() { bytes_.shrink_to_fit(); }
+        [[nodiscard]] std::size_t size() const { return bytes_.size(); }
+        [[nodiscard]] std::size_t memoryUsage() const;
+
+    private:
+        void grow();
+
+        std::vector<char> bytes_;
+        // Open addressing over the interned refs; length 0 marks an empty slot
+        std::vector<Ref> slots_;
+        std::size_t used_ = 0;
+    };
+
+    // The board's in-memory form of a card: 40 bytes and no heap blocks of its own, against
+    // TodoCard's ~150 plus one block per long string
+    struct CompactCard
+    {
+        std::uint32_t createdAt = 0; // Unix seconds, UTC (good until 2106); 0 = unset
+        std::uint32_t completedAt = 0;
+        std::int32_t id = -1;
+        std::int32_t sequence = -1;
+        std::int32_t projectId = 0;
+        StringArena::Ref title;
+        StringArena::Ref description;
+        std::uint8_t status = 0; // CardStatus
+        std::uint8_t color = 0; // index into kCardPalette
+        // Timestamps whose text did not parse: the field reads 0 and CardStore keeps the text
+        std::uint8_t unparsed = 0;
+
+        static constexpr std::uint8_t kUnparsedCreatedAt = 1;
+        static constexpr std::uint8_t kUnparsedCompletedAt = 2;
+
+        [[nodiscard]] CardStatus cardStatus() const { return intToStatus(status); }
+    };
+
+    // Card colors, by CompactCard::color
+    inline const glm::vec4 kCardPalette[] = {
+        {0.3f, 0.3f, 0.8f, 1.0f}, // open
+        {0.144f, 0.238f, 0.144f, 1.0f}, // done
+    };
+
+    // SQLite's "YYYY-MM-DD HH:MM:SS" (UTC), also accepting a 'T' separator and a bare date.
+    // Anything else, or a time before 1970, parses as 0 (CardStore keeps such text verbatim).
+    std::uint32_t parseTimestamp(std::string_view text);
+    // Writes "YYYY-MM-DD HH:MM:SS", or "" for 0; returns the length
+    std::size_t formatTimestamp(std::uint32_t seconds, char *out, std::size_t size);
+
+    // The board's cards, packed. TodoCard stays the exchange type with SQLite, the journal and
+    // the modals; cards are packed on the way in and unpacked only when one is opened or edited.
+    // Replaced text is left in the arena until it outweighs the live text, then repacked.
+    class CardStore
+    {
+    public:
+        [[nodiscard]] std::size_t size() const { return cards_.size(); }
+        [[nodiscard]] bool empty() const { return cards_.empty(); }
+        [[nodiscard]] const CompactCard &operator[](std::size_t index) const { return cards_[index]; }
+        [[nodiscard]] auto begin() const { return cards_.begin(); }
+        [[nodiscard]] auto end() const { return cards_.end(); }
+
+        void assign(const std::vector<TodoCard> &cards);
+        void append(const std::vector<TodoCard> &cards);
+        void push_back(const TodoCard &card);
+        // For sources that already hold the fields apart (the mapped board snapshot): packs
+        // straight from the views, with no TodoCard or std::string per card on the way
+        void reserve(std::size_t count) { cards_.reserve(count); }
+        void emplace_back(int id, std::string_view title, std::string_view description, CardStatus status,
+                          int sequence, int projectId, std::string_view createdAt, std::string_view completedAt);
+        void set(std::size_t index, const TodoCard &card);
+        template<typename Predicate>
+        void eraseIf(Predicate predicate)
+        {
+            std::erase_if(cards_, [&](const CompactCard &card)
+            {
+                if (!predicate(card)) return false;
+                touch(card);
+                return true;
+            });
+        }
+        void sortBySequence();
+
+        // Linear; for opening a card, not for per-frame lookups
+        [[nodiscard]] const CompactCard *find(int id) const;
+        // Changes whenever a card joins, leaves or changes in the column, or the whole board is
+        // replaced. Unique across stores, so a replaced store never repeats an old value.
+        [[nodiscard]] std::uint64_t columnRevision(int projectId, CardStatus status) const;
+
+        [[nodiscard]] std::string_view text(const StringArena::Ref ref) const { return text_.view(ref); }
+        [[nodiscard]] std::string_view title(const CompactCard &card) const { return text_.view(card.title); }
+        [[nodiscard]] std::string_view description(const CompactCard &card) const
+        {
+            return text_.view(card.description);
+        }
+        [[nodiscard]] TodoCard unpack(const CompactCard &card) const;
+        [[nodiscard]] std::vector<TodoCard> unpackAll() const;
+
+        // Bytes held for the cards, their text and the intern table
+        [[nodiscard]] std::size_t memoryUsage() const;
+
+    private:
+        CompactCard pack(const TodoCard &card);
+        CompactCard pack(int id, std::string_view title, std::string_view description, CardStatus status,
+                         int sequence, int projectId, std::string_view createdAt, std::string_view completedAt);
+        void repackIfWasteful();
+        void touch(const CompactCard &card);
+        void touchAll();
+
+        struct UnparsedTimes
+        {
+            StringArena::Ref createdAt;
+            StringArena::Ref completedAt;
+        };
+
+        std::vector<CompactCard> cards_;
+        StringArena text_;
+        // By card id, for the few cards flagged in CompactCard::unparsed, so unpack() hands back
+        // the stored text and writing the card back does not blank it
+        std::unordered_map<std::int32_t, UnparsedTimes> unparsedTimes_;
+        std::size_t packedTextSize_ = 0; // arena size after the last full pack
+
+        std::uint64_t boardRevision_ = 0;
+        std::unordered_map<std::uint64_t, std::uint64_t> columnRevisions_; // by project and status
+    };
+}
@@ -0,0 +1,314 @@
+#include "cycle_time_sketches.h"
+
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+
+namespace todo {
+    namespace {
+        constexpr const char *kCursorKey = "sketch_event_cursor";
+
+        // Events after ?1 and up to ?2 of the cards `filter` selects, with their durations in
+        // seconds. The window functions see each card's whole history up to ?2, so an event just
+        // past the cursor still knows when its card entered the state it is leaving.
+        std::string samplesSql(const char *filter)
+        {
+            return std::string(R"(
+                WITH history AS (
+                    SELECT id, project, from_status, to_status,
+                           julianday(at) - julianday(LAG(at) OVER by_card) AS in_state,
+                           julianday(at) - julianday(FIRST_VALUE(at) OVER by_card) AS lead,
+                           julianday(at) - julianday(COALESCE(
+                               MAX(CASE WHEN to_status = 1 THEN at END)
+                                   OVER (by_card ROWS BETWEEN UNBOUNDED PRECEDING AND 1 PRECEDING),
+                               FIRST_VALUE(at) OVER by_card)) AS cycle
+                    FROM card_events
+                    WHERE id <= ?2 AND )") + filter + R"(
+                    WINDOW by_card AS (PARTITION BY card_id ORDER BY id)
+                )
+                SELECT project, from_status, to_status, in_state * 86400, lead * 86400, cycle * 86400
+                FROM history WHERE id > ?1 AND from_status IS NOT NULL;
+            )";
+        }
+
+        void addSample(CycleTimeSketches::Sketches &sketches, const int project, const int metric,
+                       sqlite3_stmt *stmt, const int column)
+        {
+            if (sqlite3_column_type(stmt, column) == SQLITE_NULL) return;
+            sketches[{project, metric}].add(std::max(0.0, sqlite3_column_double(stmt, column)));
+        }
+
+        // Steps a samplesSql statement to the end, adding every duration to `sketches`
+        bool foldSamples(sqlite3_stmt *stmt, CycleTimeSketches::Sketches &sketches)
+        {
+            int rc;
+            while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+            {
+                const int project = sqlite3_column_int(stmt, 0);
+                const CardStatus from = intToStatus(sqlite3_column_int(stmt, 1));
+                const CardStatus to = intToStatus(sqlite3_column_int(stmt, 2));
+
+                addSample(sketches, project, CycleTimeSketches::transitionMetric(from, to), stmt, 3);
+                if (to == CardStatus::Done)
+                {
+                    addSample(sketches, project, CycleTimeSketches::kLeadTime, stmt, 4);
+                    addSample(sketches, project, CycleTimeSketches::kCycleTime, stmt, 5);
+                }
+            }
+            return rc == SQLITE_DONE;
+        }
+
+        std::int64_t latestEventId(sqlite3 *db)
+        {
+            std::int64_t id = 0;
+            sqlite3_stmt *stmt = nullptr;
+            if (sqlite3_prepare_v2(db, "SELECT IFNULL(MAX(id), 0) FROM card_events;", -1, &stmt, nullptr) ==
+                SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW)
+            {
+                id = sqlite3_column_int64(stmt, 0);
+            }
+            sqlite3_finalize(stmt);
+            return id;
+        }
+    }
+
+    CycleTimeSketches::CycleTimeSketches(sqlite3 *db) : db_(db)
+    {
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(db_, "SELECT CAST(value AS INTEGER) FROM app_metadata WHERE key = ?;", -1, &stmt,
+                               nullptr) == SQLITE_OK)
+        {
+            sqlite3_bind_text(stmt, 1, kCursorKey, -1, SQLITE_STATIC);
+            if (sqlite3_step(stmt) == SQLITE_ROW)
+            {
+                cursor_ = sqlite3_column_int64(stmt, 0);
+                built_ = true;
+            }
+        }
+        sqlite3_finalize(stmt);
+
+        stmt = nullptr;
+        if (sqlite3_prepare_v2(db_, "SELECT project, metric, digest FROM cycle_time_sketches;", -1, &stmt,
+                               nullptr) != SQLITE_OK)
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(db_));
+            return;
+        }
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            const std::string_view blob(static_cast<const char *>(sqlite3_column_blob(stmt, 2)),
+                                        static_cast<size_t>(sqlite3_column_bytes(stmt, 2)));
+            if (auto digest = TDigest::deserialize(blob))
+            {
+                sketches_.emplace(Key{sqlite3_column_int(stmt, 0), sqlite3_column_int(stmt, 1)}, std::move(*digest));
+            } else
+            {
+                // Rebuilt from history rather than silently losing the samples
+                spdlog::warn("Damaged cycle-time sketch; rebuilding from history");
+                built_ = false;
+            }
+        }
+        sqlite3_finalize(stmt);
+    }
+
+    bool CycleTimeSketches::update()
+    {
+        if (rebuilding_ || !built_) return false;
+
+        const std::int64_t until = latestEventId(db_);
+        if (until <= cursor_) return true;
+        if (until - cursor_ > kMaxIncrementalEvents)
+        {
+            // An import or a first sync: cheaper to rebuild on a worker than to fold in here
+            built_ = false;
+            return false;
+        }
+
+        sqlite3_stmt *stmt = nullptr;
+        const std::string sql = samplesSql("card_id IN (SELECT card_id FROM card_events WHERE id > ?1)");
+        if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(db_));
+            return false;
+        }
+        sqlite3_bind_int64(stmt, 1, cursor_);
+        sqlite3_bind_int64(stmt, 2, until);
+
+        Sketches added;
+        const bool read = foldSamples(stmt, added);
+        sqlite3_finalize(stmt);
+        if (!read)
+        {
+            spdlog::error("Failed to read card history: {}", sqlite3_errmsg(db_));
+            return false;
+        }
+
+        Sketches touched;
+        for (auto &[key, digest]: added)
+        {
+            TDigest &sketch = sketches_[key];
+            sketch.merge(digest);
+            touched.emplace(key, sketch);
+        }
+        cursor_ = until;
+        if (!touched.empty()) version_++;
+        return persist(touched, false);
+    }
+
+    CycleTimeSketches::Built CycleTimeSketches::build(sqlite3 *db, unsigned threads)
+    {
+        threads = std::max(1u, threads);
+        const char *path = sqlite3_db_filename(db, "main");
+
+        Built built;
+        built.cursor = latestEventId(db);
+
+        // Disjoint slices of the cards, one connection each; a card's events stay in one slice
+        std::vector<std::future<Sketches>> slices;
+        slices.reserve(threads);
+        for (unsigned slice = 0; slice < threads; slice++)
+        {
+            slices.push_back(std::async(std::launch::async, [path = std::string(path ? path : ""), slice, threads,
+                                                             until = built.cursor]
+            {
+                Sketches sketches;
+                sqlite3 *conn = nullptr;
+                if (sqlite3_open_v2(path.c_str(), &conn, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr) !=
+                    SQLITE_OK)
+                {
+                    spdlog::error("Failed to open {} for a sketch rebuild", path);
+                    sqlite3_close(conn);
+                    return sketches;
+                }
+
+                sqlite3_stmt *stmt = nullptr;
+                const std::string sql = samplesSql("card_id % ?3 = ?4");
+                if (sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK)
+                {
+                    sqlite3_bind_int64(stmt, 1, 0);
+                    sqlite3_bind_int64(stmt, 2, until);
+                    sqlite3_bind_int(stmt, 3, static_cast<int>(threads));
+                    sqlite3_bind_int(stmt, 4, static_cast<int>(slice));
+                    if (!foldSamples(stmt, sketches)) spdlog::error("SQL error: {}", sqlite3_errmsg(conn));
+                } else
+                {
+                    spdlog::error("SQL error: {}", sqlite3_errmsg(conn));
+                }
+                sqlite3_finalize(stmt);
+                sqlite3_close(conn);
+                return sketches;
+            }));
+        }
+
+        for (auto &slice: slices)
+        {
+            for (const auto &[key, digest]: slice.get()) built.sketches[key].merge(digest);
+        }
+        return built;
+    }
+
+    void CycleTimeSketches::replace(Built built)
+    {
+        rebuilding_ = false;
+        sketches_ = std::move(built.sketches);
+        cursor_ = built.cursor;
+        built_ = true;
+        version_++;
+        persist(sketches_, true);
+    }
+
+    TDigest CycleTimeSketches::merged(const int project, const int metric) const
+    {
+        if (project != kAllProjects)
+        {
+            const auto found = sketches_.find({project, metric});
+            return found != sketches_.end() ? found->second : TDigest();
+        }
+
+        TDigest all;
+        for (const auto &[key, digest]: sketches_)
+        {
+            if (key.metric == metric) all.merge(digest);
+        }
+        return all;
+    }
+
+    double CycleTimeSketches::quantile(const int project, const int metric, const double q) const
+    {
+        if (project != kAllProjects)
+        {
+            const auto found = sketches_.find({project, metric});
+            return found != sketches_.end() ? found->second.quantile(q) : std::numeric_limits<double>::quiet_NaN();
+        }
+        return merged(project, metric).quantile(q);
+    }
+
+    double CycleTimeSketches::count(const int project, const int metric) const
+    {
+        if (project != kAllProjects)
+        {
+            const auto found = sketches_.find({project, metric});
+            return found != sketches_.end() ? found->second.count() : 0.0;
+        }
+
+        double total = 0.0;
+        for (const auto &[key, digest]: sketches_)
+        {
+            if (key.metric == metric) total += digest.count();
+        }
+        return total;
+    }
+
+    bool CycleTimeSketches::persist(const Sketches &touched, const bool replaceAll) const
+    {
+        auto exec = [this](const char *sql)
+        {
+            char *err = nullptr;
+            if (sqlite3_exec(db_, sql, nullptr, nullptr, &err) == SQLITE_OK) return true;
+            spdlog::error("Failed to save cycle-time sketches: {}", err ? err : sqlite3_errmsg(db_));
+            sqlite3_free(err);
+            return false;
+        };
+
+        if (!exec("BEGIN IMMEDIATE;")) return false;
+        bool success = !replaceAll || exec("DELETE FROM cycle_time_sketches;");
+
+        sqlite3_stmt *stmt = nullptr;
+        success = success && sqlite3_prepare_v2(
+                      db_, "INSERT OR REPLACE INTO cycle_time_sketches (project, metric, digest) VALUES (?, ?, ?);",
+                      -1, &stmt, nullptr) == SQLITE_OK;
+        for (auto it = touched.begin(); success && it != touched.end(); ++it)
+        {
+            const std::string blob = it->second.serialize();
+            sqlite3_bind_int(stmt, 1, it->first.project);
+            sqlite3_bind_int(stmt, 2, it->first.metric);
+            sqlite3_bind_blob(stmt, 3, blob.data(), static_cast<int>(blob.size()), SQLITE_TRANSIENT);
+            success = sqlite3_step(stmt) == SQLITE_DONE;
+            sqlite3_reset(stmt);
+        }
+        sqlite3_finalize(stmt);
+
+        stmt = nullptr;
+        success = success && sqlite3_prepare_v2(
+                      db_, "INSERT OR REPLACE INTO app_metadata (key, value) VALUES (?, ?);", -1, &stmt,
+                      nullptr) == SQLITE_OK;
+        if (success)
+        {
+            const std::string cursor = std::to_string(cursor_);
+            sqlite3_bind_text(stmt, 1, kCursorKey, -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 2, cursor.c_str(), -1, SQLITE_TRANSIENT);
+            success = sqlite3_step(stmt) == SQLITE_DONE;
+        }
+        sqlite3_finalize(stmt);
+
+        if (success && exec("COMMIT;")) return true;
+        spdlog::error("Failed to save cycle-time sketches: {}", sqlite3_errmsg(db_));
+        exec("ROLLBACK;");
+        return false;
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <compare>
+#include <cstdint>
+#include <map>
+
+#include "sqlite3.h"
+#include "tdigest.h"
+#include "todo_card.h"
+
+namespace todo {
+    // Streaming cycle-time percentiles (p50/p85/p95) per project, kept as mergeable t-digests
+    // over card_events. Each sketch is a few hundred bytes however long the history is, and
+    // the sketches of several projects merge into the board-wide one without rereading events.
+    //
+    // Sketches are persisted in cycle_time_sketches along with the card_events id they cover
+    // (app_metadata `sketch_event_cursor`); update() folds in only the events logged since.
+    class CycleTimeSketches
+    {
+    public:
+        // Metrics measured per project, in seconds
+        static constexpr int kLeadTime = -1; // creation to Done
+        static constexpr int kCycleTime = -2; // last move to In Progress (or creation) to Done
+        // Time spent in `from` before moving to `to`
+        static int transitionMetric(const CardStatus from, const CardStatus to)
+        {
+            return statusToInt(from) * 8 + statusToInt(to);
+        }
+
+        static constexpr int kAllProjects = -1;
+
+        struct Key
+        {
+            int project;
+            int metric;
+
+            auto operator<=>(const Key &) const = default;
+        };
+
+        using Sketches = std::map<Key, TDigest>;
+
+        struct Built
+        {
+            Sketches sketches;
+            std::int64_t cursor = 0; // last card_events id included
+        };
+
+        // Loads the persisted sketches through the writer connection
+        explicit CycleTimeSketches(sqlite3 *db);
+
+        CycleTimeSketches(const CycleTimeSketches &) = delete;
+        CycleTimeSketches &operator=(const CycleTimeSketches &) = delete;
+
+        // Folds in card_events logged since the cursor and persists the touched sketches.
+        // Cheap when nothing happened; a no-op while a rebuild is pending. More than
+        // kMaxIncrementalEvents new events are left to a rebuild (needsRebuild() turns true).
+        static constexpr std::int64_t kMaxIncrementalEvents = 5000;
+        bool update();
+
+        // Rebuilds every sketch from card_events with `threads` read-only connections to the
+        // database `db` is open on, each reading a slice of the cards. Safe on any thread.
+        static Built build(sqlite3 *db, unsigned threads);
+
+        // Adopts a build() result and persists it; update() then catches up with the events
+        // logged while it was being built
+        void replace(Built built);
+
+        // True until sketches were built for this database, or after a backlog update() skipped
+        [[nodiscard]] bool needsRebuild() const { return !built_; }
+        void setRebuilding(const bool rebuilding) { rebuilding_ = rebuilding; }
+        [[nodiscard]] bool isRebuilding() const { return rebuilding_; }
+
+        // Value at quantile q, merged across projects for kAllProjects; NaN without samples
+        [[nodiscard]] double quantile(int project, int metric, double q) const;
+        [[nodiscard]] double count(int project, int metric) const;
+
+        // Bumped whenever a sketch changes, so views can cache what they computed from them
+        [[nodiscard]] std::uint64_t version() const { return version_; }
+        [[nodiscard]] const Sketches &sketches() const { return sketches_; }
+
+    private:
+        [[nodiscard]] TDigest merged(int project, int metric) const;
+        bool persist(const Sketches &touched, bool replaceAll) const;
+
+        sqlite3 *db_ = nullptr;
+        Sketches sketches_;
+        std::int64_t cursor_ = 0;
+        std::uint64_t version_ = 0;
+        bool built_ = false;
+        bool rebuilding_ = false;
+    };
+}
@@ -0,0 +1,248 @@
+#include "database_backup.h"
+
+#include <filesystem>
+#include <string_view>
+#include <utility>
+
+#include "spdlog/spdlog.h"
+
+namespace fs = std::filesystem;
+
+namespace todo {
+    DatabaseBackup::DatabaseBackup(sqlite3 *source, std::string backupDir, const int keepCount)
+        : source_(source), backupDir_(std::move(backupDir)), keepCount_(keepCount)
+    {
+        lastBackup_ = std::chrono::steady_clock::now();
+    }
+
+    DatabaseBackup::~DatabaseBackup()
+    {
+        abort();
+    }
+
+    void DatabaseBackup::update(const std::chrono::microseconds budget)
+    {
+        if (!backup_)
+        {
+            const bool due = std::chrono::steady_clock::now() - lastBackup_ >= interval_;
+            if (!due && !backupRequested_) return;
+
+            backupRequested_ = false;
+            lastBackup_ = std::chrono::steady_clock::now();
+            if (!begin()) return;
+        }
+
+        const auto sliceStart = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - sliceStart < budget)
+        {
+            const int rc = sqlite3_backup_step(backup_, kPagesPerStep);
+            if (rc == SQLITE_DONE)
+            {
+                finish();
+                if (!backup_) return;
+                continue;
+            }
+            if (rc == SQLITE_BUSY || rc == SQLITE_LOCKED)
+            {
+                // Someone holds a lock; try again next frame
+                return;
+            }
+            if (rc != SQLITE_OK)
+            {
+                spdlog::error("Backup step failed: {}", sqlite3_errstr(rc));
+                abort();
+                return;
+            }
+        }
+    }
+
+    bool DatabaseBackup::begin()
+    {
+        std::error_code ec;
+        fs::create_directories(backupDir_, ec);
+
+        // main is copied before the archive: a batch archived between the two copies then
+        // shows up in both, which attaching the archive deduplicates, rather than in neither
+        runSchemas_ = schemas();
+        schemaIndex_ = 0;
+        if (!beginSchema()) return false;
+
+        spdlog::info("Database backup started");
+        return true;
+    }
+
+    bool DatabaseBackup::beginSchema()
+    {
+        const std::string &schema = runSchemas_[schemaIndex_];
+        const std::string partial = partialPath(schema);
+        std::error_code ec;
+        fs::remove(partial, ec);
+
+        if (sqlite3_open(partial.c_str(), &destination_) != SQLITE_OK)
+        {
+            spdlog::error("Failed to open backup file {}: {}", partial, sqlite3_errmsg(destination_));
+            abort();
+            return false;
+        }
+
+        backup_ = sqlite3_backup_init(destination_, "main", source_, schema.c_str());
+        if (!backup_)
+        {
+            spdlog::error("Failed to start backup of {}: {}", schema, sqlite3_errmsg(destination_));
+            abort();
+            return false;
+        }
+        return true;
+    }
+
+    void DatabaseBackup::finish()
+    {
+        sqlite3_backup_finish(backup_);
+        backup_ = nullptr;
+        sqlite3_close(destination_);
+        destination_ = nullptr;
+
+        // The next attached database continues in the same run
+        if (++schemaIndex_ < runSchemas_.size())
+        {
+            beginSchema();
+            return;
+        }
+
+        const std::size_t files = runSchemas_.size();
+        rotate();
+        spdlog::info("Database backup complete ({} files) -> {}", files, backupPath("main", 1));
+    }
+
+    void DatabaseBackup::abort()
+    {
+        if (backup_)
+        {
+            sqlite3_backup_finish(backup_);
+            backup_ = nullptr;
+        }
+        if (destination_)
+        {
+            sqlite3_close(destination_);
+            destination_ = nullptr;
+        }
+
+        std::error_code ec;
+        for (const auto &schema: runSchemas_) fs::remove(partialPath(schema), ec);
+        runSchemas_.clear();
+    }
+
+    void DatabaseBackup::rotate()
+    {
+        // todos.(N-1).db -> todos.N.db ... todos.1.db -> todos.2.db, then partial -> todos.1.db,
+        // and the same for each attached database copied in this run
+        std::error_code ec;
+        for (const auto &schema: runSchemas_)
+        {
+            fs::remove(backupPath(schema, keepCount_), ec);
+            for (int i = keepCount_ - 1; i >= 1; i--)
+            {
+                if (fs::exists(backupPath(schema, i), ec))
+                {
+                    fs::rename(backupPath(schema, i), backupPath(schema, i + 1), ec);
+                }
+            }
+            fs::rename(partialPath(schema), backupPath(schema, 1), ec);
+            if (ec)
+            {
+                spdlog::error("Failed to rotate backups of {}: {}", schema, ec.message());
+            }
+        }
+        runSchemas_.clear();
+    }
+
+    bool DatabaseBackup::restoreLatest()
+    {
+        abort();
+
+        if (!fs::exists(backupPath("main", 1)))
+        {
+            spdlog::error("No backup to restore in {}", backupDir_);
+            return false;
+        }
+
+        for (const auto &schema: schemas())
+        {
+            // Backups from before the archive was attached have no copy of it
+            const std::string latest = backupPath(schema, 1);
+            if (schema != "main" && !fs::exists(latest)) continue;
+
+            sqlite3 *backupDb = nullptr;
+            if (sqlite3_open_v2(latest.c_str(), &backupDb, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK)
+            {
+                spdlog::error("Failed to open backup {}: {}", latest, sqlite3_errmsg(backupDb));
+                sqlite3_close(backupDb);
+                return false;
+            }
+
+            // Reverse direction: the live connection is the destination, so every other
+            // connection sees the restored pages through the normal WAL machinery.
+            sqlite3_backup *restore = sqlite3_backup_init(source_, schema.c_str(), backupDb, "main");
+            if (!restore)
+            {
+                spdlog::error("Failed to start restore of {}: {}", schema, sqlite3_errmsg(source_));
+                sqlite3_close(backupDb);
+                return false;
+            }
+
+            const int rc = sqlite3_backup_step(restore, -1);
+            sqlite3_backup_finish(restore);
+            sqlite3_close(backupDb);
+
+            if (rc != SQLITE_DONE)
+            {
+                spdlog::error("Restore of {} failed: {}", schema, sqlite3_errstr(rc));
+                return false;
+            }
+            spdlog::info("Restored {} from {}", schema, latest);
+        }
+        return true;
+    }
+
+    std::vector<std::string> DatabaseBackup::listBackups() const
+    {
+        std::vector<std::string> backups;
+        std::error_code ec;
+        for (int i = 1; i <= keepCount_; i++)
+        {
+            if (fs::exists(backupPath("main", i), ec)) backups.push_back(backupPath("main", i));
+        }
+        return backups;
+    }
+
+    std::vector<std::string> DatabaseBackup::schemas() const
+    {
+        std::vector<std::string> names;
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(source_, "PRAGMA database_list;", -1, &stmt, nullptr) == SQLITE_OK)
+        {
+            while (sqlite3_step(stmt) == SQLITE_ROW)
+            {
+                const auto *name = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1));
+                const auto *file = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 2));
+                // temp and in-memory databases have no file to copy
+                if (name && file && *file && std::string_view(name) != "temp") names.emplace_back(name);
+            }
+        }
+        sqlite3_finalize(stmt);
+
+        // database_list puts main first; make sure it is there even if the query failed
+        if (names.empty() || names.front() != "main") names.insert(names.begin(), "main");
+        return names;
+    }
+
+    std::string DatabaseBackup::backupPath(const std::string &schema, const int index) const
+    {
+        return backupDir_ + "/" + (schema == "main" ? "todos" : schema) + "." + std::to_string(index) + ".db";
+    }
+
+    std::string DatabaseBackup::partialPath(const std::string &schema) const
+    {
+        return backupDir_ + "/" + (schema == "main" ? "todos" : schema) + ".partial.db";
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "sqlite3.h"
+
+namespace todo {
+    // Scheduled hot backup using the SQLite online backup API. The copy advances a few
+    // pages at a time from update(), bounded by a per-frame time slice, so the UI thread
+    // never stalls on a large database. Finished backups rotate as numbered copies
+    // (todos.1.db is the newest) inside the backup directory. Attached databases (the card
+    // archive) are copied in the same run as <schema>.N.db and rotate with main, so the
+    // copies with the same number always belong together.
+    class DatabaseBackup
+    {
+    public:
+        DatabaseBackup(sqlite3 *source, std::string backupDir, int keepCount = 5);
+        ~DatabaseBackup();
+
+        DatabaseBackup(const DatabaseBackup &) = delete;
+        DatabaseBackup &operator=(const DatabaseBackup &) = delete;
+
+        // Advances a scheduled or requested backup for at most `budget`. Call once per frame.
+        void update(std::chrono::microseconds budget);
+
+        void requestBackup() { backupRequested_ = true; }
+        void setInterval(const std::chrono::minutes interval) { interval_ = interval; }
+
+        // Copies the newest backup over the live database and each attached one it has a copy
+        // of. Blocking; user-initiated only.
+        bool restoreLatest();
+
+        [[nodiscard]] bool isRunning() const { return backup_ != nullptr; }
+        [[nodiscard]] std::vector<std::string> listBackups() const;
+
+    private:
+        bool begin();
+        bool beginSchema();
+        void finish();
+        void abort();
+        void rotate();
+        // "main" and every ATTACHed database, in that order
+        [[nodiscard]] std::vector<std::string> schemas() const;
+        [[nodiscard]] std::string backupPath(const std::string &schema, int index) const;
+        [[nodiscard]] std::string partialPath(const std::string &schema) const;
+
+        sqlite3 *source_ = nullptr;
+        sqlite3 *destination_ = nullptr;
+        sqlite3_backup *backup_ = nullptr;
+        std::vector<std::string> runSchemas_; // copied by the running backup
+        std::size_t schemaIndex_ = 0; // the one being copied now
+
+        std::string backupDir_;
+        int keepCount_ = 5;
+
+        // Pages copied per sqlite3_backup_step call; small enough to stay well inside a slice
+        static constexpr int kPagesPerStep = 64;
+
+        std::chrono::minutes interval_{30};
+        std::chrono::steady_clock::time_point lastBackup_;
+        bool backupRequested_ = false;
+    };
+}
@@ -0,0 +1,263 @@
+#include "database_profiler.h"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <chrono>
+
+#include "flight_recorder.h"
+#include "spdlog/spdlog.h"
+
+namespace todo {
+    double DatabaseProfiler::StatementStats::percentileMs(const double p) const
+    {
+        if (count == 0) return 0.0;
+
+        const auto target = static_cast<std::uint64_t>(p * static_cast<double>(count));
+        std::uint64_t seen = 0;
+        for (int i = 0; i < kBucketCount; i++)
+        {
+            seen += buckets[i];
+            if (seen > target || seen == count)
+            {
+                return static_cast<double>(1ull << (i + 1)) / 1000.0;
+            }
+        }
+        return maxNs / 1e6;
+    }
+
+    void DatabaseProfiler::attach(sqlite3 *db, const std::string &name)
+    {
+        {
+            std::lock_guard lock(mutex_);
+            cache_[db].connection = name;
+        }
+        // SQLITE_TRACE_STMT only marks the start time: SQLite's own PROFILE estimate comes
+        // from the VFS clock, which has millisecond resolution on most platforms.
+        sqlite3_trace_v2(db, SQLITE_TRACE_STMT | SQLITE_TRACE_PROFILE, &DatabaseProfiler::traceCallback, this);
+    }
+
+    int DatabaseProfiler::traceCallback(const unsigned type, void *context, void *p, void *x)
+    {
+        // Statements run to completion on the thread that started them, so start times can
+        // live in a small per-thread table instead of behind the profiler mutex
+        struct Running
+        {
+            sqlite3_stmt *stmt;
+            std::chrono::steady_clock::time_point start;
+        };
+        thread_local std::vector<Running> running;
+
+        auto *stmt = static_cast<sqlite3_stmt *>(p);
+
+        if (type == SQLITE_TRACE_STMT)
+        {
+            // Trigger sub-programs report "-- TRIGGER name" text; they belong to the outer statement
+            if (const auto *text = static_cast<const char *>(x); text && text[0] == '-' && text[1] == '-') return 0;
+
+            const auto now = std::chrono::steady_clock::now();
+            for (auto &entry: running)
+            {
+                if (entry.stmt == stmt)
+                {
+                    entry.start = now;
+                    return 0;
+                }
+            }
+            running.push_back({stmt, now});
+            return 0;
+        }
+
+        if (type != SQLITE_TRACE_PROFILE) return 0;
+
+        auto nanoseconds = static_cast<std::uint64_t>(*static_cast<sqlite3_int64 *>(x));
+        for (size_t i = 0; i < running.size(); i++)
+        {
+            if (running[i].stmt != stmt) continue;
+
+            nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - running[i].start).count();
+            running[i] = running.back();
+            running.pop_back();
+            break;
+        }
+
+        if (const char *sql = sqlite3_sql(stmt))
+        {
+            auto *profiler = static_cast<DatabaseProfiler *>(context);
+            profiler->record(sql, nanoseconds);
+            if (FlightRecorder *recorder = profiler->recorder_.load()) recorder->recordStatement(sql, nanoseconds);
+        }
+        return 0;
+    }
+
+    void DatabaseProfiler::record(const std::string_view sql, const std::uint64_t nanoseconds)
+    {
+        const std::uint64_t micros = nanoseconds / 1000;
+        const int bucket = std::min(kBucketCount - 1, micros ? static_cast<int>(std::bit_width(micros)) - 1 : 0);
+
+        std::lock_guard lock(mutex_);
+
+        StatementStats *stats = nullptr;
+        if (const auto raw = rawLookup_.find(sql); raw != rawLookup_.end())
+        {
+            stats = raw->second;
+        } else
+        {
+            // First sighting of this exact text: normalize once and remember the mapping
+            std::string normalized = normalizeSql(sql);
+            auto it = statements_.find(normalized);
+            if (it == statements_.end())
+            {
+                auto created = std::make_unique<StatementStats>();
+                created->sql = normalized;
+                it = statements_.emplace(std::move(normalized), std::move(created)).first;
+            }
+            stats = it->second.get();
+
+            if (rawLookup_.size() < kMaxRawEntries)
+            {
+                rawLookup_.emplace(std::string(sql), stats);
+            }
+        }
+
+        stats->count++;
+        stats->totalNs += nanoseconds;
+        stats->maxNs = std::max(stats->maxNs, nanoseconds);
+        stats->buckets[bucket]++;
+    }
+
+    void DatabaseProfiler::sampleCacheStats(sqlite3 *db)
+    {
+        int hits = 0, misses = 0, writes = 0, used = 0, highWater = 0;
+        sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_HIT, &hits, &highWater, 0);
+        sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_MISS, &misses, &highWater, 0);
+        sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_WRITE, &writes, &highWater, 0);
+        sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_USED, &used, &highWater, 0);
+
+        std::lock_guard lock(mutex_);
+        auto &stats = cache_[db];
+        stats.hits = hits;
+        stats.misses = misses;
+        stats.writes = writes;
+        stats.usedBytes = used;
+    }
+
+    std::vector<DatabaseProfiler::StatementStats> DatabaseProfiler::statementSnapshot() const
+    {
+        std::vector<StatementStats> snapshot;
+        {
+            std::lock_guard lock(mutex_);
+            snapshot.reserve(statements_.size());
+            for (const auto &[sql, stats]: statements_)
+            {
+                snapshot.push_back(*stats);
+            }
+        }
+
+        std::ranges::sort(snapshot, [](const StatementStats &a, const StatementStats &b)
+        {
+            return a.totalNs > b.totalNs;
+        });
+        return snapshot;
+    }
+
+    std::vector<DatabaseProfiler::CacheStats> DatabaseProfiler::cacheSnapshot() const
+    {
+        std::vector<CacheStats> snapshot;
+        std::lock_guard lock(mutex_);
+        for (const auto &[db, stats]: cache_)
+        {
+            snapshot.push_back(stats);
+        }
+        std::ranges::sort(snapshot, [](const CacheStats &a, const CacheStats &b)
+        {
+            return a.connection < b.connection;
+        });
+        return snapshot;
+    }
+
+    void DatabaseProfiler::reset()
+    {
+        std::lock_guard lock(mutex_);
+        for (auto &[sql, stats]: statements_)
+        {
+            const std::string keep = stats->sql;
+            *stats = StatementStats{};
+            stats->sql = keep;
+        }
+    }
+
+    void DatabaseProfiler::logSummary(const int maxStatements) const
+    {
+        const auto statements = statementSnapshot();
+        spdlog::info("SQLite statement profile ({} distinct statements)", statements.size());
+        for (int i = 0; i < std::min<int>(maxStatements, statements.size()); i++)
+        {
+            const auto &stats = statements[i];
+            spdlog::info("  {:>8} calls  total {:>9.2f} ms  mean {:>7.3f} ms  p95 <= {:>7.3f} ms  max {:>7.3f} ms  {}",
+                         stats.count, stats.totalNs / 1e6, stats.meanMs(), stats.percentileMs(0.95),
+                         stats.maxNs / 1e6, stats.sql);
+        }
+
+        for (const auto &cache: cacheSnapshot())
+        {
+            const int lookups = cache.hits + cache.misses;
+            spdlog::info("  page cache [{}]: {} hits, {} misses ({:.1f}% hit rate), {} KiB used",
+                         cache.connection, cache.hits, cache.misses,
+                         lookups ? 100.0 * cache.hits / lookups : 0.0, cache.usedBytes / 1024);
+        }
+    }
+
+    std::string DatabaseProfiler::normalizeSql(const std::string_view sql)
+    {
+        std::string out;
+        out.reserve(sql.size());
+
+        auto isIdentifierChar = [](const char c)
+        {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+        };
+
+        size_t i = 0;
+        while (i < sql.size())
+        {
+            const char c = sql[i];
+
+            if (std::isspace(static_cast<unsigned char>(c)))
+            {
+                // Collapse whitespace runs into a single space
+                while (i < sql.size() && std::isspace(static_cast<unsigned char>(sql[i]))) i++;
+                if (!out.empty() && i < sql.size()) out += ' ';
+                continue;
+            }
+
+            if (c == '\'')
+            {
+                // String literal ('' is an escaped quote)
+                i++;
+                while (i < sql.size())
+                {
+                    if (sql[i] == '\'' && (i + 1 >= sql.size() || sql[i + 1] != '\'')) break;
+                    i += sql[i] == '\'' ? 2 : 1;
+                }
+                i++;
+                out += '?';
+                continue;
+            }
+
+            const bool startsNumber = std::isdigit(static_cast<unsigned char>(c)) &&
+                                      (out.empty() || !isIdentifierChar(out.back()));
+            if (startsNumber)
+            {
+                while (i < sql.size() && (std::isalnum(static_cast<unsigned char>(sql[i])) || sql[i] == '.')) i++;
+                out += '?';
+                continue;
+            }
+
+            out += c;
+            i++;
+        }
+        return out;
+    }
+}
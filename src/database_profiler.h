@@ -0,0 +1,91 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "sqlite3.h"
+
+namespace todo {
+    class FlightRecorder;
+
+    // Per-statement latency histograms fed by sqlite3_trace_v2(SQLITE_TRACE_PROFILE).
+    // Statements are keyed by their normalized SQL (literals replaced with '?'), so the
+    // same query with different values lands in one histogram.
+    class DatabaseProfiler
+    {
+    public:
+        // Bucket i holds statements that took [2^i, 2^(i+1)) microseconds; bucket 0 also holds < 1 us
+        static constexpr int kBucketCount = 24;
+
+        struct StatementStats
+        {
+            std::string sql;
+            std::uint64_t count = 0;
+            std::uint64_t totalNs = 0;
+            std::uint64_t maxNs = 0;
+            std::array<std::uint64_t, kBucketCount> buckets{};
+
+            [[nodiscard]] double meanMs() const { return count ? totalNs / 1e6 / count : 0.0; }
+            // Upper bound of the bucket containing the given percentile, in milliseconds
+            [[nodiscard]] double percentileMs(double p) const;
+        };
+
+        struct CacheStats
+        {
+            std::string connection;
+            int hits = 0;
+            int misses = 0;
+            int writes = 0;
+            int usedBytes = 0;
+        };
+
+        DatabaseProfiler() = default;
+        DatabaseProfiler(const DatabaseProfiler &) = delete;
+        DatabaseProfiler &operator=(const DatabaseProfiler &) = delete;
+
+        // Registers the profile hook on a connection. The profiler must outlive it.
+        void attach(sqlite3 *db, const std::string &name);
+
+        // Reads page cache counters for a connection. Call from the thread that owns it.
+        void sampleCacheStats(sqlite3 *db);
+
+        // Copies of the current statistics, sorted by total time spent (most expensive first)
+        [[nodiscard]] std::vector<StatementStats> statementSnapshot() const;
+        [[nodiscard]] std::vector<CacheStats> cacheSnapshot() const;
+
+        void reset();
+        void logSummary(int maxStatements = 20) const;
+
+        // Every statement is also offered to the recorder, which keeps the ones run on the UI thread
+        void setFlightRecorder(FlightRecorder *recorder) { recorder_ = recorder; }
+
+        static std::string normalizeSql(std::string_view sql);
+
+    private:
+        static int traceCallback(unsigned type, void *context, void *p, void *x);
+        void record(std::string_view sql, std::uint64_t nanoseconds);
+
+        struct StringHash
+        {
+            using is_transparent = void;
+            size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+        };
+
+        mutable std::mutex mutex_;
+
+        // Normalized SQL -> stats
+        std::unordered_map<std::string, std::unique_ptr<StatementStats>, StringHash, std::equal_to<> > statements_;
+        // Raw SQL -> stats, so repeated statements skip normalization on the hot path
+        std::unordered_map<std::string, StatementStats *, StringHash, std::equal_to<> > rawLookup_;
+        static constexpr size_t kMaxRawEntries = 4096;
+
+        std::unordered_map<sqlite3 *, CacheStats> cache_;
+        std::atomic<FlightRecorder *> recorder_ = nullptr;
+    };
+}
@@ -0,0 +1,128 @@
+#include "database_reader.h"
+
+#include <utility>
+
+#include "database_profiler.h"
+#include "job_system.h"
+#include "spdlog/spdlog.h"
+#include "trace.h"
+
+namespace todo {
+    DatabaseReader::DatabaseReader(JobSystem &jobs, std::string dbPath, DatabaseProfiler *profiler,
+                                   std::vector<Attachment> attachments, const int connectionCount)
+        : jobSystem_(jobs), dbPath_(std::move(dbPath)), profiler_(profiler), attachments_(std::move(attachments))
+    {
+        for (int i = 0; i < connectionCount; i++)
+        {
+            workers_.emplace_back(&DatabaseReader::workerLoop, this, i);
+        }
+    }
+
+    DatabaseReader::~DatabaseReader()
+    {
+        {
+            std::lock_guard lock(jobMutex_);
+            stopping_ = true;
+        }
+        jobAvailable_.notify_all();
+
+        for (auto &worker: workers_)
+        {
+            if (worker.joinable()) worker.join();
+        }
+
+        // Dropped here, on the owner's thread: a coroutine read destroys its frame with its job
+        jobs_.clear();
+    }
+
+    void DatabaseReader::submit(Job job, Completion failed)
+    {
+        {
+            std::lock_guard lock(jobMutex_);
+            jobs_.push_back({std::move(job), std::move(failed)});
+        }
+        jobAvailable_.notify_one();
+    }
+
+    void DatabaseReader::workerLoop(const int workerIndex)
+    {
+        setTraceThreadName("db reader " + std::to_string(workerIndex));
+
+        // Each worker owns its connection, so SQLite's per-connection mutex is unnecessary
+        sqlite3 *db = nullptr;
+        const int flags = SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX;
+        if (sqlite3_open_v2(dbPath_.c_str(), &db, flags, nullptr) != SQLITE_OK)
+        {
+            spdlog::error("Failed to open read connection {}: {}", workerIndex, sqlite3_errmsg(db));
+            sqlite3_close(db);
+            db = nullptr;
+        }
+
+        for (const auto &attachment: attachments_)
+        {
+            if (!db) break;
+
+            sqlite3_stmt *stmt = nullptr;
+            const std::string sql = "ATTACH DATABASE ? AS " + attachment.schema + ";";
+            if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK)
+            {
+                sqlite3_bind_text(stmt, 1, attachment.path.c_str(), -1, SQLITE_TRANSIENT);
+                if (sqlite3_step(stmt) != SQLITE_DONE)
+                {
+                    spdlog::warn("Read connection {} could not attach {}: {}", workerIndex, attachment.path,
+                                 sqlite3_errmsg(db));
+                }
+            }
+            sqlite3_finalize(stmt);
+        }
+
+        if (db && profiler_)
+        {
+            profiler_->attach(db, "reader " + std::to_string(workerIndex));
+        }
+
+        while (true)
+        {
+            Request request;
+            {
+                std::unique_lock lock(jobMutex_);
+                jobAvailable_.wait(lock, [&] { return stopping_ || !jobs_.empty(); });
+                if (stopping_) break;
+
+                request = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+
+            Completion completion;
+            if (!db)
+            {
+                spdlog::error("Read connection {} is unavailable; query failed", workerIndex);
+                completion = std::move(request.failed);
+            } else
+            {
+                try
+                {
+                    completion = request.job(db);
+                } catch (const std::exception &e)
+                {
+                    spdlog::error("Read on connection {} failed: {}", workerIndex, e.what());
+                    completion = std::move(request.failed);
+                } catch (...)
+                {
+                    spdlog::error("Read on connection {} failed", workerIndex);
+                    completion = std::move(request.failed);
+                }
+
+                // A job that threw inside BEGIN would otherwise pin its snapshot for every later read
+                if (!sqlite3_get_autocommit(db)) sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+
+                // Cache counters can only be read safely from the thread that owns the connection
+                if (profiler_) profiler_->sampleCacheStats(db);
+            }
+
+            if (completion) jobSystem_.post(std::move(completion));
+        }
+
+        if (db) sqlite3_close(db);
+    }
+}
@@ -0,0 +1,167 @@
+#pragma once
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "sqlite3.h"
+
+namespace todo {
+    class DatabaseProfiler;
+    class JobSystem;
+
+    template<typename Result>
+    class ReadAwaitable;
+
+    // Pool of read-only SQLite connections, each owned by its own worker thread.
+    // With the writer connection in WAL mode, queries submitted here read a consistent
+    // snapshot without ever blocking (or being blocked by) writes on the UI thread.
+    // Connections are tied to their threads, so these are separate from the JobSystem
+    // workers; completions go through the JobSystem's UI-thread queue all the same.
+    class DatabaseReader
+    {
+    public:
+        // Runs on the UI thread once the query has finished
+        using Completion = std::function<void()>;
+        // Runs on a worker against its read-only connection and returns the UI-side continuation
+        using Job = std::function<Completion(sqlite3 *)>;
+
+        // Extra database files ATTACHed (read-only) to every worker connection
+        struct Attachment
+        {
+            std::string schema;
+            std::string path;
+        };
+
+        DatabaseReader(JobSystem &jobs, std::string dbPath, DatabaseProfiler *profiler = nullptr,
+                       std::vector<Attachment> attachments = {}, int connectionCount = 2);
+        ~DatabaseReader();
+
+        DatabaseReader(const DatabaseReader &) = delete;
+        DatabaseReader &operator=(const DatabaseReader &) = delete;
+
+        // `failed` runs on the UI thread instead of the job's completion when the worker has no
+        // connection or the job throws, so state waiting on the result can be cleared
+        void submit(Job job, Completion failed = nullptr);
+
+        // Convenience wrapper: `read` runs on a worker, `apply` receives its result on the UI thread
+        template<typename Result>
+        void query(std::function<Result(sqlite3 *)> read, std::function<void(Result &)> apply,
+                   Completion failed = nullptr)
+        {
+            submit([read = std::move(read), apply = std::move(apply)](sqlite3 *db) -> Completion
+            {
+                auto result = std::make_shared<Result>(read(db));
+                return [apply, result]() { apply(*result); };
+            }, std::move(failed));
+        }
+
+        // Awaitable form of query() for UI coroutines (ui_task.h): `read` runs on a worker and
+        // `co_await` resumes on the UI thread with its result
+        template<typename Result>
+        ReadAwaitable<Result> read(std::function<Result(sqlite3 *)> read);
+
+    private:
+        struct Request
+        {
+            Job job;
+            Completion failed;
+        };
+
+        void workerLoop(int workerIndex);
+
+        JobSystem &jobSystem_;
+        std::string dbPath_;
+        DatabaseProfiler *profiler_ = nullptr;
+        std::vector<Attachment> attachments_;
+
+        std::mutex jobMutex_;
+        std::condition_variable jobAvailable_;
+        std::deque<Request> jobs_;
+        bool stopping_ = false;
+
+        std::vector<std::thread> workers_;
+    };
+
+    template<typename Result>
+    class ReadAwaitable
+    {
+    public:
+        ReadAwaitable(DatabaseReader &reader, std::function<Result(sqlite3 *)> read)
+            : reader_(reader), read_(std::move(read))
+        {
+        }
+
+        [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            // The awaitable lives in the suspended frame, so the worker writes the result
+            // straight into it. Whoever holds `resumption` last either resumes the frame on
+            // the UI thread or, when the read is dropped at shutdown, destroys it there too:
+            // a worker only ever holds it alongside the completion or failure it posts.
+            auto resumption = std::make_shared<Resumption>(handle);
+            reader_.submit([this, resumption](sqlite3 *db) -> DatabaseReader::Completion
+            {
+                try
+                {
+                    result_.emplace(read_(db));
+                } catch (...)
+                {
+                    error_ = std::current_exception();
+                }
+                return [resumption] { resumption->resume(); };
+            }, [this, resumption]
+            {
+                error_ = std::make_exception_ptr(std::runtime_error("Read connection unavailable"));
+                resumption->resume();
+            });
+        }
+
+        Result await_resume()
+        {
+            if (error_) std::rethrow_exception(error_);
+            return std::move(*result_);
+        }
+
+    private:
+        struct Resumption
+        {
+            explicit Resumption(const std::coroutine_handle<> handle) : handle(handle)
+            {
+            }
+
+            ~Resumption()
+            {
+                if (handle) handle.destroy();
+            }
+
+            Resumption(const Resumption &) = delete;
+            Resumption &operator=(const Resumption &) = delete;
+
+            void resume() { std::exchange(handle, nullptr).resume(); }
+
+            std::coroutine_handle<> handle;
+        };
+
+        DatabaseReader &reader_;
+        std::function<Result(sqlite3 *)> read_;
+        std::optional<Result> result_;
+        std::exception_ptr error_;
+    };
+
+    template<typename Result>
+    ReadAwaitable<Result> DatabaseReader::read(std::function<Result(sqlite3 *)> read)
+    {
+        return ReadAwaitable<Result>(*this, std::move(read));
+    }
+}
@@ -0,0 +1,169 @@
+#include "database_watcher.h"
+
+#include <filesystem>
+#include <utility>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "card_database.h"
+#include "spdlog/spdlog.h"
+#include "sqlite3.h"
+#include "trace.h"
+
+namespace todo {
+    namespace {
+        // PRAGMA data_version for one connection, with the statement prepared once
+        class DataVersion
+        {
+        public:
+            explicit DataVersion(const std::string &dbPath)
+            {
+                const int flags = SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX;
+                if (sqlite3_open_v2(dbPath.c_str(), &db_, flags, nullptr) != SQLITE_OK ||
+                    sqlite3_prepare_v2(db_, "PRAGMA data_version;", -1, &stmt_, nullptr) != SQLITE_OK)
+                {
+                    spdlog::error("Database watcher could not open {}: {}", dbPath, sqlite3_errmsg(db_));
+                    return;
+                }
+                CardDatabase::installBusyHandler(db_);
+                last_ = read();
+            }
+
+            ~DataVersion()
+            {
+                sqlite3_finalize(stmt_);
+                sqlite3_close(db_);
+            }
+
+            // True when another connection committed since the last call
+            bool changed()
+            {
+                if (!stmt_) return false;
+                const std::int64_t version = read();
+                if (version == last_) return false;
+                last_ = version;
+                return true;
+            }
+
+        private:
+            std::int64_t read()
+            {
+                std::int64_t version = last_;
+                if (sqlite3_step(stmt_) == SQLITE_ROW) version = sqlite3_column_int64(stmt_, 0);
+                sqlite3_reset(stmt_);
+                return version;
+            }
+
+            sqlite3 *db_ = nullptr;
+            sqlite3_stmt *stmt_ = nullptr;
+            std::int64_t last_ = 0;
+        };
+    }
+
+    DatabaseWatcher::DatabaseWatcher(std::string dbPath, std::function<void()> onChange)
+        : dbPath_(std::move(dbPath)), onChange_(std::move(onChange))
+    {
+#ifdef __linux__
+        wakeFd_ = eventfd(0, EFD_CLOEXEC);
+#endif
+        thread_ = std::thread(&DatabaseWatcher::run, this);
+    }
+
+    DatabaseWatcher::~DatabaseWatcher()
+    {
+        {
+            std::lock_guard lock(stopMutex_);
+            stopping_ = true;
+        }
+        stopRequested_.notify_all();
+#ifdef __linux__
+        if (wakeFd_ >= 0)
+        {
+            const std::uint64_t one = 1;
+            [[maybe_unused]] const auto written = write(wakeFd_, &one, sizeof(one));
+        }
+#endif
+
+        if (thread_.joinable()) thread_.join();
+#ifdef __linux__
+        if (wakeFd_ >= 0) close(wakeFd_);
+#endif
+    }
+
+    void DatabaseWatcher::run()
+    {
+        setTraceThreadName("db watcher");
+        DataVersion version(dbPath_);
+
+#ifdef __linux__
+        // Watch the directory rather than the files: the -wal file is deleted and recreated
+        // as connections come and go, which would silently end a watch on the file itself
+        const std::filesystem::path path(dbPath_);
+        const std::string dbName = path.filename().string();
+        const std::string walName = dbName + "-wal";
+
+        const int inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyFd >= 0 && wakeFd_ >= 0 &&
+            inotify_add_watch(inotifyFd, path.parent_path().c_str(), IN_MODIFY | IN_CREATE | IN_MOVED_TO) >= 0)
+        {
+            // The long timeout is a safety net for writes inotify cannot see (network
+            // filesystems). A WAL write can be reported before its commit is visible, so an
+            // event that shows no new data_version is rechecked shortly after.
+            constexpr int kFallbackTimeoutMs = 1000;
+            constexpr int kRecheckTimeoutMs = 10;
+            bool recheck = false;
+
+            alignas(inotify_event) char events[4096];
+            pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {wakeFd_, POLLIN, 0}};
+            while (true)
+            {
+                if (poll(fds, 2, recheck ? kRecheckTimeoutMs : kFallbackTimeoutMs) < 0 && errno != EINTR) break;
+                if (fds[1].revents & POLLIN) break;
+
+                bool written = false;
+                ssize_t length;
+                while ((length = read(inotifyFd, events, sizeof(events))) > 0)
+                {
+                    for (const char *p = events; p < events + length;)
+                    {
+                        const auto *event = reinterpret_cast<const inotify_event *>(p);
+                        if (event->len > 0 && (dbName == event->name || walName == event->name)) written = true;
+                        p += sizeof(inotify_event) + event->len;
+                    }
+                }
+
+                const bool timedOut = (fds[0].revents & POLLIN) == 0;
+                if (!written && !timedOut) continue;
+
+                if (version.changed())
+                {
+                    recheck = false;
+                    onChange_();
+                }
+                else
+                {
+                    recheck = written;
+                }
+            }
+            close(inotifyFd);
+            return;
+        }
+
+        spdlog::warn("inotify unavailable for {}; polling for changes instead", dbPath_);
+        if (inotifyFd >= 0) close(inotifyFd);
+#endif
+
+        std::unique_lock lock(stopMutex_);
+        while (!stopRequested_.wait_for(lock, kPollInterval, [this] { return stopping_; }))
+        {
+            lock.unlock();
+            if (version.changed()) onChange_();
+            lock.lock();
+        }
+    }
+}
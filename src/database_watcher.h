@@ -0,0 +1,39 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace todo {
+    // Notices commits to the database made by any connection, in this process or another one,
+    // and calls `onChange` from its own thread. The check is PRAGMA data_version on a private
+    // read-only connection, which only changes when another connection commits and costs no
+    // table access. On Linux the check runs when inotify reports a write to the database or
+    // its -wal file; elsewhere it is polled every kPollInterval.
+    class DatabaseWatcher
+    {
+    public:
+        DatabaseWatcher(std::string dbPath, std::function<void()> onChange);
+        ~DatabaseWatcher();
+
+        DatabaseWatcher(const DatabaseWatcher &) = delete;
+        DatabaseWatcher &operator=(const DatabaseWatcher &) = delete;
+
+        static constexpr std::chrono::milliseconds kPollInterval{50};
+
+    private:
+        void run();
+
+        std::string dbPath_;
+        std::function<void()> onChange_;
+
+        std::mutex stopMutex_;
+        std::condition_variable stopRequested_;
+        bool stopping_ = false;
+        int wakeFd_ = -1; // eventfd that interrupts the inotify wait (Linux)
+
+        std::thread thread_;
+    };
+}
@@ -0,0 +1,235 @@
+#include "delivery_forecast.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "board_stats.h"
+#include "card_database.h"
+#include "spdlog/spdlog.h"
+
+namespace todo {
+    namespace {
+        constexpr int kChunkTrials = 1024;
+
+        std::uint64_t splitMix64(std::uint64_t &state)
+        {
+            std::uint64_t z = (state += 0x9e3779b97f4a7c15);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            return z ^ (z >> 31);
+        }
+
+        // Eight xoshiro256+ generators stepped in lockstep. The state is stored lane-innermost,
+        // so every step is one operation over adjacent words and the compiler emits it as SIMD.
+        class XoshiroLanes
+        {
+        public:
+            static constexpr int kLanes = 8;
+
+            explicit XoshiroLanes(std::uint64_t seed)
+            {
+                for (int lane = 0; lane < kLanes; lane++)
+                {
+                    s0_[lane] = splitMix64(seed);
+                    s1_[lane] = splitMix64(seed);
+                    s2_[lane] = splitMix64(seed);
+                    s3_[lane] = splitMix64(seed);
+                }
+            }
+
+            void next(std::uint64_t (&out)[kLanes])
+            {
+                for (int lane = 0; lane < kLanes; lane++)
+                {
+                    out[lane] = s0_[lane] + s3_[lane];
+                    const std::uint64_t t = s1_[lane] << 17;
+                    s2_[lane] ^= s0_[lane];
+                    s3_[lane] ^= s1_[lane];
+                    s1_[lane] ^= s2_[lane];
+                    s0_[lane] ^= s3_[lane];
+                    s2_[lane] ^= t;
+                    s3_[lane] = (s3_[lane] << 45) | (s3_[lane] >> 19);
+                }
+            }
+
+        private:
+            alignas(64) std::uint64_t s0_[kLanes];
+            alignas(64) std::uint64_t s1_[kLanes];
+            alignas(64) std::uint64_t s2_[kLanes];
+            alignas(64) std::uint64_t s3_[kLanes];
+        };
+
+        // Runs `count` trials, one per lane at a time, and counts their lengths into `histogram`
+        // (index kMaxForecastDays means "not done by then")
+        void runTrials(std::span<const int> throughput, const int remaining, const int count, const std::uint64_t seed,
+                       std::vector<std::uint32_t> &histogram)
+        {
+            constexpr int kLanes = XoshiroLanes::kLanes;
+            XoshiroLanes rng(seed);
+            const std::uint64_t days = throughput.size();
+
+            int done[kLanes] = {};
+            int elapsed[kLanes] = {};
+            bool active[kLanes] = {};
+            int started = 0;
+            int finished = 0;
+            for (int lane = 0; lane < kLanes && started < count; lane++, started++) active[lane] = true;
+
+            std::uint64_t random[kLanes];
+            while (finished < count)
+            {
+                rng.next(random);
+                for (int lane = 0; lane < kLanes; lane++)
+                {
+                    if (!active[lane]) continue;
+
+                    // Multiply-shift maps the high 32 bits onto [0, days) without a division
+                    done[lane] += throughput[((random[lane] >> 32) * days) >> 32];
+                    if (++elapsed[lane] < kMaxForecastDays && done[lane] < remaining) continue;
+
+                    histogram[static_cast<size_t>(elapsed[lane])]++;
+                    finished++;
+                    done[lane] = 0;
+                    elapsed[lane] = 0;
+                    active[lane] = started < count;
+                    if (active[lane]) started++;
+                }
+            }
+        }
+
+        // Age of a YYYY-MM-DD day in days, clamped to [0, kMaxForecastDays]
+        size_t daysAgo(const std::string &day)
+        {
+            using namespace std::chrono;
+            int y = 0;
+            unsigned m = 0, d = 0;
+            if (std::sscanf(day.c_str(), "%d-%u-%u", &y, &m, &d) != 3) return 0;
+            const auto age = (floor<std::chrono::days>(system_clock::now()) - sys_days(year{y} / month{m} / d)).count();
+            return static_cast<size_t>(std::clamp<std::int64_t>(age, 0, kMaxForecastDays));
+        }
+
+        std::string dateAfterDays(const int days)
+        {
+            using namespace std::chrono;
+            const year_month_day date{floor<std::chrono::days>(system_clock::now()) + std::chrono::days{days}};
+            char text[16];
+            std::snprintf(text, sizeof(text), "%04d-%02u-%02u", static_cast<int>(date.year()),
+                          static_cast<unsigned>(date.month()), static_cast<unsigned>(date.day()));
+            return text;
+        }
+    }
+
+    DeliveryForecast simulateDelivery(std::span<const int> throughput, const int remaining, const int trials,
+                                      unsigned threads, const std::uint64_t seed)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        DeliveryForecast forecast;
+        forecast.remaining = remaining;
+        forecast.historyDays = static_cast<int>(throughput.size());
+        forecast.trials = std::max(trials, 1);
+
+        if (remaining <= 0)
+        {
+            for (size_t i = 0; i < std::size(kForecastConfidence); i++)
+            {
+                forecast.days[i] = 0;
+                forecast.dates[i] = dateAfterDays(0);
+            }
+            return forecast;
+        }
+        if (std::ranges::none_of(throughput, [](const int completed) { return completed > 0; })) return forecast;
+
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        const int chunks = (forecast.trials + kChunkTrials - 1) / kChunkTrials;
+        threads = std::min<unsigned>(threads, static_cast<unsigned>(chunks));
+
+        // Small chunks from a shared counter: a thread that finishes early (or started late)
+        // takes more of the work instead of leaving the others to finish theirs
+        std::atomic<int> nextChunk = 0;
+        std::vector<std::vector<std::uint32_t>> histograms(threads,
+                                                           std::vector<std::uint32_t>(kMaxForecastDays + 1));
+        auto work = [&](const unsigned thread)
+        {
+            for (int chunk = nextChunk++; chunk < chunks; chunk = nextChunk++)
+            {
+                const int count = std::min(kChunkTrials, forecast.trials - chunk * kChunkTrials);
+                runTrials(throughput, remaining, count, seed + static_cast<std::uint64_t>(chunk), histograms[thread]);
+            }
+        };
+
+        std::vector<std::jthread> workers;
+        workers.reserve(threads - 1);
+        for (unsigned thread = 1; thread < threads; thread++) workers.emplace_back(work, thread);
+        work(0);
+        workers.clear();
+
+        std::vector<std::uint64_t> histogram(kMaxForecastDays + 1);
+        for (const auto &partial: histograms)
+        {
+            for (size_t day = 0; day < partial.size(); day++) histogram[day] += partial[day];
+        }
+
+        for (size_t i = 0; i < std::size(kForecastConfidence); i++)
+        {
+            const auto target = static_cast<std::uint64_t>(kForecastConfidence[i] * forecast.trials);
+            std::uint64_t cumulative = 0;
+            int day = 0;
+            while (day < kMaxForecastDays && (cumulative += histogram[static_cast<size_t>(day)]) < target) day++;
+            if (day >= kMaxForecastDays) continue;
+            forecast.days[i] = day;
+            forecast.dates[i] = dateAfterDays(day);
+        }
+
+        forecast.milliseconds = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        return forecast;
+    }
+
+    DeliveryForecast forecastDelivery(sqlite3 *db, const int projectId, const int historyDays, const int trials,
+                                      const unsigned threads)
+    {
+        // One read transaction, so the open cards and the throughput describe the same board
+        sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+        const std::vector<DailyStats> stats = CardDatabase::readDailyStats(db, historyDays, projectId);
+
+        int remaining = 0;
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(db, "SELECT COUNT(*) FROM cards WHERE status IN (0, 1) AND project = ?;", -1, &stmt,
+                               nullptr) == SQLITE_OK)
+        {
+            sqlite3_bind_int(stmt, 1, projectId);
+            if (sqlite3_step(stmt) == SQLITE_ROW) remaining = sqlite3_column_int(stmt, 0);
+        } else
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(db));
+        }
+        sqlite3_finalize(stmt);
+        sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+
+        // Rollup rows exist only for days with activity. Days before the first of them, when the
+        // project did not exist yet, would otherwise be resampled as zero throughput.
+        const StatsSummary summary = summarizeDailyStats(stats, historyDays);
+        const size_t days = summary.completedPerDay.size();
+        size_t first = days;
+        if (!stats.empty())
+        {
+            const size_t age = daysAgo(stats.front().day);
+            first = age < days ? days - age - 1 : 0;
+        }
+
+        std::vector<int> throughput;
+        for (size_t day = first; day < days; day++)
+        {
+            throughput.push_back(static_cast<int>(summary.completedPerDay[day]));
+        }
+
+        DeliveryForecast forecast = simulateDelivery(throughput, remaining, trials, threads);
+        forecast.projectId = projectId;
+        return forecast;
+    }
+}
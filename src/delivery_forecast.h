@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include "sqlite3.h"
+
+namespace todo {
+    // Monte Carlo "when will it be done" forecast: each trial replays days drawn at random from
+    // the project's recent daily throughput until its open cards are all completed. The spread
+    // of the trials' lengths gives the completion date at each confidence level.
+    inline constexpr double kForecastConfidence[] = {0.50, 0.85, 0.95};
+    inline constexpr int kMaxForecastDays = 3650;
+
+    struct DeliveryForecast
+    {
+        int projectId = 0;
+        int remaining = 0; // Todo and In Progress cards; in-progress ones finish ahead of the Todo column
+        int historyDays = 0; // days of throughput resampled
+        int trials = 0;
+        double milliseconds = 0.0;
+        // Days from today until done at each kForecastConfidence level, and the dates (UTC).
+        // -1 and empty when it cannot be forecast: nothing completed in the history, or later
+        // than kMaxForecastDays.
+        int days[3] = {-1, -1, -1};
+        std::string dates[3];
+    };
+
+    // The simulation alone, over completions per day. Trials are handed out in chunks that idle
+    // threads take from a shared counter, each chunk seeded by its index, so the result does
+    // not depend on `threads` (0 = one per core).
+    DeliveryForecast simulateDelivery(std::span<const int> throughput, int remaining, int trials,
+                                      unsigned threads = 0, std::uint64_t seed = 0x9e3779b97f4a7c15);
+
+    // Throughput comes from project_daily_stats, so reading it costs one row per day however
+    // large the board is. Meant for a read worker.
+    DeliveryForecast forecastDelivery(sqlite3 *db, int projectId, int historyDays = 90, int trials = 100000,
+                                      unsigned threads = 0);
+}
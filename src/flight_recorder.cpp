@@ -0,0 +1,199 @@
+#include "flight_recorder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+
+#include "job_system.h"
+#include "spdlog/spdlog.h"
+
+namespace todo {
+    namespace {
+        // Events after the slow frame that still go into its dump
+        constexpr std::chrono::milliseconds kTail{500};
+
+        constexpr int kFrameTrack = 1;
+        constexpr int kPhaseTrack = 2;
+        constexpr int kStatementTrack = 3;
+        constexpr int kInputTrack = 4;
+
+        void writeEscaped(std::FILE *file, const char *text)
+        {
+            for (; *text; text++)
+            {
+                const char c = *text;
+                if (c == '"' || c == '\\') std::fputc('\\', file);
+                if (static_cast<unsigned char>(c) < 0x20) std::fputc(' ', file);
+                else std::fputc(c, file);
+            }
+        }
+
+        bool writeDump(const std::string &path, const std::vector<FlightRecorder::Event> &events)
+        {
+            std::FILE *file = std::fopen(path.c_str(), "w");
+            if (!file) return false;
+
+            const std::int64_t origin = events.empty() ? 0 : events.front().start;
+            auto micros = [origin](const std::int64_t ns) { return static_cast<double>(ns - origin) / 1000.0; };
+
+            std::fputs("{\"traceEvents\": [\n", file);
+            const std::pair<int, const char *> tracks[] = {
+                {kFrameTrack, "frames"}, {kPhaseTrack, "phases"}, {kStatementTrack, "statements"},
+                {kInputTrack, "input"}
+            };
+            for (const auto &[tid, name]: tracks)
+            {
+                std::fprintf(file, R"({"name":"thread_name","ph":"M","pid":1,"tid":%d,"args":{"name":"%s"}},)" "\n",
+                             tid, name);
+            }
+
+            bool first = true;
+            for (const auto &event: events)
+            {
+                if (!first) std::fputs(",\n", file);
+                first = false;
+
+                std::fputs(R"({"name":")", file);
+                writeEscaped(file, event.kind == FlightRecorder::Kind::Frame ? "frame" : event.label);
+                if (event.kind == FlightRecorder::Kind::Input)
+                {
+                    std::fprintf(file, R"(","ph":"i","s":"t","pid":1,"tid":%d,"ts":%.3f})", kInputTrack,
+                                 micros(event.start));
+                    continue;
+                }
+
+                const int tid = event.kind == FlightRecorder::Kind::Frame
+                                    ? kFrameTrack
+                                    : event.kind == FlightRecorder::Kind::Phase
+                                          ? kPhaseTrack
+                                          : kStatementTrack;
+                std::fprintf(file, R"(","ph":"X","pid":1,"tid":%d,"ts":%.3f,"dur":%.3f,)", tid, micros(event.start),
+                             static_cast<double>(event.end - event.start) / 1000.0);
+                std::fprintf(file, R"("args":{"frame":%u,"allocations":%llu,"bytes":%llu}})", event.frame,
+                             static_cast<unsigned long long>(event.allocations.count),
+                             static_cast<unsigned long long>(event.allocations.bytes));
+            }
+            std::fputs("\n]}\n", file);
+            return std::fclose(file) == 0;
+        }
+    }
+
+    FlightRecorder::FlightRecorder(std::string dumpDirectory, const std::chrono::milliseconds budget,
+                                   const std::chrono::seconds window)
+        : dumpDirectory_(std::move(dumpDirectory)), budget_(budget), window_(window),
+          owner_(std::this_thread::get_id()), events_(kCapacity)
+    {
+    }
+
+    std::int64_t FlightRecorder::now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void FlightRecorder::push(const Kind kind, const std::string_view label, const std::int64_t start,
+                              const std::int64_t end, const AllocationCount allocations)
+    {
+        Event &event = events_[next_];
+        event.start = start;
+        event.end = end;
+        event.allocations = allocations;
+        event.frame = frame_;
+        event.kind = kind;
+        const std::size_t length = std::min(label.size(), sizeof(event.label) - 1);
+        std::memcpy(event.label, label.data(), length);
+        event.label[length] = '\0';
+
+        if (kind == Kind::Phase && phaseCount_ < kMaxPhases) phases_[phaseCount_++] = event;
+
+        next_ = (next_ + 1) % kCapacity;
+        size_ = std::min(size_ + 1, kCapacity);
+    }
+
+    void FlightRecorder::beginFrame()
+    {
+        frame_++;
+        frameStart_ = now();
+        frameAllocations_ = threadAllocations();
+        phaseCount_ = 0;
+    }
+
+    bool FlightRecorder::endFrame(JobSystem &jobs)
+    {
+        const std::int64_t end = now();
+        push(Kind::Frame, {}, frameStart_, end, threadAllocations() - frameAllocations_);
+        lastFrame_ = events_[(next_ + kCapacity - 1) % kCapacity];
+        lastPhases_ = phases_;
+        lastPhaseCount_ = phaseCount_;
+
+        const bool slow = end - frameStart_ > std::chrono::nanoseconds(budget_).count();
+        if (slow)
+        {
+            slowFrames_++;
+            if (dumpAt_ == 0 && end >= quietUntil_)
+            {
+                dumpAt_ = end + std::chrono::nanoseconds(kTail).count();
+                spdlog::warn("Frame {} took {:.1f} ms (budget {} ms)", frame_,
+                             static_cast<double>(end - frameStart_) / 1e6, budget_.count());
+            }
+        }
+
+        if (dumpAt_ != 0 && end >= dumpAt_) dump(jobs);
+        return slow;
+    }
+
+    void FlightRecorder::dump(JobSystem &jobs)
+    {
+        const std::int64_t from = dumpAt_ - std::chrono::nanoseconds(window_).count();
+        quietUntil_ = dumpAt_ + std::chrono::nanoseconds(window_).count();
+        dumpAt_ = 0;
+
+        // Oldest first; the copy is the only allocation the recorder makes after construction
+        auto events = std::make_shared<std::vector<Event>>();
+        events->reserve(size_);
+        for (std::size_t i = 0; i < size_; i++)
+        {
+            const Event &event = events_[(next_ + kCapacity - size_ + i) % kCapacity];
+            if (event.end >= from) events->push_back(event);
+        }
+
+        const std::string path = dumpDirectory_ + "/slow-frame-" + std::to_string(dumps_ % kDumpFiles) + ".json";
+        dumps_++;
+        jobs.submit([path, events]
+        {
+            std::error_code ec;
+            std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+            if (writeDump(path, *events)) spdlog::info("Slow frame trace written to {}", path);
+            else spdlog::error("Failed to write slow frame trace {}", path);
+        });
+    }
+
+    FlightRecorder::Phase::Phase(FlightRecorder &recorder, const char *label)
+        : recorder_(recorder), label_(label), start_(now()), allocations_(threadAllocations())
+    {
+    }
+
+    FlightRecorder::Phase::~Phase()
+    {
+        recorder_.push(Kind::Phase, label_, start_, now(), threadAllocations() - allocations_);
+    }
+
+    void FlightRecorder::recordStatement(const std::string_view sql, const std::uint64_t nanoseconds)
+    {
+        // Statements on read workers do not hold up a frame
+        if (std::this_thread::get_id() != owner_) return;
+
+        const std::int64_t end = now();
+        push(Kind::Statement, sql, end - static_cast<std::int64_t>(nanoseconds), end);
+    }
+
+    void FlightRecorder::mark(const std::string_view label)
+    {
+        if (std::this_thread::get_id() != owner_) return;
+
+        const std::int64_t at = now();
+        push(Kind::Input, label, at, at);
+    }
+}
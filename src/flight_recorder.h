@@ -0,0 +1,125 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "allocation_stats.h"
+
+namespace todo {
+    class JobSystem;
+
+    // Always-on record of the UI thread's recent frames: phase timings, statements on the writer
+    // connection, allocations and input events, in a fixed ring of the last kCapacity events.
+    // When a frame runs over budget, the events of the preceding window (plus a short tail, to
+    // show what followed) are written as Chrome trace JSON to a rotating set of files.
+    //
+    // Recording is a few clock reads and a copy into the ring; nothing allocates or locks until
+    // a dump, which is snapshotted on the UI thread and written on a job worker.
+    class FlightRecorder
+    {
+    public:
+        enum class Kind : std::uint8_t
+        {
+            Frame,
+            Phase,
+            Statement,
+            Input
+        };
+
+        struct Event
+        {
+            std::int64_t start = 0; // steady clock, ns
+            std::int64_t end = 0;
+            AllocationCount allocations;
+            std::uint32_t frame = 0;
+            Kind kind = Kind::Phase;
+            char label[39] = {};
+        };
+
+        static constexpr std::size_t kCapacity = 32768;
+        static constexpr int kDumpFiles = 5;
+        // Phases kept per frame for lastFramePhases(); any beyond this are still recorded in the ring
+        static constexpr std::size_t kMaxPhases = 16;
+
+        // Only the constructing thread records; calls from any other thread are ignored
+        explicit FlightRecorder(std::string dumpDirectory,
+                                std::chrono::milliseconds budget = std::chrono::milliseconds(33),
+                                std::chrono::seconds window = std::chrono::seconds(10));
+
+        FlightRecorder(const FlightRecorder &) = delete;
+        FlightRecorder &operator=(const FlightRecorder &) = delete;
+
+        void beginFrame();
+        // Returns true when the frame went over budget; a pending dump is written from here
+        bool endFrame(JobSystem &jobs);
+
+        // Times a part of the frame, with the allocations made during it
+        class Phase
+        {
+        public:
+            Phase(FlightRecorder &recorder, const char *label);
+            ~Phase();
+
+            Phase(const Phase &) = delete;
+            Phase &operator=(const Phase &) = delete;
+
+        private:
+            FlightRecorder &recorder_;
+            const char *label_;
+            std::int64_t start_;
+            AllocationCount allocations_;
+        };
+
+        // From DatabaseProfiler, on whichever thread ran the statement
+        void recordStatement(std::string_view sql, std::uint64_t nanoseconds);
+        // Drag and drop and similar one-off input
+        void mark(std::string_view label);
+
+        void setBudget(std::chrono::milliseconds budget) { budget_ = budget; }
+        [[nodiscard]] std::chrono::milliseconds budget() const { return budget_; }
+        [[nodiscard]] std::uint32_t slowFrames() const { return slowFrames_; }
+        [[nodiscard]] int dumps() const { return dumps_; }
+
+        // The last completed frame and its phases, in the order they finished
+        [[nodiscard]] const Event &lastFrame() const { return lastFrame_; }
+        [[nodiscard]] std::span<const Event> lastFramePhases() const
+        {
+            return {lastPhases_.data(), lastPhaseCount_};
+        }
+
+    private:
+        static std::int64_t now();
+        void push(Kind kind, std::string_view label, std::int64_t start, std::int64_t end,
+                  AllocationCount allocations = {});
+        void dump(JobSystem &jobs);
+
+        std::string dumpDirectory_;
+        std::chrono::milliseconds budget_;
+        std::chrono::seconds window_;
+        std::thread::id owner_;
+
+        std::vector<Event> events_; // kCapacity, allocated once
+        std::size_t next_ = 0;
+        std::size_t size_ = 0;
+
+        std::uint32_t frame_ = 0;
+        std::int64_t frameStart_ = 0;
+        AllocationCount frameAllocations_;
+
+        Event lastFrame_;
+        std::array<Event, kMaxPhases> phases_{};
+        std::size_t phaseCount_ = 0;
+        std::array<Event, kMaxPhases> lastPhases_{};
+        std::size_t lastPhaseCount_ = 0;
+
+        std::uint32_t slowFrames_ = 0;
+        int dumps_ = 0;
+        std::int64_t dumpAt_ = 0; // 0 = none pending
+        std::int64_t quietUntil_ = 0; // one dump per window, however long a stutter lasts
+    };
+}
@@ -0,0 +1,70 @@
+#include "frame_arena.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+
+namespace todo {
+    FrameArena::FrameArena(const std::size_t initialBytes)
+        : block_(std::make_unique<std::byte[]>(initialBytes)), size_(initialBytes)
+    {
+    }
+
+    void FrameArena::reset()
+    {
+        if (!retired_.empty())
+        {
+            // Grow to what the frame needed so the next one fits in a single block
+            const std::size_t needed = retiredBytes_ + size_;
+            retired_.clear();
+            retiredBytes_ = 0;
+            block_ = std::make_unique<std::byte[]>(needed);
+            size_ = needed;
+        }
+        offset_ = 0;
+    }
+
+    void *FrameArena::do_allocate(const std::size_t bytes, const std::size_t alignment)
+    {
+        auto aligned = [&](const std::size_t offset)
+        {
+            const auto address = reinterpret_cast<std::uintptr_t>(block_.get()) + offset;
+            return offset + ((alignment - address % alignment) % alignment);
+        };
+
+        std::size_t start = aligned(offset_);
+        if (start + bytes > size_)
+        {
+            retiredBytes_ += size_;
+            retired_.push_back(std::move(block_));
+            size_ = std::max(size_ * 2, bytes + alignment);
+            block_ = std::make_unique<std::byte[]>(size_);
+            start = aligned(0);
+        }
+
+        offset_ = start + bytes;
+        return block_.get() + start;
+    }
+
+    const char *FrameArena::format(const char *fmt, ...)
+    {
+        va_list args;
+        va_start(args, fmt);
+        va_list measure;
+        va_copy(measure, args);
+        const int length = std::vsnprintf(nullptr, 0, fmt, measure);
+        va_end(measure);
+
+        if (length < 0)
+        {
+            va_end(args);
+            return "";
+        }
+
+        auto *text = static_cast<char *>(allocate(static_cast<std::size_t>(length) + 1, 1));
+        std::vsnprintf(text, static_cast<std::size_t>(length) + 1, fmt, args);
+        va_end(args);
+        return text;
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace todo {
+    // Bump allocator for data that only lives for one frame. reset() at the start of a frame
+    // makes everything allocated since the previous reset reusable at once; deallocation is a
+    // no-op. Hand it to std::pmr containers, or use format() for transient strings such as
+    // ImGui IDs and labels.
+    //
+    // A frame that outgrows the block gets another one from the heap, and the next reset()
+    // replaces them all with a single block large enough for that frame, so once the arena has
+    // seen the busiest frame it never touches the heap again. One arena per thread.
+    class FrameArena final : public std::pmr::memory_resource
+    {
+    public:
+        explicit FrameArena(std::size_t initialBytes = 64 * 1024);
+
+        FrameArena(const FrameArena &) = delete;
+        FrameArena &operator=(const FrameArena &) = delete;
+
+        void reset();
+
+        // printf into the arena; the result is valid until the next reset()
+        const char *format(const char *fmt, ...);
+
+        // Bytes handed out since the last reset, and the size of the block(s) behind them
+        [[nodiscard]] std::size_t used() const { return retiredBytes_ + offset_; }
+        [[nodiscard]] std::size_t capacity() const { return retiredBytes_ + size_; }
+
+    private:
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void *, std::size_t, std::size_t) override {}
+        [[nodiscard]] bool do_is_equal(const memory_resource &other) const noexcept override { return this == &other; }
+
+        std::unique_ptr<std::byte[]> block_;
+        std::size_t size_ = 0;
+        std::size_t offset_ = 0;
+
+        // Full blocks from this frame, freed by the next reset()
+        std::vector<std::unique_ptr<std::byte[]>> retired_;
+        std::size_t retiredBytes_ = 0;
+    };
+}
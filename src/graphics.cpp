@@ -12,6 +12,7 @@
 #include <iostream>
 #include <set>
 
+#include "trace.h"
 #include "utilities.h"
 #include "spdlog/spdlog.h"
 
@@ -77,12 +78,40 @@ namespace todo {
     }
 
     void Graphics::initialize()
+    {
+        initializeInstance();
+        initializeSurface();
+        initializeDevice();
+        loadShaders();
+        initializeSwapChain();
+    }
+
+    void Graphics::initializeInstance()
     {
         createInstance();
         setupDebugMessenger();
+    }
+
+    void Graphics::initializeSurface()
+    {
         createSurface();
+    }
+
+    void Graphics::initializeDevice()
+    {
         pickPhysicalDevice();
         createLogicalDevice();
+    }
+
+    void Graphics::loadShaders()
+    {
+        TRACE_SCOPE("Graphics::loadShaders");
+        vertShaderCode_ = readFile(getResourcesPath() + "/shaders/shader.vert.spv");
+        fragShaderCode_ = readFile(getResourcesPath() + "/shaders/shader.frag.spv");
+    }
+
+    void Graphics::initializeSwapChain()
+    {
         createSwapChain();
         createImageViews();
         createRenderPass();
@@ -95,6 +124,7 @@ namespace todo {
 
     void Graphics::shutdown()
     {
+        TRACE_SCOPE("Graphics::shutdown");
         // Wait for device to be idle FIRST
         vkDeviceWaitIdle(device_);
 
@@ -245,6 +275,7 @@ namespace todo {
 
     void Graphics::createInstance()
     {
+        TRACE_SCOPE("Graphics::createInstance");
         if (enableValidationLayers && !checkValidationLayerSupport())
         {
             throw std::runtime_error("validation layers requested, but not available!");
@@ -369,6 +400,7 @@ namespace todo {
 
     void Graphics::pickPhysicalDevice()
     {
+        TRACE_SCOPE("Graphics::pickPhysicalDevice");
         uint32_t deviceCount = 0;
         vkEnumeratePhysicalDevices(instance_, &deviceCount, nullptr);
 
@@ -399,6 +431,7 @@ namespace todo {
 
     void Graphics::createLogicalDevice()
     {
+        TRACE_SCOPE("Graphics::createLogicalDevice");
         QueueFamilyIndices indices = findQueueFamilies(physicalDevice_);
 
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
@@ -502,6 +535,7 @@ namespace todo {
 
     void Graphics::createSurface()
     {
+        TRACE_SCOPE("Graphics::createSurface");
         if (glfwCreateWindowSurface(instance_, window_, nullptr, &surface_) != VK_SUCCESS)
         {
             throw std::runtime_error("failed to create window surface!");
@@ -621,6 +655,7 @@ namespace todo {
 
     void Graphics::createSwapChain()
     {
+        TRACE_SCOPE("Graphics::createSwapChain");
         SwapChainSupportDetails swapChainSupport = querySwapChainSupport(physicalDevice_);
 
         VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats);
@@ -727,11 +762,13 @@ namespace todo {
 
     void Graphics::createGraphicsPipeline()
     {
-        auto vertShaderCode = readFile(getResourcesPath() + "/shaders/shader.vert.spv");
-        auto fragShaderCode = readFile(getResourcesPath() + "/shaders/shader.frag.spv");
+        TRACE_SCOPE("Graphics::createGraphicsPipeline");
+        if (vertShaderCode_.empty() || fragShaderCode_.empty()) loadShaders();
 
-        VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
-        VkShaderModule fragShaderModule = createShaderModule(fragShaderCode);
+        VkShaderModule vertShaderModule = createShaderModule(vertShaderCode_);
+        VkShaderModule fragShaderModule = createShaderModule(fragShaderCode_);
+        vertShaderCode_ = {};
+        fragShaderCode_ = {};
 
         VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
         vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -42,10 +42,21 @@ namespace todo {
     class Graphics
     {
     public:
-        explicit Graphics(GLFWwindow* window) : window_(window) {}
+        explicit Graphics(GLFWwindow* window = nullptr) : window_(window) {}
         ~Graphics();
 
+        // Runs the stages below in order
         void initialize();
+
+        // initialize() split up for concurrent startup. The instance only needs glfwInit() and the
+        // device only needs the surface, so those two and loadShaders() may run on a worker; the
+        // surface and swapchain stages talk to the window and stay on the main thread.
+        void initializeInstance();
+        void initializeSurface();
+        void initializeDevice();
+        void loadShaders();
+        void initializeSwapChain();
+        void setWindow(GLFWwindow* window) { window_ = window; }
         void shutdown();
 
         // Core rendering functions
@@ -113,6 +124,10 @@ namespace todo {
         std::vector<VkSemaphore> renderFinishedSemaphores_{};
         std::vector<VkFence> inFlightFences_{};
 
+        // SPIR-V read by loadShaders(), released once the pipeline is built
+        std::vector<char> vertShaderCode_{};
+        std::vector<char> fragShaderCode_{};
+
         void setupDebugMessenger();
         void createInstance();
         static void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT &createInfo);
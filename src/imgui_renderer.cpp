@@ -4,22 +4,46 @@
 
 #include "imgui_renderer.h"
 
+#include "allocation_stats.h"
 #include "application.h"
 #include "card_database.h"
 #include "graphics.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_vulkan.h"
 #include "imgui_internal.h"
+#include "job_system.h"
 #include "glm/vec2.hpp"
 #include "spdlog/spdlog.h"
 #include "todo_card.h"
+#include "trace.h"
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <memory_resource>
+#include <utility>
 
 namespace todo {
+    namespace {
+        // "45 min", "6.5 h", "3.2 d"
+        std::string formatDuration(const double seconds)
+        {
+            char text[32];
+            if (std::isnan(seconds)) return "-";
+            if (seconds < 3600.0) std::snprintf(text, sizeof(text), "%.0f min", seconds / 60.0);
+            else if (seconds < 2 * 86400.0) std::snprintf(text, sizeof(text), "%.1f h", seconds / 3600.0);
+            else std::snprintf(text, sizeof(text), "%.1f d", seconds / 86400.0);
+            return text;
+        }
+    }
+
     void ImGuiRenderer::initialize()
     {
+        TRACE_SCOPE("ImGuiRenderer::initialize");
         // Setup Dear ImGui context
         IMGUI_CHECKVERSION();
+        // ImGui uses malloc directly; route it through the same counters as operator new
+        ImGui::SetAllocatorFunctions(countedAlloc, countedFree);
         ImGui::CreateContext();
         ImGuiIO &io = ImGui::GetIO();
         (void) io;
@@ -30,14 +54,6 @@ namespace todo {
         glfwGetWindowContentScale(app_->getWindow(), &xscale, &yscale);
         io.DisplayFramebufferScale = ImVec2(xscale, yscale);
 
-        // Method 2: Load with custom configuration
-        ImFontConfig fontConfig;
-        fontConfig.SizePixels = 18.0f;
-        fontConfig.OversampleH = 2;
-        fontConfig.OversampleV = 2;
-        fontConfig.PixelSnapH = true;
-        // io.Fonts->AddFontFromFileTTF("In ter-VariableFont_opsz,wght.ttf", 16.0f, &fontConfig);
-
         // Setup Dear ImGui style
         ImGui::StyleColorsDark();
 
@@ -72,6 +88,46 @@ namespace todo {
         pomodoroTimer.initialize(&app_->audio());
     }
 
+    void ImGuiRenderer::loadFontAsync(JobSystem &jobs, const std::string &path)
+    {
+        jobs.run<std::vector<char>>(
+            [path]
+            {
+                TRACE_SCOPE("ImGuiRenderer::loadFont");
+                std::vector<char> data;
+                std::ifstream file(path, std::ios::binary | std::ios::ate);
+                if (!file)
+                {
+                    spdlog::warn("Font {} not found; keeping the built-in font", path);
+                    return data;
+                }
+                data.resize(static_cast<size_t>(file.tellg()));
+                file.seekg(0);
+                if (!file.read(data.data(), static_cast<std::streamsize>(data.size()))) data.clear();
+                return data;
+            },
+            [](std::vector<char> &data)
+            {
+                if (data.empty()) return;
+
+                ImFontConfig fontConfig;
+                fontConfig.OversampleH = 2;
+                fontConfig.OversampleV = 2;
+                fontConfig.PixelSnapH = true;
+
+                // The atlas takes ownership and frees it with IM_FREE; glyphs are rasterized on
+                // demand by the backend, so nothing has to be rebuilt here
+                void *owned = IM_ALLOC(data.size());
+                std::memcpy(owned, data.data(), data.size());
+                ImGuiIO &io = ImGui::GetIO();
+                if (ImFont *font = io.Fonts->AddFontFromMemoryTTF(owned, static_cast<int>(data.size()), 18.0f,
+                                                                  &fontConfig))
+                {
+                    io.FontDefault = font;
+                }
+            });
+    }
+
     void ImGuiRenderer::handleDropZoneTarget(CardColumnType cardColumn)
     {
         // Get the current window size
@@ -106,8 +162,7 @@ namespace todo {
 
             // Move cursor for invisible button
             ImGui::SetCursorScreenPos(dropZonePos);
-            std::string id = "DropZone" + std::to_string(i);
-            ImGui::InvisibleButton(id.c_str(), dropZoneSize);
+            ImGui::InvisibleButton(frameArena_.format("DropZone%d", i), dropZoneSize);
 
             // Visual feedback for hovered zone while dragging
             if (ImGui::IsItemHovered() && ImGui::GetDragDropPayload())
@@ -138,28 +193,18 @@ namespace todo {
 
     void ImGuiRenderer::handleDropZoneMove(const DragDropPayload *payload, CardColumnType targetColumn)
     {
-        // Use your logic to move card at payload->sourceIndex from payload->sourceColumnType to targetColumn
-        // For example:
-        std::vector<TodoCard> todoCards;
-        std::vector<TodoCard> inProgressCards;
-        std::vector<TodoCard> doneCards;
-        loadCardLists(todoCards, inProgressCards, doneCards);
-
-        std::vector<TodoCard> *columns[] = {
-            &todoCards, // assumes you have such accessors
-            &inProgressCards,
-            &doneCards
-        };
-
-        std::vector<TodoCard> &fromVec = *columns[payload->sourceColumnType];
-        std::vector<TodoCard> &toVec = *columns[static_cast<int>(targetColumn)];
+        app_->recorder().mark("drop: move to column");
+        // The payload indexes the source column as it was drawn
+        const ColumnRenderCache *source = renderCache_.drawn(currentProjectId(), intToStatus(payload->sourceColumnType));
+        if (!source || payload->sourceIndex >= static_cast<int>(source->size())) return;
+        const CompactCard *card = app_->getCards().find(source->ids[payload->sourceIndex]);
+        if (!card) return;
 
         if (payload->sourceColumnType != static_cast<int>(targetColumn))
         {
-            TodoCard moved = fromVec[payload->sourceIndex];
+            const TodoCard original = app_->getCards().unpack(*card);
+            TodoCard moved = original;
             moved.status = static_cast<CardStatus>(targetColumn);
-            toVec.push_back(moved);
-            fromVec.erase(fromVec.begin() + payload->sourceIndex);
 
             if (moved.status == CardStatus::Done)
             {
@@ -170,8 +215,12 @@ namespace todo {
                 moved.completedAt = "";
             }
 
-            app_->db().updateCard(moved);
-            app_->reloadAppState();
+            app_->applyCard(moved);
+            if (!app_->applyEdit(CardBatch().move(moved), "Move card"))
+            {
+                spdlog::error("Failed to move card");
+                app_->applyCard(original);
+            }
         }
     }
 
@@ -271,7 +320,7 @@ namespace todo {
         // Header content
         if (ImGui::BeginTable("##header", 3, ImGuiTableRowFlags_Headers, headerSize))
         {
-            auto projects = app_->getProjects();
+            const auto &projects = app_->getProjects();
 
             ImGui::TableSetupColumn("Column 1");
             ImGui::TableSetupColumn("Column 2");
@@ -287,7 +336,7 @@ namespace todo {
             ImGui::SetNextItemWidth(100.0f);
 
             // Convert std::vector<std::string> to std::vector<const char*>
-            std::vector<const char *> project_items;
+            std::pmr::vector<const char *> project_items(&frameArena_);
             project_items.reserve(projects.size());
             for (auto &project: projects)
             {
@@ -295,6 +344,9 @@ namespace todo {
             }
             ImGui::Combo("##project", &currentProject_, project_items.data(), project_items.size());
 
+            // Full-text search across all projects
+            renderSearchBar();
+
             // Center - Pomodoro Timer
             ImGui::TableNextColumn();
             pomodoroTimer.Update();
@@ -338,9 +390,82 @@ namespace todo {
                 shouldOpenProjectModal_ = true;
                 ImGui::CloseCurrentPopup();
             }
+            ImGui::Separator();
+            const std::string undoLabel = app_->journal().undoLabel();
+            const std::string redoLabel = app_->journal().redoLabel();
+            if (ImGui::MenuItem(undoLabel.empty() ? "Undo" : frameArena_.format("Undo %s", undoLabel.c_str()), "Ctrl+Z", false,
+                                !undoLabel.empty()))
+            {
+                app_->undo();
+                ImGui::CloseCurrentPopup();
+            }
+            if (ImGui::MenuItem(redoLabel.empty() ? "Redo" : frameArena_.format("Redo %s", redoLabel.c_str()), "Ctrl+Shift+Z", false,
+                                !redoLabel.empty()))
+            {
+                app_->redo();
+                ImGui::CloseCurrentPopup();
+            }
+            ImGui::Separator();
+            if (ImGui::MenuItem("Back Up Now", nullptr, false, !app_->backup().isRunning()))
+            {
+                app_->backup().requestBackup();
+                ImGui::CloseCurrentPopup();
+            }
+            if (ImGui::MenuItem("Restore Latest Backup...", nullptr, false, !app_->backup().listBackups().empty()))
+            {
+                shouldOpenRestoreModal_ = true;
+                ImGui::CloseCurrentPopup();
+            }
+            ImGui::Separator();
+            if (ImGui::MenuItem("Import Board...", nullptr, false, !app_->isImporting()))
+            {
+                transferIsImport_ = true;
+                shouldOpenTransferModal_ = true;
+                ImGui::CloseCurrentPopup();
+            }
+            if (ImGui::MenuItem("Export Board..."))
+            {
+                transferIsImport_ = false;
+                shouldOpenTransferModal_ = true;
+                ImGui::CloseCurrentPopup();
+            }
+            if (app_->isSyncEnabled() && ImGui::MenuItem("Sync Now"))
+            {
+                app_->syncNow();
+                ImGui::CloseCurrentPopup();
+            }
+            ImGui::Separator();
+            if (ImGui::MenuItem("Statistics", nullptr, &showStatistics_)) statsStale_ = true;
+            if (ImGui::MenuItem("Forecast", nullptr, &showForecast_)) forecastProject_ = INT_MIN;
+            ImGui::MenuItem("Database Diagnostics", nullptr, &showDatabaseDiagnostics_);
+            ImGui::MenuItem("Frame Allocations", nullptr, &showAllocations_);
+            // Startup spans so far, for Perfetto; the full trace is written again on exit
+            if (ImGui::MenuItem("Save Trace")) writeChromeTrace(getTracePath());
             ImGui::EndPopup();
         }
 
+        if (app_->isImporting())
+        {
+            ImGui::ProgressBar(app_->importProgress(), ImVec2(comboBoxSize_, 0), "Importing...");
+        }
+
+        if (shouldOpenTransferModal_)
+        {
+            shouldOpenTransferModal_ = false;
+            const std::string defaultPath = getAppDataPath() + "/board.jsonl";
+            strncpy(transferPath_, defaultPath.c_str(), sizeof(transferPath_) - 1);
+            transferFormat_ = transferFormatForPath(transferPath_);
+            showTransferModal_ = true;
+            ImGui::OpenPopup("Board Transfer");
+        }
+
+        if (shouldOpenRestoreModal_)
+        {
+            shouldOpenRestoreModal_ = false;
+            showRestoreModal_ = true;
+            ImGui::OpenPopup("Confirm Restore");
+        }
+
         if (shouldOpenProjectModal_)
         {
             shouldOpenProjectModal_ = false;
@@ -353,8 +478,80 @@ namespace todo {
         }
     }
 
+    void ImGuiRenderer::renderSearchBar()
+    {
+        // Results are produced on the search thread; just pick up whatever is ready
+        app_->search().pollResults(searchResults_);
+
+        if (pendingOpenCardId_ != -1 && openSearchResult(pendingOpenCardId_))
+        {
+            pendingOpenCardId_ = -1;
+        }
+
+        ImGui::SetNextItemWidth(-FLT_MIN);
+        if (ImGui::InputTextWithHint("##search", "Search cards...", searchQuery_, sizeof(searchQuery_)))
+        {
+            app_->search().submit(searchQuery_);
+        }
+
+        if (searchQuery_[0] == '\0' || searchResults_.empty()) return;
+
+        if (ImGui::BeginChild("##searchResults", ImVec2(0, 0), ImGuiChildFlags_Borders))
+        {
+            for (const auto &result: searchResults_)
+            {
+                ImGui::PushID(result.cardId);
+                if (result.archived)
+                {
+                    // Archived cards live outside the board; selecting one brings it back
+                    ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyleColorVec4(ImGuiCol_TextDisabled));
+                    if (ImGui::Selectable(result.title.c_str()) && app_->restoreArchivedCard(result.cardId))
+                    {
+                        pendingOpenCardId_ = result.cardId;
+                        app_->search().submit(searchQuery_);
+                    }
+                    ImGui::PopStyleColor();
+                    ImGui::SameLine();
+                    ImGui::TextDisabled("(archived)");
+                } else if (ImGui::Selectable(result.title.c_str()))
+                {
+                    openSearchResult(result.cardId);
+                }
+                if (ImGui::IsItemHovered() && !result.snippet.empty())
+                {
+                    ImGui::SetTooltip("%s", result.snippet.c_str());
+                }
+                ImGui::PopID();
+            }
+        }
+        ImGui::EndChild();
+    }
+
+    bool ImGuiRenderer::openSearchResult(int cardId)
+    {
+        const auto &cards = app_->getCards();
+        const auto it = std::ranges::find_if(cards, [&](const CompactCard &card) { return card.id == cardId; });
+        if (it == cards.end()) return false;
+
+        // Jump to the card's project so it is visible behind the modal
+        const auto &projects = app_->getProjects();
+        for (int i = 0; i < projects.size(); i++)
+        {
+            if (projects[i].id == it->projectId)
+            {
+                currentProject_ = i;
+                break;
+            }
+        }
+
+        pendingViewCard_ = cards.unpack(*it);
+        shouldOpenViewCardModal_ = true;
+        return true;
+    }
+
     void ImGuiRenderer::beginFrame()
     {
+        frameArena_.reset();
         ImGui_ImplVulkan_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
@@ -374,13 +571,13 @@ namespace todo {
     {
         // Add to database
         auto projects = app_->getProjects();
-        if (!app_->db().addCard(cardTitle_, cardDescription_, selectedStatus_, selectedSequence_,
-                                projects[currentProject_].id))
+        CardBatch batch;
+        batch.insert(cardTitle_, cardDescription_, intToStatus(selectedStatus_), projects[currentProject_].id);
+        if (!app_->applyEdit(batch, "Add card"))
         {
             spdlog::error("Failed to add card to database!");
             return false;
         }
-        app_->loadCards(); // Update cards in app
         return true;
     }
 
@@ -460,7 +657,7 @@ namespace todo {
             ImGui::SetNextItemWidth(comboBoxSize_);
 
             // Create array of project names for the combo
-            std::vector<const char *> projectNames;
+            std::pmr::vector<const char *> projectNames(&frameArena_);
             const auto &projects = app_->getProjects();
 
             for (const auto &project: projects)
@@ -488,8 +685,8 @@ namespace todo {
                 // pendingEditCard_.status = static_cast<CardStatus>(selectedStatus_);
                 pendingEditCard_.projectId = projects[selectedProject_].id;
 
-                app_->db().updateCard(pendingEditCard_);
-                app_->reloadAppState(); // Update cards in app
+                app_->applyCard(pendingEditCard_);
+                app_->applyEdit(CardBatch().update(pendingEditCard_), "Edit card");
 
                 ImGui::CloseCurrentPopup();
                 shouldOpenEditModal_ = false;
@@ -529,15 +726,14 @@ namespace todo {
         if (ImGui::BeginPopupModal("Confirm Delete", &shouldOpenDeleteModal_, window_flags))
         {
             ImGui::Text("Are you sure you want to delete this card?");
-            ImGui::Text("This action cannot be undone.");
+            ImGui::Text("You can undo this with Ctrl+Z.");
             ImGui::Separator();
 
             if (ImGui::Button("Delete", ImVec2(120, 0)))
             {
                 if (cardToDelete_ != -1)
                 {
-                    app_->db().removeCard(cardToDelete_);
-                    app_->reloadAppState(); // Update cards in app
+                    app_->applyEdit(CardBatch().remove(cardToDelete_), "Delete card");
                 }
                 ImGui::CloseCurrentPopup();
                 shouldOpenDeleteModal_ = false;
@@ -621,6 +817,455 @@ namespace todo {
         }
     }
 
+    void ImGuiRenderer::renderConfirmRestoreModal()
+    {
+        ImVec2 center = ImGui::GetMainViewport()->GetCenter();
+        ImVec2 windowSize = ImGui::GetWindowSize();
+        ImGui::SetNextWindowPos(center, ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
+        ImGui::SetNextWindowSize(ImVec2(windowSize.x * 0.50, windowSize.y * 0.20), ImGuiCond_Appearing);
+
+        ImGuiWindowFlags window_flags = 0;
+        window_flags |= ImGuiWindowFlags_NoResize; // Prevent resizing if needed
+        window_flags |= ImGuiWindowFlags_NoMove; // Prevent moving if needed
+
+        if (ImGui::BeginPopupModal("Confirm Restore", &showRestoreModal_, window_flags))
+        {
+            ImGui::Text("Replace the current board with the latest backup?");
+            ImGui::Text("Changes made since that backup will be lost.");
+            ImGui::Separator();
+
+            if (ImGui::Button("Restore", ImVec2(120, 0)))
+            {
+                if (!app_->restoreLatestBackup())
+                {
+                    spdlog::error("Failed to restore backup!");
+                }
+                ImGui::CloseCurrentPopup();
+                showRestoreModal_ = false;
+            }
+
+            ImGui::SameLine();
+
+            if (ImGui::Button("Cancel", ImVec2(120, 0)))
+            {
+                ImGui::CloseCurrentPopup();
+                showRestoreModal_ = false;
+            }
+
+            ImGui::EndPopup();
+        }
+    }
+
+    void ImGuiRenderer::renderTransferModal()
+    {
+        ImVec2 center = ImGui::GetMainViewport()->GetCenter();
+        ImVec2 windowSize = ImGui::GetWindowSize();
+        ImGui::SetNextWindowPos(center, ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
+        ImGui::SetNextWindowSize(ImVec2(windowSize.x * 0.60, windowSize.y * 0.20), ImGuiCond_Appearing);
+
+        ImGuiWindowFlags window_flags = 0;
+        window_flags |= ImGuiWindowFlags_NoResize; // Prevent resizing if needed
+        window_flags |= ImGuiWindowFlags_NoMove; // Prevent moving if needed
+
+        if (ImGui::BeginPopupModal("Board Transfer", &showTransferModal_, window_flags))
+        {
+            ImGui::Text(transferIsImport_ ? "Import cards and projects from:" : "Export the board to:");
+            ImGui::SetNextItemWidth(-1);
+            // Sniffing a .json file reads from disk, so only redo it when the path changes
+            if (ImGui::InputText("##TransferPath", transferPath_, IM_ARRAYSIZE(transferPath_)))
+            {
+                transferFormat_ = transferFormatForPath(transferPath_);
+            }
+
+            const auto format = transferFormat_;
+            const bool knownFormat = format && (transferIsImport_ || format == TransferFormat::Jsonl ||
+                                                format == TransferFormat::Csv);
+            if (!knownFormat)
+            {
+                ImGui::TextDisabled(transferIsImport_
+                                        ? "Use a .jsonl or .csv file, or a Trello/Jira .json export"
+                                        : "Use a .jsonl or .csv file");
+            } else if (format == TransferFormat::Trello || format == TransferFormat::Jira)
+            {
+                ImGui::TextDisabled(format == TransferFormat::Trello ? "Trello board export" : "Jira issue export");
+            }
+            ImGui::Separator();
+
+            ImGui::BeginDisabled(!knownFormat);
+            if (ImGui::Button(transferIsImport_ ? "Import" : "Export", ImVec2(120, 0)))
+            {
+                const bool started = transferIsImport_
+                                         ? app_->startImport(transferPath_)
+                                         : app_->startExport(transferPath_);
+                if (!started)
+                {
+                    spdlog::error("Failed to start board transfer for {}", transferPath_);
+                }
+                ImGui::CloseCurrentPopup();
+                showTransferModal_ = false;
+            }
+            ImGui::EndDisabled();
+
+            ImGui::SameLine();
+
+            if (ImGui::Button("Cancel", ImVec2(120, 0)))
+            {
+                ImGui::CloseCurrentPopup();
+                showTransferModal_ = false;
+            }
+
+            ImGui::EndPopup();
+        }
+    }
+
+    void ImGuiRenderer::renderDatabaseDiagnostics()
+    {
+        // Nothing is sorted, copied or sampled unless the panel is open
+        if (!showDatabaseDiagnostics_) return;
+
+        ImGui::SetNextWindowSize(ImVec2(720, 360), ImGuiCond_FirstUseEver);
+        if (!ImGui::Begin("Database Diagnostics", &showDatabaseDiagnostics_))
+        {
+            ImGui::End();
+            return;
+        }
+
+        auto &profiler = app_->profiler();
+        profiler.sampleCacheStats(app_->db().handle());
+
+        // Page cache
+        for (const auto &cache: profiler.cacheSnapshot())
+        {
+            const int lookups = cache.hits + cache.misses;
+            ImGui::Text("%-10s  hits %8d  misses %6d  hit rate %5.1f%%  used %6d KiB",
+                        cache.connection.c_str(), cache.hits, cache.misses,
+                        lookups ? 100.0 * cache.hits / lookups : 0.0, cache.usedBytes / 1024);
+        }
+
+        if (ImGui::Button("Reset"))
+        {
+            profiler.reset();
+        }
+
+        // Frames over budget dump the flight recorder's last seconds next to the database
+        auto &recorder = app_->recorder();
+        int budgetMs = static_cast<int>(recorder.budget().count());
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(160.0f);
+        if (ImGui::SliderInt("Frame budget", &budgetMs, 8, 250, "%d ms"))
+        {
+            recorder.setBudget(std::chrono::milliseconds(budgetMs));
+        }
+        ImGui::SameLine();
+        ImGui::Text("%u slow frames, %d dumps", recorder.slowFrames(), recorder.dumps());
+        ImGui::Separator();
+
+        // Statements, most expensive first
+        ImGuiTableFlags table_flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+                                      ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable;
+        if (ImGui::BeginTable("##statements", 6, table_flags))
+        {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+            ImGui::TableSetupColumn("Total ms", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+            ImGui::TableSetupColumn("Mean ms", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+            ImGui::TableSetupColumn("p95 ms", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+            ImGui::TableSetupColumn("Max ms", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+            ImGui::TableSetupColumn("Statement", ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableHeadersRow();
+
+            for (const auto &stats: profiler.statementSnapshot())
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", static_cast<unsigned long long>(stats.count));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", stats.totalNs / 1e6);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", stats.meanMs());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", stats.percentileMs(0.95));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", stats.maxNs / 1e6);
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(stats.sql.c_str());
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("%s", stats.sql.c_str());
+            }
+            ImGui::EndTable();
+        }
+
+        ImGui::End();
+    }
+
+    void ImGuiRenderer::renderAllocationOverlay()
+    {
+        if (!showAllocations_) return;
+
+        // The last completed frame, broken down by the flight recorder's phases
+        const auto &recorder = app_->recorder();
+        const auto &frame = recorder.lastFrame();
+        allocationHistory_[allocationFrames_++ % kAllocationHistory] = frame.allocations.count;
+
+        const std::size_t samples = std::min(allocationFrames_, kAllocationHistory);
+        std::uint64_t recent = 0;
+        for (std::size_t i = 0; i < samples; i++) recent += allocationHistory_[i];
+
+        ImGui::SetNextWindowBgAlpha(0.8f);
+        const ImGuiWindowFlags flags = ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing |
+                                       ImGuiWindowFlags_NoNav;
+        if (!ImGui::Begin("Frame Allocations", &showAllocations_, flags))
+        {
+            ImGui::End();
+            return;
+        }
+
+        ImGui::Text("Frame %u: %llu allocations, %llu bytes", frame.frame,
+                    static_cast<unsigned long long>(frame.allocations.count),
+                    static_cast<unsigned long long>(frame.allocations.bytes));
+        ImGui::Text("Mean over %zu frames: %.1f", samples, static_cast<double>(recent) / samples);
+
+        const auto &steady = app_->steadyStateAllocations();
+        if (steady.frames > 0)
+        {
+            ImGui::Text("Steady state: %.2f per frame, %llu max", steady.meanCount(),
+                        static_cast<unsigned long long>(steady.maxCount));
+        }
+
+        if (ImGui::BeginTable("##phases", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+        {
+            ImGui::TableSetupColumn("Phase");
+            ImGui::TableSetupColumn("ms");
+            ImGui::TableSetupColumn("Allocs");
+            ImGui::TableSetupColumn("Bytes");
+            ImGui::TableHeadersRow();
+
+            for (const auto &phase: recorder.lastFramePhases())
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(phase.label);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", static_cast<double>(phase.end - phase.start) / 1e6);
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", static_cast<unsigned long long>(phase.allocations.count));
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", static_cast<unsigned long long>(phase.allocations.bytes));
+            }
+            ImGui::EndTable();
+        }
+
+        ImGui::End();
+    }
+
+    void ImGuiRenderer::renderStatistics()
+    {
+        if (!showStatistics_) return;
+
+        ImGui::SetNextWindowSize(ImVec2(560, 320), ImGuiCond_FirstUseEver);
+        if (!ImGui::Begin("Statistics", &showStatistics_))
+        {
+            ImGui::End();
+            return;
+        }
+
+        // Project filter: "All projects" first, then the board's projects
+        const auto &projects = app_->getProjects();
+        std::pmr::vector<const char *> projectNames({"All projects"}, &frameArena_);
+        for (const auto &project: projects) projectNames.push_back(project.name.c_str());
+        statsProject_ = std::clamp(statsProject_, 0, static_cast<int>(projectNames.size()) - 1);
+
+        ImGui::SetNextItemWidth(comboBoxSize_);
+        statsStale_ |= ImGui::Combo("##statsProject", &statsProject_, projectNames.data(),
+                                    static_cast<int>(projectNames.size()));
+        ImGui::SameLine();
+
+        constexpr int rangeDays[] = {30, 90, 365};
+        const char *rangeNames[] = {"Last 30 days", "Last 90 days", "Last year"};
+        ImGui::SetNextItemWidth(comboBoxSize_);
+        statsStale_ |= ImGui::Combo("##statsRange", &statsRange_, rangeNames, IM_ARRAYSIZE(rangeNames));
+        ImGui::SameLine();
+        statsStale_ |= ImGui::Button("Refresh");
+
+        // A year is at most 365 rollup rows, so this is cheap even on large boards
+        if (statsStale_)
+        {
+            statsStale_ = false;
+            const int days = rangeDays[statsRange_];
+            const int projectId = statsProject_ > 0 ? projects[statsProject_ - 1].id : -1;
+            refreshStatistics(days, projectId);
+        }
+
+        ImGui::Separator();
+        ImGui::Text("Created %d    Started %d    Completed %d", statsSummary_.created, statsSummary_.started,
+                    statsSummary_.completed);
+        if (statsSummary_.completed > 0)
+        {
+            ImGui::Text("Mean cycle time %.1f h (%.1f days)", statsSummary_.meanCycleHours,
+                        statsSummary_.meanCycleHours / 24.0);
+        } else
+        {
+            ImGui::TextDisabled("No cards completed in this range");
+        }
+
+        renderCycleTimePercentiles(statsProject_ > 0 ? projects[statsProject_ - 1].id
+                                                     : CycleTimeSketches::kAllProjects);
+
+        ImGui::PlotHistogram("##completedPerDay", statsSummary_.completedPerDay.data(),
+                             static_cast<int>(statsSummary_.completedPerDay.size()), 0, "Completed per day", 0.0f,
+                             FLT_MAX, ImVec2(-1, ImGui::GetContentRegionAvail().y));
+
+        ImGui::End();
+    }
+
+    void ImGuiRenderer::renderCycleTimePercentiles(const int projectId)
+    {
+        const CycleTimeSketches &sketches = app_->cycleTimes();
+
+        // Quantiles come from a few hundred centroids per sketch, and only after a change
+        if (percentileVersion_ != sketches.version() || percentileProject_ != projectId)
+        {
+            percentileVersion_ = sketches.version();
+            percentileProject_ = projectId;
+            percentileRows_.clear();
+
+            auto addRow = [&](std::string label, const int metric)
+            {
+                const double cards = sketches.count(projectId, metric);
+                if (cards == 0.0) return;
+                percentileRows_.push_back({
+                    std::move(label), cards, sketches.quantile(projectId, metric, 0.50),
+                    sketches.quantile(projectId, metric, 0.85), sketches.quantile(projectId, metric, 0.95)
+                });
+            };
+
+            addRow("Lead time", CycleTimeSketches::kLeadTime);
+            addRow("Cycle time", CycleTimeSketches::kCycleTime);
+            const char *statusItems[] = {"Todo", "In Progress", "Done"};
+            for (int from = 0; from < IM_ARRAYSIZE(statusItems); from++)
+            {
+                for (int to = 0; to < IM_ARRAYSIZE(statusItems); to++)
+                {
+                    if (from == to) continue;
+                    addRow(std::string("In ") + statusItems[from] + " before " + statusItems[to],
+                           CycleTimeSketches::transitionMetric(intToStatus(from), intToStatus(to)));
+                }
+            }
+        }
+
+        ImGui::Separator();
+        ImGui::Text("Cycle time percentiles (all time)");
+        ImGui::SameLine();
+        ImGui::BeginDisabled(sketches.isRebuilding());
+        if (ImGui::SmallButton(sketches.isRebuilding() ? "Rebuilding..." : "Rebuild")) app_->rebuildCycleTimes();
+        ImGui::EndDisabled();
+
+        if (percentileRows_.empty())
+        {
+            ImGui::TextDisabled("No status changes recorded yet");
+            return;
+        }
+
+        if (ImGui::BeginTable("##percentiles", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp))
+        {
+            ImGui::TableSetupColumn("Metric");
+            ImGui::TableSetupColumn("Cards");
+            ImGui::TableSetupColumn("p50");
+            ImGui::TableSetupColumn("p85");
+            ImGui::TableSetupColumn("p95");
+            ImGui::TableHeadersRow();
+            for (const auto &row: percentileRows_)
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(row.label.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.0f", row.cards);
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(formatDuration(row.p50).c_str());
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(formatDuration(row.p85).c_str());
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(formatDuration(row.p95).c_str());
+            }
+            ImGui::EndTable();
+        }
+    }
+
+    UiTask ImGuiRenderer::refreshStatistics(const int days, const int projectId)
+    {
+        statsSummary_ = co_await app_->queries().stats(days, projectId);
+    }
+
+    UiTask ImGuiRenderer::runForecast(const int projectId)
+    {
+        forecastProject_ = projectId;
+        forecastRunning_ = true;
+        DeliveryForecast forecast = co_await app_->queries().forecast(projectId);
+
+        forecastRunning_ = false;
+        if (forecast.projectId == forecastProject_) forecast_ = std::move(forecast);
+    }
+
+    void ImGuiRenderer::renderForecast()
+    {
+        if (!showForecast_) return;
+
+        ImGui::SetNextWindowSize(ImVec2(420, 200), ImGuiCond_FirstUseEver);
+        if (!ImGui::Begin("Forecast", &showForecast_))
+        {
+            ImGui::End();
+            return;
+        }
+
+        const auto &projects = app_->getProjects();
+        if (projects.empty())
+        {
+            ImGui::End();
+            return;
+        }
+        const auto &project = projects[std::clamp(currentProject_, 0, static_cast<int>(projects.size()) - 1)];
+
+        ImGui::Text("%s", project.name.c_str());
+        ImGui::SameLine();
+        ImGui::BeginDisabled(forecastRunning_);
+        const bool rerun = ImGui::SmallButton(forecastRunning_ ? "Simulating..." : "Run again");
+        ImGui::EndDisabled();
+
+        // Simulated off the render thread; a result for a project no longer selected is dropped
+        if (!forecastRunning_ && (rerun || forecastProject_ != project.id)) runForecast(project.id);
+
+        ImGui::Separator();
+        if (forecast_.projectId != project.id)
+        {
+            ImGui::TextDisabled("Simulating...");
+        } else if (forecast_.remaining == 0)
+        {
+            ImGui::TextDisabled("No open cards in this project");
+        } else if (forecast_.days[0] < 0)
+        {
+            ImGui::TextDisabled("Not enough completed cards in the last %d days to forecast %d open cards",
+                                forecast_.historyDays, forecast_.remaining);
+        } else
+        {
+            ImGui::Text("%d open cards, resampling %d days of throughput", forecast_.remaining,
+                        forecast_.historyDays);
+            for (size_t i = 0; i < std::size(kForecastConfidence); i++)
+            {
+                if (forecast_.days[i] < 0)
+                {
+                    ImGui::Text("%.0f%%: beyond %d days", kForecastConfidence[i] * 100.0, kMaxForecastDays);
+                } else
+                {
+                    ImGui::Text("%.0f%%: by %s (%d days)", kForecastConfidence[i] * 100.0, forecast_.dates[i].c_str(),
+                                forecast_.days[i]);
+                }
+            }
+            ImGui::TextDisabled("%d simulations in %.0f ms", forecast_.trials, forecast_.milliseconds);
+        }
+
+        ImGui::End();
+    }
+
     void ImGuiRenderer::renderAddProjectModal()
     {
         ImVec2 center = ImGui::GetMainViewport()->GetCenter();
@@ -720,62 +1365,14 @@ namespace todo {
         }
     }
 
-    // Define a custom comparator function or functor
-    struct CardSequenceComparator
-    {
-        bool operator()(const TodoCard &a, const TodoCard &b) const
-        {
-            return a.sequence < b.sequence;
-        }
-    };
-
-    void ImGuiRenderer::assignCardList(TodoCard &card, std::vector<TodoCard> &cards) const
-    {
-        if (card.status == CardStatus::Done) card.color = glm::vec4(0.144f, 0.238f, 0.144f, 1.0f);
-        cards.push_back(card);
-    }
-
-    void ImGuiRenderer::loadCardLists(std::vector<TodoCard> &todoCards,
-                                      std::vector<TodoCard> &inProgressCards, std::vector<TodoCard> &doneCards) const
+    int ImGuiRenderer::currentProjectId() const
     {
-        auto cards = app_->getCards();
-        auto projects = app_->getProjects();
-        int projectId = 0;
-
-        if (projects.size())
-        {
-            projectId = projects[currentProject_].id;
-        }
-
-        for (auto &card: cards)
-        {
-            if (card.projectId != projectId) continue;
-
-            switch (card.status)
-            {
-                case CardStatus::Todo: assignCardList(card, todoCards);
-                    break;
-                case CardStatus::InProgress: assignCardList(card, inProgressCards);
-                    break;
-                case CardStatus::Done: assignCardList(card, doneCards);
-                    break;
-                default: break;
-            }
-        }
-
-        // Sort each vector by the sequence field
-        std::ranges::sort(todoCards, CardSequenceComparator());
-        std::ranges::sort(inProgressCards, CardSequenceComparator());
-        std::ranges::sort(doneCards, CardSequenceComparator());
+        const auto &projects = app_->getProjects();
+        return projects.empty() ? 0 : projects[currentProject_].id;
     }
 
     void ImGuiRenderer::renderUI()
     {
-        std::vector<TodoCard> todoCards;
-        std::vector<TodoCard> inProgressCards;
-        std::vector<TodoCard> doneCards;
-        loadCardLists(todoCards, inProgressCards, doneCards);
-
         // Get the current window size
         glm::ivec2 windowSize;
         app_->getWindowSize(windowSize);
@@ -807,6 +1404,10 @@ namespace todo {
         columnWidth_ = (availableWidth - 20) / columnCount_; // 20 for spacing between columns
         columnHeight_ = ImGui::GetContentRegionAvail().y - 50; // Leave space for bottom padding
 
+        // Undo/redo. A focused text field keeps Ctrl+Z for its own editing.
+        if (ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiKey_Z, ImGuiInputFlags_RouteGlobal)) app_->undo();
+        if (ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiMod_Shift | ImGuiKey_Z, ImGuiInputFlags_RouteGlobal)) app_->redo();
+
         // Create header section
         renderHeader();
 
@@ -830,18 +1431,19 @@ namespace todo {
 
             // Column 1: TODO
             ImGui::TableSetColumnIndex(CardColumnType::TodoColumn);
-            drawCardColumn(todoCards, "TODO_CARD");
+            drawCardColumn(CardStatus::Todo, "TODO_CARD");
 
             // Column 2: IN PROGRESS
             ImGui::TableSetColumnIndex(CardColumnType::InProgressColumn);
-            drawCardColumn(inProgressCards, "PROGRESS_CARD");
+            drawCardColumn(CardStatus::InProgress, "PROGRESS_CARD");
 
             // Column 3: DONE
             ImGui::TableSetColumnIndex(CardColumnType::DoneColumn);
-            drawCardColumn(doneCards, "DONE_CARD");
+            drawCardColumn(CardStatus::Done, "DONE_CARD");
 
             ImGui::EndTable();
         }
+        applyPendingReorder();
 
         // Create invisible overlay drop zones
         renderDropZoneOverlays();
@@ -902,12 +1504,21 @@ namespace todo {
         renderViewCardModal();
 
         renderAddProjectModal();
+        renderConfirmRestoreModal();
+        renderTransferModal();
 
         ImGui::End();
+
+        // Separate top-level windows
+        renderStatistics();
+        renderForecast();
+        renderDatabaseDiagnostics();
+        renderAllocationOverlay();
     }
 
     void ImGuiRenderer::shutdown()
     {
+        TRACE_SCOPE("ImGuiRenderer::shutdown");
         ImGui_ImplVulkan_Shutdown();
         ImGui_ImplGlfw_Shutdown();
         ImGui::DestroyContext();
@@ -919,21 +1530,36 @@ namespace todo {
     }
 
     // Helper function to draw cards in a column
-    void ImGuiRenderer::drawCardColumn(std::vector<TodoCard> &cards, const char *dragDropType)
+    void ImGuiRenderer::drawCardColumn(const CardStatus status, const char *dragDropType)
     {
+        // Titles are wrapped as if the scrollbar were showing, so it coming and going does not
+        // relay out the column
+        const float wrapWidth = ImGui::GetContentRegionAvail().x - ImGui::GetStyle().ScrollbarSize - 16.0f;
+        const ColumnRenderCache &column = renderCache_.column(app_->getCards(), currentProjectId(), status, wrapWidth);
+        if (column.size() == 0 && app_->isBoardLoading())
+        {
+            drawSkeletonColumn();
+            return;
+        }
+
         // Create scrollable region for cards
         float availableHeight = ImGui::GetContentRegionAvail().y;
-        if (ImGui::BeginChild((std::string(dragDropType) + "_ScrollRegion").c_str(),
+        if (ImGui::BeginChild(frameArena_.format("%s_ScrollRegion", dragDropType),
                               ImVec2(0, availableHeight), false))
         {
-            for (int i = 0; i < cards.size(); i++)
+            // Cards are all the same height, so only the visible ones are submitted
+            const float cardStride = kCardHeight + 2.0f * ImGui::GetStyle().ItemSpacing.y;
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(column.size()), cardStride);
+            while (clipper.Step())
             {
-                ImGui::PushID(cards[i].id);
-                drawSingleCard(cards[i], i, dragDropType);
-                ImGui::PopID();
-
-                if (i < cards.size() - 1)
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+                {
+                    ImGui::PushID(column.ids[i]);
+                    drawSingleCard(column, i, dragDropType);
+                    ImGui::PopID();
                     ImGui::Spacing();
+                }
             }
         }
         ImGui::EndChild();
@@ -942,50 +1568,47 @@ namespace todo {
         // handleColumnDrop(dragDropType);
     }
 
+    void ImGuiRenderer::drawSkeletonColumn() const
+    {
+        constexpr int kSkeletonCards = 4;
+        constexpr float kSkeletonHeight = 64.0f;
+
+        // Pulses so an empty board still reads as loading
+        const float pulse = 0.5f + 0.5f * std::sin(static_cast<float>(ImGui::GetTime()) * 4.0f);
+        const ImU32 color = ImGui::GetColorU32(ImGuiCol_FrameBg, 0.35f + 0.35f * pulse);
+        ImDrawList *drawList = ImGui::GetWindowDrawList();
+        const float width = ImGui::GetContentRegionAvail().x;
+        for (int i = 0; i < kSkeletonCards; i++)
+        {
+            const ImVec2 min = ImGui::GetCursorScreenPos();
+            drawList->AddRectFilled(min, ImVec2(min.x + width, min.y + kSkeletonHeight), color, 6.0f);
+            ImGui::Dummy(ImVec2(width, kSkeletonHeight));
+            ImGui::Spacing();
+        }
+    }
+
     void ImGuiRenderer::handleCardReorder(const ImGuiPayload *imGuiPayload, int currentCardIndex,
                                           const char *columnType)
     {
+        app_->recorder().mark("drop: reorder");
         // Get payload data
         auto *payload = static_cast<DragDropPayload *>(imGuiPayload->Data);
-        int sourceIndex = payload->sourceIndex;
-        int sourceColumnType = payload->sourceColumnType;
-
-        auto cards = app_->getCards();
-        auto &sourceCard = cards[sourceIndex];
-        auto &currentCard = cards[currentCardIndex];
-
-        int sourceCardSequence = sourceCard.sequence;
-        int currentCardSequence = currentCard.sequence;
-
-        app_->db().reorderCards(sourceIndex, currentCardIndex);
-
-        //
-        //
-        // // Update the sequence of the source card to match the sequence of the current card
-        // sourceCard.sequence = currentCardSequence;
-        //
-        // // Update the database with the new sequence for the source card
-        // if (!app_->db().updateCard(sourceCard))
-        // {
-        //     spdlog::error("Failed to update card sequence");
-        //     return;
-        // }
-        //
-        // // Move the card from the source index to the current index in the vector
-        // // std::swap(cards[sourceIndex], cards[currentCardIndex]);
-        //
-        // // Update the database with the new position for the current card (if necessary)
-        // // if (sourceIndex != currentCardIndex) {
-        // currentCard.sequence = sourceCardSequence;
-        // if (!app_->db().updateCard(currentCard))
-        // {
-        //     spdlog::error("Failed to update card sequence");
-        //     return;
-        // }
-        // // }
-
-        // // Load the updated list of cards
-        app_->reloadAppState(); // Update cards in app
+
+        // Applied once the board is drawn; the reload would pull the cards out from under the columns
+        pendingReorderFrom_ = payload->sourceIndex;
+        pendingReorderTo_ = currentCardIndex;
+    }
+
+    void ImGuiRenderer::applyPendingReorder()
+    {
+        if (pendingReorderFrom_ < 0) return;
+        const int sourceIndex = std::exchange(pendingReorderFrom_, -1);
+        const int currentCardIndex = std::exchange(pendingReorderTo_, -1);
+
+        if (!app_->applyEdit(app_->db().reorderBatch(sourceIndex, currentCardIndex), "Reorder cards"))
+        {
+            spdlog::error("Failed to reorder cards");
+        }
     }
 
     int ImGuiRenderer::getColumnTypeFromDragDrop(const char *dragDropType)
@@ -999,34 +1622,38 @@ namespace todo {
     void ImGuiRenderer::updateCard(TodoCard &card) const
     {
         spdlog::info("Card Completed at: {}", card.completedAt);
-        if (!app_->db().updateCard(card))
+        if (!app_->applyEdit(CardBatch().update(card), "Edit card"))
         {
             spdlog::error("Failed to update card");
         }
-        app_->reloadAppState(); // Update cards in app
     }
 
-    void ImGuiRenderer::drawSingleCard(TodoCard &card, int cardIndex, const char *dragDropType)
+    void ImGuiRenderer::drawSingleCard(const ColumnRenderCache &column, int cardIndex, const char *dragDropType)
     {
+        const int cardId = column.ids[cardIndex];
+
         // Set card colors
-        ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(card.color.r, card.color.g, card.color.b, card.color.a));
+        const glm::vec4 &color = kCardPalette[column.colors[cardIndex]];
+        ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(color.r, color.g, color.b, color.a));
         ImGui::PushStyleColor(ImGuiCol_ButtonHovered,
-                              ImVec4(card.color.r * 1.2f, card.color.g * 1.2f, card.color.b * 1.2f, card.color.a));
+                              ImVec4(color.r * 1.2f, color.g * 1.2f, color.b * 1.2f, color.a));
         ImGui::PushStyleColor(ImGuiCol_ButtonActive,
-                              ImVec4(card.color.r * 0.8f, card.color.g * 0.8f, card.color.b * 0.8f, card.color.a));
+                              ImVec4(color.r * 0.8f, color.g * 0.8f, color.b * 0.8f, color.a));
 
         // Card button
         float buttonWidth = ImGui::GetContentRegionAvail().x;
-        ImVec2 buttonSize(buttonWidth, 100); // Fixed height for cards
+        ImVec2 buttonSize(buttonWidth, kCardHeight); // Fixed height for cards
 
         bool cardPressed = ImGui::Button("##card", buttonSize);
 
         // Handle drag and drop
         if (ImGui::BeginDragDropSource())
         {
+            if (!ImGui::GetDragDropPayload()) app_->recorder().mark("drag start");
             DragDropPayload payload = {cardIndex, getColumnTypeFromDragDrop(dragDropType)};
             ImGui::SetDragDropPayload(dragDropType, &payload, sizeof(DragDropPayload));
-            ImGui::Text("Moving: %s", card.title.c_str());
+            const std::string_view title = app_->getCards().text(column.titles[cardIndex]);
+            ImGui::Text("Moving: %.*s", static_cast<int>(title.size()), title.data());
             ImGui::EndDragDropSource();
         }
 
@@ -1044,7 +1671,7 @@ namespace todo {
         ImGui::PopStyleColor(3);
 
         // Draw card content overlay
-        drawCardContent(card);
+        drawCardContent(column, cardIndex);
 
         // Handle card interactions
         if (cardPressed)
@@ -1052,8 +1679,11 @@ namespace todo {
             // card.completed = !card.completed;
             // Update card in database
             // updateCard(card);
-            pendingViewCard_ = card;
-            shouldOpenViewCardModal_ = true;
+            if (const CompactCard *card = app_->getCards().find(cardId))
+            {
+                pendingViewCard_ = app_->getCards().unpack(*card);
+                shouldOpenViewCardModal_ = true;
+            }
         }
 
 
@@ -1067,31 +1697,38 @@ namespace todo {
         {
             if (ImGui::MenuItem("Edit"))
             {
-                shouldOpenEditModal_ = true;
-                pendingEditCard_ = card;
+                if (const CompactCard *card = app_->getCards().find(cardId))
+                {
+                    shouldOpenEditModal_ = true;
+                    pendingEditCard_ = app_->getCards().unpack(*card);
+                }
                 ImGui::CloseCurrentPopup();
             }
             if (ImGui::MenuItem("Delete"))
             {
                 shouldOpenDeleteModal_ = true;
-                pendingDeleteCardId_ = card.id;
+                pendingDeleteCardId_ = cardId;
                 ImGui::CloseCurrentPopup();
             }
             ImGui::EndPopup();
         }
     }
 
-    void ImGuiRenderer::drawCardContent(const TodoCard &card)
+    void ImGuiRenderer::drawCardContent(const ColumnRenderCache &column, int cardIndex)
     {
         ImVec2 cardPos = ImGui::GetItemRectMin();
         ImVec2 cardSize = ImGui::GetItemRectSize();
         ImDrawList *drawList = ImGui::GetWindowDrawList();
 
-        // Card title (with text wrapping)
-        ImVec2 titlePos(cardPos.x + 8, cardPos.y + 8);
-        float maxWidth = cardSize.x - 16;
-        drawList->AddText(nullptr, 0, titlePos, IM_COL32(255, 255, 255, 255),
-                          card.title.c_str(), nullptr, maxWidth);
+        // Card title, already wrapped by the render cache
+        const char *title = app_->getCards().text(column.titles[cardIndex]).data();
+        const ColumnRenderCache::TitleLayout &layout = column.layouts[cardIndex];
+        const float lineHeight = ImGui::GetFontSize();
+        for (int line = 0; line < layout.lines; line++)
+        {
+            drawList->AddText(ImVec2(cardPos.x + 8, cardPos.y + 8 + line * lineHeight), IM_COL32(255, 255, 255, 255),
+                              title + layout.begin[line], title + layout.end[line]);
+        }
 
 
         // Card description (with text wrapping)
@@ -1104,15 +1741,17 @@ namespace todo {
         constexpr auto statusTextOffset = glm::vec2 (8, -34);
         const char *checkmark = "[X] Completed";
         const char *circle = "[ ] Pending";
-        const char *statusText = card.status == CardStatus::Done ? checkmark : circle;
-        ImU32 statusColor = card.status == CardStatus::Done ? IM_COL32(0, 255, 0, 255) : IM_COL32(255, 255, 0, 255);
+        const bool done = column.status == CardStatus::Done;
+        const char *statusText = done ? checkmark : circle;
+        ImU32 statusColor = done ? IM_COL32(0, 255, 0, 255) : IM_COL32(255, 255, 0, 255);
         drawList->AddText(ImVec2(cardPos.x + statusTextOffset.x, cardPos.y + cardSize.y + statusTextOffset.y),
                           statusColor, statusText);
 
-        if (card.status == CardStatus::Done)
+        if (done)
         {
             constexpr auto completedAtOffset = glm::vec2 (8, -18);
-            const char *completedAtText = card.completedAt.empty() ? "" : card.completedAt.c_str();
+            char completedAtText[32];
+            formatTimestamp(column.completedAt[cardIndex], completedAtText, sizeof(completedAtText));
             drawList->AddText(ImVec2(cardPos.x + completedAtOffset.x, cardPos.y + cardSize.y + completedAtOffset.y), statusColor, completedAtText);
         }
 
@@ -1139,115 +1778,6 @@ namespace todo {
         }
     }
 
-
-    void ImGuiRenderer::handleInProgressDrop(std::vector<TodoCard> inProgressCards, TodoCard &card)
-    {
-        card.status = CardStatus::InProgress;
-        inProgressCards.push_back(card);
-    }
-
-    void ImGuiRenderer::handleDoneCardDrop(std::vector<TodoCard> doneCards, TodoCard &card)
-    {
-        card.status = CardStatus::Done;
-        card.completedAt = std::to_string(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
-        updateCard(card);
-        doneCards.push_back(card);
-    }
-
-    void ImGuiRenderer::handleTodoCardDrop(std::vector<TodoCard> todoCards, TodoCard &card)
-    {
-        card.status = CardStatus::Todo;
-        todoCards.push_back(card);
-    }
-
-    void ImGuiRenderer::handleCardDrop(const std::string &id, const ImVec2 &columnPos, const ImVec2 &columnSize)
-    {
-        std::vector<TodoCard> todoCards;
-        std::vector<TodoCard> inProgressCards;
-        std::vector<TodoCard> doneCards;
-        loadCardLists(todoCards, inProgressCards, doneCards);
-
-
-        // Overlay button to receive drops
-        ImGui::SetCursorScreenPos(columnPos);
-        ImGui::InvisibleButton(id.c_str(), columnSize);
-
-        if (ImGui::BeginDragDropTarget())
-        {
-            // Handle Card Drop from TODO
-            if (const ImGuiPayload *payload = ImGui::AcceptDragDropPayload("TODO_CARD"))
-            {
-                auto *cardPayload = static_cast<DragDropPayload *>(payload->Data);
-                TodoCard card = todoCards[cardPayload->sourceIndex];
-                todoCards.erase(todoCards.begin() + cardPayload->sourceIndex);
-
-                if (id == inProgressDropZoneId_)
-                {
-                    handleInProgressDrop(inProgressCards, card);
-                } else if (id == doneDropZoneId_)
-                {
-                    handleDoneCardDrop(doneCards, card);
-                } else
-                {
-                    spdlog::error("Invalid destination column for card drop");
-                }
-
-                app_->db().updateCard(card);
-            }
-
-            // Handle Card Drop from IN PROGRESS
-            if (const ImGuiPayload *payload = ImGui::AcceptDragDropPayload("PROGRESS_CARD"))
-            {
-                auto *cardPayload = static_cast<DragDropPayload *>(payload->Data);
-                TodoCard card = inProgressCards[cardPayload->sourceIndex];
-                inProgressCards.erase(inProgressCards.begin() + cardPayload->sourceIndex);
-
-                if (id == todoDropZoneId_)
-                {
-                    handleTodoCardDrop(todoCards, card);
-                } else if (id == doneDropZoneId_)
-                {
-                    handleDoneCardDrop(doneCards, card);
-                } else
-                {
-                    spdlog::error("Invalid destination column for card drop");
-                }
-
-                app_->db().updateCard(card);
-            }
-
-            // Handle Card Drop from DONE
-            if (const ImGuiPayload *payload = ImGui::AcceptDragDropPayload("DONE_CARD"))
-            {
-                auto *cardPayload = static_cast<DragDropPayload *>(payload->Data);
-                TodoCard card = doneCards[cardPayload->sourceIndex];
-                doneCards.erase(doneCards.begin() + cardPayload->sourceIndex);
-
-                if (id == todoDropZoneId_)
-                {
-                    handleTodoCardDrop(todoCards, card);
-                } else if (id == inProgressDropZoneId_)
-                {
-                    handleInProgressDrop(inProgressCards, card);
-                } else
-                {
-                    spdlog::error("Invalid destination column for card drop");
-                }
-
-                app_->db().updateCard(card);
-            }
-        }
-
-        // Visual feedback when hovering over drop zone
-        if (ImGui::IsItemHovered() && ImGui::GetDragDropPayload())
-        {
-            ImDrawList *drawList = ImGui::GetWindowDrawList();
-            drawList->AddRect(columnPos,
-                              ImVec2(columnPos.x + columnSize.x, columnPos.y + columnSize.y),
-                              IM_COL32(0, 255, 0, 100), 0.0f, 0, 3.0f);
-        }
-    }
-
     ImGuiRenderer::~ImGuiRenderer()
     {
         shutdown();
@@ -3,10 +3,22 @@
 //
 
 #pragma once
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <optional>
 #include <string>
 #include <vector>
 #include <vulkan/vulkan_core.h>
+#include "board_stats.h"
+#include "board_render_cache.h"
+#include "board_transfer.h"
+#include "card_search.h"
+#include "card_store.h"
+#include "delivery_forecast.h"
+#include "frame_arena.h"
 #include "todo_card.h"
+#include "ui_task.h"
 
 
 #include "imgui.h"
@@ -17,6 +29,7 @@ namespace todo {
     enum class CardStatus;
     class Graphics;
     class Application;
+    class JobSystem;
 
     struct DragDropPayload
     {
@@ -42,26 +55,40 @@ namespace todo {
         ~ImGuiRenderer();
 
         void initialize();
+        // Reads the TTF on a worker and makes it the default font once it is in; the built-in
+        // font is used until then, or for good if the file is missing
+        void loadFontAsync(JobSystem &jobs, const std::string &path);
         void handleDropZoneTarget(CardColumnType cardColumn);
         void renderDropZoneOverlays();
         void handleDropZoneMove(const DragDropPayload *payload, CardColumnType targetColumn);
-        void assignCardList(TodoCard &card, std::vector<TodoCard> &cards) const;
-        void loadCardLists(std::vector<TodoCard> &todoCards,
-                           std::vector<TodoCard> &inProgressCards, std::vector<TodoCard> &doneCards) const;
+        [[nodiscard]] int currentProjectId() const;
         void renderUI();
         void shutdown();
+        // Placeholder cards for a column while the board is still loading
+        void drawSkeletonColumn() const;
 
         void beginFrame();
         void endFrame();
         void render(VkCommandBuffer commandBuffer);
 
         void renderHeader();
+        void renderSearchBar();
+        bool openSearchResult(int cardId);
 
         void openConfirmDeleteModal(int cardId);
         void renderConfirmDeleteModal();
         void openViewCardModal();
         void renderViewCardModal();
         void renderAddProjectModal();
+        void renderConfirmRestoreModal();
+        void renderTransferModal();
+        void renderDatabaseDiagnostics();
+        void renderAllocationOverlay();
+        void renderStatistics();
+        void renderCycleTimePercentiles(int projectId);
+        void renderForecast();
+        UiTask refreshStatistics(int days, int projectId);
+        UiTask runForecast(int projectId);
         void createDescriptorPool();
 
         void openEditCardModal();
@@ -85,11 +112,6 @@ namespace todo {
         float columnWidth_ = 0;
         float columnHeight_ = 0;
 
-
-        const std::string todoDropZoneId_ = "TodoDropZone";
-        const std::string inProgressDropZoneId_ = "InProgressDropZone";
-        const std::string doneDropZoneId_ = "DoneDropZone";
-
         TodoCard pendingEditCard_{};
         TodoCard pendingViewCard_{};
 
@@ -105,14 +127,68 @@ namespace todo {
         bool shouldOpenDeleteModal_ = false;
         bool shouldOpenViewCardModal_ = false;
         bool shouldOpenProjectModal_ = false;
+        bool shouldOpenRestoreModal_ = false;
+        bool shouldOpenTransferModal_ = false;
 
         bool showAddCardModal_ = false;
         bool showEditCardModal_ = false;
         bool showProjectModal_ = false;
+        bool showRestoreModal_ = false;
+        bool showTransferModal_ = false;
+        bool showDatabaseDiagnostics_ = false;
+        bool showStatistics_ = false;
+        bool showForecast_ = false;
+        bool showAllocations_ = false;
+
+        // Transient containers and strings for the frame being built; reset in beginFrame()
+        mutable FrameArena frameArena_;
+        // The columns as drawn, rebuilt only when their cards change
+        BoardRenderCache renderCache_;
+        int pendingReorderFrom_ = -1;
+        int pendingReorderTo_ = -1;
+
+        // Allocation overlay: per-frame allocation counts over the last kAllocationHistory frames
+        static constexpr std::size_t kAllocationHistory = 120;
+        std::array<std::uint64_t, kAllocationHistory> allocationHistory_{};
+        std::size_t allocationFrames_ = 0;
+
+        // Statistics window: rollups for the chosen project (0 = all) and range, read on a worker
+        int statsProject_ = 0;
+        int statsRange_ = 0;
+        bool statsStale_ = true;
+        StatsSummary statsSummary_{};
+
+        // Cycle-time percentiles from the in-memory sketches, recomputed only when the sketches
+        // or the project filter change
+        struct PercentileRow
+        {
+            std::string label;
+            double cards;
+            double p50;
+            double p85;
+            double p95;
+        };
+        std::vector<PercentileRow> percentileRows_{};
+        std::uint64_t percentileVersion_ = 0;
+        int percentileProject_ = INT_MIN;
+
+        // Delivery forecast for the header's project, simulated on a read worker
+        DeliveryForecast forecast_{.projectId = INT_MIN};
+        int forecastProject_ = INT_MIN;
+        bool forecastRunning_ = false;
+
+        char searchQuery_[256] = "";
+        std::vector<CardSearchResult> searchResults_{};
+        int pendingOpenCardId_ = -1; // Restored from the archive; opened once the reload lands
+
+        bool transferIsImport_ = true;
+        char transferPath_[512] = "";
+        std::optional<TransferFormat> transferFormat_{};
 
         char projectName_[256] = "";
         int selectedProjectStatus_ = 0;
         const float comboBoxSize_ = 200.0f;
+        static constexpr float kCardHeight = 100.0f;
 
         // CRUD Actions
         bool createCard();
@@ -120,17 +196,15 @@ namespace todo {
         void updateCard(TodoCard &card) const;
         bool deleteCard(TodoCard &card);
 
-        void drawCardColumn(std::vector<TodoCard> &cards, const char *dragDropType);
+        void drawCardColumn(CardStatus status, const char *dragDropType);
         void handleCardReorder(const ImGuiPayload *imGuiPayload, int currentCardIndex, const char *columnType);
+        // Runs the reorder dropped while drawing, once the columns' card pointers are no longer in use
+        void applyPendingReorder();
         void ReorderCards(int from_index, int to_index);
-        void drawSingleCard(TodoCard &card, int cardIndex, const char *dragDropType);
-        void drawCardContent(const TodoCard &card);
+        void drawSingleCard(const ColumnRenderCache &column, int cardIndex, const char *dragDropType);
+        void drawCardContent(const ColumnRenderCache &column, int cardIndex);
 
         void handleColumnDrop(const char *dragDropType);
-        void handleInProgressDrop(std::vector<TodoCard> inProgressCards, TodoCard &card);
-        void handleDoneCardDrop(std::vector<TodoCard> doneCards, TodoCard &card);
-        void handleTodoCardDrop(std::vector<TodoCard> todoCards, TodoCard &card);
-        void handleCardDrop(const std::string &id, const ImVec2 &columnPos, const ImVec2 &columnSize);
 
         // Helpers
         int getColumnTypeFromDragDrop(const char * dragDropType);
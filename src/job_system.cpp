@@ -0,0 +1,165 @@
+#include "job_system.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "spdlog/spdlog.h"
+#include "trace.h"
+
+namespace todo {
+    namespace {
+        // The system and index of the worker running on this thread, for submissions from jobs
+        thread_local const JobSystem *currentSystem = nullptr;
+        thread_local unsigned currentWorker = 0;
+    }
+
+    JobSystem::JobSystem(unsigned threadCount)
+    {
+        if (threadCount == 0) threadCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+        workers_.reserve(threadCount);
+        for (unsigned i = 0; i < threadCount; i++) workers_.push_back(std::make_unique<Worker>());
+        for (unsigned i = 0; i < threadCount; i++)
+        {
+            workers_[i]->thread = std::thread(&JobSystem::workerLoop, this, i);
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        waitIdle();
+        {
+            std::lock_guard lock(sleepMutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto &worker: workers_)
+        {
+            if (worker->thread.joinable()) worker->thread.join();
+        }
+
+        for (Completion *node = completions_.exchange(nullptr); node;)
+        {
+            Completion *next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    void JobSystem::submit(Job job)
+    {
+        const unsigned index = currentSystem == this
+                                   ? currentWorker
+                                   : nextWorker_.fetch_add(1, std::memory_order_relaxed) % threadCount();
+        pending_.fetch_add(1);
+        {
+            std::lock_guard lock(workers_[index]->mutex);
+            workers_[index]->jobs.push_back(std::move(job));
+        }
+        queued_.fetch_add(1);
+
+        // Taking the lock orders this with a worker about to sleep, so the wakeup is not lost
+        {
+            std::lock_guard lock(sleepMutex_);
+        }
+        wake_.notify_one();
+    }
+
+    void JobSystem::post(Job completion)
+    {
+        auto *node = new Completion{std::move(completion), completions_.load(std::memory_order_relaxed)};
+        while (!completions_.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                                   std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void JobSystem::drainCompletions()
+    {
+        Completion *node = completions_.exchange(nullptr, std::memory_order_acquire);
+
+        Completion *ordered = nullptr;
+        while (node)
+        {
+            Completion *next = node->next;
+            node->next = ordered;
+            ordered = node;
+            node = next;
+        }
+
+        while (ordered)
+        {
+            const std::unique_ptr<Completion> completion(ordered);
+            ordered = ordered->next;
+            if (completion->job) completion->job();
+        }
+    }
+
+    void JobSystem::waitIdle()
+    {
+        for (int pending = pending_.load(); pending != 0; pending = pending_.load())
+        {
+            pending_.wait(pending);
+        }
+    }
+
+    bool JobSystem::takeJob(const unsigned index, Job &job)
+    {
+        {
+            Worker &own = *workers_[index];
+            std::lock_guard lock(own.mutex);
+            if (!own.jobs.empty())
+            {
+                job = std::move(own.jobs.back());
+                own.jobs.pop_back();
+                return true;
+            }
+        }
+
+        for (unsigned offset = 1; offset < threadCount(); offset++)
+        {
+            Worker &victim = *workers_[(index + offset) % threadCount()];
+            std::lock_guard lock(victim.mutex);
+            if (!victim.jobs.empty())
+            {
+                job = std::move(victim.jobs.front());
+                victim.jobs.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void JobSystem::workerLoop(const unsigned index)
+    {
+        currentSystem = this;
+        currentWorker = index;
+        setTraceThreadName("job worker " + std::to_string(index));
+
+        while (true)
+        {
+            Job job;
+            if (!takeJob(index, job))
+            {
+                std::unique_lock lock(sleepMutex_);
+                wake_.wait(lock, [&] { return stopping_ || queued_ > 0; });
+                if (stopping_ && queued_ == 0) break;
+                continue;
+            }
+            queued_.fetch_sub(1);
+
+            try
+            {
+                job();
+            } catch (const std::exception &e)
+            {
+                spdlog::error("Background job failed: {}", e.what());
+            } catch (...)
+            {
+                spdlog::error("Background job failed");
+            }
+
+            if (pending_.fetch_sub(1) == 1) pending_.notify_all();
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace todo {
+    // Small work-stealing thread pool for work that must not run on the frame: file and asset
+    // loading, imports, database maintenance. Each worker pops its own queue from the back
+    // (newest first, still warm in cache) and, when that is empty, steals the oldest job from
+    // another worker. Jobs submitted from a worker go to that worker's queue.
+    //
+    // Results come back to the UI thread through a lock-free completion queue that the main
+    // loop drains at the top of every frame, so UI state is only ever touched there.
+    class JobSystem
+    {
+    public:
+        using Job = std::function<void()>;
+
+        // 0 = one thread per core, minus the UI thread
+        explicit JobSystem(unsigned threadCount = 0);
+        // Finishes the jobs already queued; completions not yet drained are dropped
+        ~JobSystem();
+
+        JobSystem(const JobSystem &) = delete;
+        JobSystem &operator=(const JobSystem &) = delete;
+
+        // Runs `job` on a worker. Callable from any thread.
+        void submit(Job job);
+
+        // `work` runs on a worker, `apply` receives its result on the UI thread. If `work` throws,
+        // `failed` runs on the UI thread instead, so state waiting on the result can be cleared.
+        template<typename Result>
+        void run(std::function<Result()> work, std::function<void(Result &)> apply, Job failed = nullptr)
+        {
+            submit([this, work = std::move(work), apply = std::move(apply), failed = std::move(failed)]
+            {
+                std::shared_ptr<Result> result;
+                try
+                {
+                    result = std::make_shared<Result>(work());
+                } catch (...)
+                {
+                    // The worker loop logs the exception
+                    if (failed) post(failed);
+                    throw;
+                }
+                post([apply, result] { apply(*result); });
+            });
+        }
+
+        // Queues `completion` for the UI thread. Lock-free, callable from any thread.
+        void post(Job completion);
+
+        // Runs every posted completion in posting order. Call once per frame from the UI thread.
+        void drainCompletions();
+
+        // Blocks until every submitted job has finished (for shutdown)
+        void waitIdle();
+
+        [[nodiscard]] unsigned threadCount() const { return static_cast<unsigned>(workers_.size()); }
+
+    private:
+        struct Worker
+        {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+            std::thread thread;
+        };
+
+        // Intrusive Treiber stack: producers push with a single CAS and the UI thread takes the
+        // whole list with one exchange, reversing it back into posting order
+        struct Completion
+        {
+            Job job;
+            Completion *next = nullptr;
+        };
+
+        void workerLoop(unsigned index);
+        bool takeJob(unsigned index, Job &job);
+
+        std::vector<std::unique_ptr<Worker>> workers_;
+        std::atomic<unsigned> nextWorker_ = 0;
+        std::atomic<int> queued_ = 0; // in a worker queue
+        std::atomic<int> pending_ = 0; // submitted and not finished
+        std::atomic<bool> stopping_ = false;
+
+        std::mutex sleepMutex_;
+        std::condition_variable wake_;
+
+        std::atomic<Completion *> completions_ = nullptr;
+    };
+}
@@ -0,0 +1,444 @@
+#include "json_stream.h"
+
+#include <cstring>
+
+namespace todo {
+    JsonReader::JsonReader(std::FILE *file, const size_t bufferSize)
+        : file_(file), buffer_(bufferSize)
+    {
+    }
+
+    bool JsonReader::refill()
+    {
+        if (!file_) return false;
+        pos_ = 0;
+        end_ = std::fread(buffer_.data(), 1, buffer_.size(), file_);
+        bytesRead_ += end_;
+        return end_ > 0;
+    }
+
+    int JsonReader::next()
+    {
+        if (pos_ == end_ && !refill()) return EOF;
+        return static_cast<unsigned char>(buffer_[pos_++]);
+    }
+
+    int JsonReader::peek()
+    {
+        if (pos_ == end_ && !refill()) return EOF;
+        return static_cast<unsigned char>(buffer_[pos_]);
+    }
+
+    int JsonReader::nextNonSpace()
+    {
+        int c = next();
+        while (c == ' ' || c == '\n' || c == '\r' || c == '\t') c = next();
+        return c;
+    }
+
+    int JsonReader::peekNonSpace()
+    {
+        int c = peek();
+        while (c == ' ' || c == '\n' || c == '\r' || c == '\t')
+        {
+            pos_++;
+            c = peek();
+        }
+        return c;
+    }
+
+    bool JsonReader::fail(const char *message)
+    {
+        error_ = std::string(message) + " at byte " + std::to_string(bytesConsumed());
+        return false;
+    }
+
+    bool JsonReader::cancel()
+    {
+        cancelled_ = true;
+        return false;
+    }
+
+    bool JsonReader::parse(Handler &handler, const bool valueSequence)
+    {
+        error_.clear();
+        cancelled_ = false;
+
+        do
+        {
+            if (peekNonSpace() == EOF)
+            {
+                return valueSequence || fail("Unexpected end of input");
+            }
+            if (!parseValue(handler)) return false;
+        } while (valueSequence);
+
+        return peekNonSpace() == EOF || fail("Unexpected data after document");
+    }
+
+    bool JsonReader::parseValue(Handler &handler)
+    {
+        // Iterative so deeply nested input cannot overflow the call stack
+        stack_.clear();
+        while (true)
+        {
+            bool complete = true;
+            const int c = nextNonSpace();
+            switch (c)
+            {
+                case '{':
+                    if (!handler.startObject()) return cancel();
+                    if (peekNonSpace() == '}')
+                    {
+                        pos_++;
+                        if (!handler.endObject()) return cancel();
+                    } else
+                    {
+                        stack_.push_back('{');
+                        if (!readKey(handler)) return false;
+                        complete = false;
+                    }
+                    break;
+                case '[':
+                    if (!handler.startArray()) return cancel();
+                    if (peekNonSpace() == ']')
+                    {
+                        pos_++;
+                        if (!handler.endArray()) return cancel();
+                    } else
+                    {
+                        stack_.push_back('[');
+                        complete = false;
+                    }
+                    break;
+                case '"':
+                    if (!readString()) return false;
+                    if (!handler.string(scratch_)) return cancel();
+                    break;
+                case 't':
+                    if (!readLiteral("rue")) return false;
+                    if (!handler.boolean(true)) return cancel();
+                    break;
+                case 'f':
+                    if (!readLiteral("alse")) return false;
+                    if (!handler.boolean(false)) return cancel();
+                    break;
+                case 'n':
+                    if (!readLiteral("ull")) return false;
+                    if (!handler.null()) return cancel();
+                    break;
+                case EOF:
+                    return fail("Unexpected end of input");
+                default:
+                    if (c != '-' && (c < '0' || c > '9')) return fail("Unexpected character");
+                    if (!readNumber(c)) return false;
+                    if (!handler.number(scratch_)) return cancel();
+                    break;
+            }
+
+            if (!complete) continue;
+
+            // A value just finished: close any containers that end here, then move to the next element
+            while (true)
+            {
+                if (stack_.empty()) return true;
+
+                const int separator = nextNonSpace();
+                if (separator == ',')
+                {
+                    if (stack_.back() == '{' && !readKey(handler)) return false;
+                    break;
+                }
+                if (separator == '}' && stack_.back() == '{')
+                {
+                    stack_.pop_back();
+                    if (!handler.endObject()) return cancel();
+                    continue;
+                }
+                if (separator == ']' && stack_.back() == '[')
+                {
+                    stack_.pop_back();
+                    if (!handler.endArray()) return cancel();
+                    continue;
+                }
+                return fail("Expected ',' or closing bracket");
+            }
+        }
+    }
+
+    bool JsonReader::readKey(Handler &handler)
+    {
+        if (nextNonSpace() != '"') return fail("Expected object key");
+        if (!readString()) return false;
+        if (!handler.key(scratch_)) return cancel();
+        if (nextNonSpace() != ':') return fail("Expected ':' after object key");
+        return true;
+    }
+
+    bool JsonReader::readString()
+    {
+        scratch_.clear();
+        while (true)
+        {
+            if (pos_ == end_ && !refill()) return fail("Unterminated string");
+
+            // Copy the plain run up to the next quote or escape in one go
+            const char *start = buffer_.data() + pos_;
+            const char *stop = start;
+            const char *limit = buffer_.data() + end_;
+            while (stop < limit && *stop != '"' && *stop != '\\') stop++;
+            scratch_.append(start, stop);
+            pos_ += stop - start;
+            if (stop == limit) continue;
+
+            if (next() == '"') return true;
+
+            switch (next())
+            {
+                case '"': scratch_ += '"';
+                    break;
+                case '\\': scratch_ += '\\';
+                    break;
+                case '/': scratch_ += '/';
+                    break;
+                case 'b': scratch_ += '\b';
+                    break;
+                case 'f': scratch_ += '\f';
+                    break;
+                case 'n': scratch_ += '\n';
+                    break;
+                case 'r': scratch_ += '\r';
+                    break;
+                case 't': scratch_ += '\t';
+                    break;
+                case 'u':
+                {
+                    auto readHex = [this](std::uint32_t &value)
+                    {
+                        value = 0;
+                        for (int i = 0; i < 4; i++)
+                        {
+                            const int h = next();
+                            value <<= 4;
+                            if (h >= '0' && h <= '9') value |= h - '0';
+                            else if (h >= 'a' && h <= 'f') value |= h - 'a' + 10;
+                            else if (h >= 'A' && h <= 'F') value |= h - 'A' + 10;
+                            else return false;
+                        }
+                        return true;
+                    };
+
+                    std::uint32_t codePoint = 0;
+                    if (!readHex(codePoint)) return fail("Invalid \\u escape");
+
+                    // Surrogate pair: a high surrogate must be followed by \uDC00-\uDFFF
+                    if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+                    {
+                        std::uint32_t low = 0;
+                        if (next() != '\\' || next() != 'u' || !readHex(low) || low < 0xDC00 || low > 0xDFFF)
+                        {
+                            return fail("Invalid surrogate pair");
+                        }
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    if (!appendCodePoint(codePoint)) return fail("Invalid code point");
+                    break;
+                }
+                default:
+                    return fail("Invalid escape sequence");
+            }
+        }
+    }
+
+    bool JsonReader::appendCodePoint(const std::uint32_t codePoint)
+    {
+        if (codePoint < 0x80)
+        {
+            scratch_ += static_cast<char>(codePoint);
+        } else if (codePoint < 0x800)
+        {
+            scratch_ += static_cast<char>(0xC0 | (codePoint >> 6));
+            scratch_ += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else if (codePoint < 0x10000)
+        {
+            if (codePoint >= 0xD800 && codePoint <= 0xDFFF) return false;
+            scratch_ += static_cast<char>(0xE0 | (codePoint >> 12));
+            scratch_ += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            scratch_ += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else if (codePoint < 0x110000)
+        {
+            scratch_ += static_cast<char>(0xF0 | (codePoint >> 18));
+            scratch_ += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            scratch_ += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            scratch_ += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    bool JsonReader::readNumber(const int first)
+    {
+        scratch_.assign(1, static_cast<char>(first));
+        while (true)
+        {
+            const int c = peek();
+            const bool numeric = (c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-';
+            if (!numeric) break;
+            scratch_ += static_cast<char>(c);
+            pos_++;
+        }
+        return scratch_ != "-" || fail("Invalid number");
+    }
+
+    bool JsonReader::readLiteral(const char *rest)
+    {
+        for (; *rest; rest++)
+        {
+            if (next() != *rest) return fail("Invalid literal");
+        }
+        return true;
+    }
+
+    JsonWriter::JsonWriter(std::FILE *file, const size_t bufferSize)
+        : file_(file), bufferSize_(bufferSize)
+    {
+        out_.reserve(bufferSize_ + 4096);
+    }
+
+    JsonWriter::~JsonWriter()
+    {
+        flush();
+    }
+
+    void JsonWriter::separate()
+    {
+        if (afterKey_)
+        {
+            afterKey_ = false;
+            return;
+        }
+        if (hasElement_.empty()) return;
+        if (hasElement_.back()) out_ += ',';
+        hasElement_.back() = true;
+    }
+
+    void JsonWriter::maybeFlush()
+    {
+        if (out_.size() >= bufferSize_) flush();
+    }
+
+    void JsonWriter::startObject()
+    {
+        separate();
+        out_ += '{';
+        hasElement_.push_back(false);
+    }
+
+    void JsonWriter::endObject()
+    {
+        out_ += '}';
+        hasElement_.pop_back();
+        maybeFlush();
+    }
+
+    void JsonWriter::startArray()
+    {
+        separate();
+        out_ += '[';
+        hasElement_.push_back(false);
+    }
+
+    void JsonWriter::endArray()
+    {
+        out_ += ']';
+        hasElement_.pop_back();
+        maybeFlush();
+    }
+
+    void JsonWriter::key(const std::string_view name)
+    {
+        separate();
+        appendJsonEscaped(out_, name);
+        out_ += ':';
+        afterKey_ = true;
+    }
+
+    void JsonWriter::string(const std::string_view value)
+    {
+        separate();
+        appendJsonEscaped(out_, value);
+        maybeFlush();
+    }
+
+    void JsonWriter::number(const std::int64_t value)
+    {
+        separate();
+        out_ += std::to_string(value);
+    }
+
+    void JsonWriter::boolean(const bool value)
+    {
+        separate();
+        out_ += value ? "true" : "false";
+    }
+
+    void JsonWriter::null()
+    {
+        separate();
+        out_ += "null";
+    }
+
+    void JsonWriter::newline()
+    {
+        out_ += '\n';
+        maybeFlush();
+    }
+
+    bool JsonWriter::flush()
+    {
+        if (!out_.empty() && !failed_)
+        {
+            failed_ = std::fwrite(out_.data(), 1, out_.size(), file_) != out_.size();
+        }
+        out_.clear();
+        return !failed_;
+    }
+
+    void appendJsonEscaped(std::string &out, const std::string_view value)
+    {
+        static constexpr char hex[] = "0123456789abcdef";
+
+        out += '"';
+        size_t runStart = 0;
+        for (size_t i = 0; i < value.size(); i++)
+        {
+            const auto c = static_cast<unsigned char>(value[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+            out.append(value.data() + runStart, i - runStart);
+            runStart = i + 1;
+            switch (c)
+            {
+                case '"': out += "\\\"";
+                    break;
+                case '\\': out += "\\\\";
+                    break;
+                case '\n': out += "\\n";
+                    break;
+                case '\r': out += "\\r";
+                    break;
+                case '\t': out += "\\t";
+                    break;
+                default:
+                    out += "\\u00";
+                    out += hex[c >> 4];
+                    out += hex[c & 0xF];
+                    break;
+            }
+        }
+        out.append(value.data() + runStart, value.size() - runStart);
+        out += '"';
+    }
+}
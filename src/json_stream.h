@@ -0,0 +1,109 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace todo {
+    // SAX-style JSON parser over a FILE*. Input is read through a fixed-size buffer and every
+    // string is handed to the handler from a reused scratch buffer, so memory use depends on
+    // the longest single string and the nesting depth, not on the size of the document.
+    class JsonReader
+    {
+    public:
+        // Returning false from any callback stops parsing (parse() then returns false with no error)
+        struct Handler
+        {
+            virtual ~Handler() = default;
+            virtual bool startObject() { return true; }
+            virtual bool endObject() { return true; }
+            virtual bool startArray() { return true; }
+            virtual bool endArray() { return true; }
+            virtual bool key([[maybe_unused]] std::string_view name) { return true; }
+            virtual bool string([[maybe_unused]] std::string_view value) { return true; }
+            // Raw number text, so callers decide between integer and floating point
+            virtual bool number([[maybe_unused]] std::string_view value) { return true; }
+            virtual bool boolean([[maybe_unused]] bool value) { return true; }
+            virtual bool null() { return true; }
+        };
+
+        explicit JsonReader(std::FILE *file, size_t bufferSize = 1 << 20);
+
+        // Parses a single document, or with `valueSequence` a whitespace-separated run of
+        // documents until end of file (JSON Lines).
+        bool parse(Handler &handler, bool valueSequence = false);
+
+        [[nodiscard]] const std::string &error() const { return error_; }
+        [[nodiscard]] bool cancelled() const { return cancelled_; }
+        [[nodiscard]] std::uint64_t bytesConsumed() const { return bytesRead_ - (end_ - pos_); }
+
+    private:
+        bool parseValue(Handler &handler);
+        bool readKey(Handler &handler);
+        bool readString();
+        bool readNumber(int first);
+        bool readLiteral(const char *rest);
+        bool appendCodePoint(std::uint32_t codePoint);
+
+        bool refill();
+        int next();
+        int peek();
+        int nextNonSpace();
+        int peekNonSpace();
+
+        bool fail(const char *message);
+        bool cancel();
+
+        std::FILE *file_;
+        std::vector<char> buffer_;
+        size_t pos_ = 0;
+        size_t end_ = 0;
+        std::uint64_t bytesRead_ = 0;
+
+        std::string scratch_;
+        std::vector<char> stack_;
+        std::string error_;
+        bool cancelled_ = false;
+    };
+
+    // Streaming counterpart of JsonReader: values are appended to a buffer that is flushed
+    // to the FILE* whenever it grows past `bufferSize`.
+    class JsonWriter
+    {
+    public:
+        explicit JsonWriter(std::FILE *file, size_t bufferSize = 1 << 20);
+        ~JsonWriter();
+
+        JsonWriter(const JsonWriter &) = delete;
+        JsonWriter &operator=(const JsonWriter &) = delete;
+
+        void startObject();
+        void endObject();
+        void startArray();
+        void endArray();
+        void key(std::string_view name);
+        void string(std::string_view value);
+        void number(std::int64_t value);
+        void boolean(bool value);
+        void null();
+
+        // Ends the current top-level value with '\n' (one document per line)
+        void newline();
+
+        bool flush();
+
+    private:
+        void separate();
+        void maybeFlush();
+
+        std::FILE *file_;
+        size_t bufferSize_;
+        std::string out_;
+        std::vector<bool> hasElement_;
+        bool afterKey_ = false;
+        bool failed_ = false;
+    };
+
+    void appendJsonEscaped(std::string &out, std::string_view value);
+}
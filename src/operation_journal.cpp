@@ -0,0 +1,410 @@
+#include "operation_journal.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "card_database.h"
+#include "spdlog/spdlog.h"
+
+namespace todo {
+    namespace {
+        // Diff blob: one byte of Field flags, then the value of each flagged field in flag order.
+        // Integers are 4 bytes, text is a 4-byte length followed by the UTF-8 bytes.
+        enum Field : std::uint8_t
+        {
+            Title = 1 << 0,
+            Description = 1 << 1,
+            Status = 1 << 2,
+            Sequence = 1 << 3,
+            Project = 1 << 4,
+            CompletedAt = 1 << 5,
+            CreatedAt = 1 << 6,
+            AllFields = 0x7f
+        };
+
+        std::uint8_t changedFields(const TodoCard &a, const TodoCard &b)
+        {
+            std::uint8_t fields = 0;
+            if (a.title != b.title) fields |= Title;
+            if (a.description != b.description) fields |= Description;
+            if (a.status != b.status) fields |= Status;
+            if (a.sequence != b.sequence) fields |= Sequence;
+            if (a.projectId != b.projectId) fields |= Project;
+            if (a.completedAt != b.completedAt) fields |= CompletedAt;
+            return fields;
+        }
+
+        void putInt(std::string &out, const std::int32_t value)
+        {
+            char bytes[sizeof(value)];
+            std::memcpy(bytes, &value, sizeof(value));
+            out.append(bytes, sizeof(bytes));
+        }
+
+        void putText(std::string &out, const std::string &text)
+        {
+            putInt(out, static_cast<std::int32_t>(text.size()));
+            out += text;
+        }
+
+        std::string encode(const TodoCard &card, const std::uint8_t fields)
+        {
+            std::string out(1, static_cast<char>(fields));
+            if (fields & Title) putText(out, card.title);
+            if (fields & Description) putText(out, card.description);
+            if (fields & Status) putInt(out, statusToInt(card.status));
+            if (fields & Sequence) putInt(out, card.sequence);
+            if (fields & Project) putInt(out, card.projectId);
+            if (fields & CompletedAt) putText(out, card.completedAt);
+            if (fields & CreatedAt) putText(out, card.createdAt);
+            return out;
+        }
+
+        class DiffReader
+        {
+        public:
+            explicit DiffReader(const std::string_view blob) : blob_(blob)
+            {
+            }
+
+            bool readInt(std::int32_t &value)
+            {
+                if (blob_.size() - pos_ < sizeof(value)) return false;
+                std::memcpy(&value, blob_.data() + pos_, sizeof(value));
+                pos_ += sizeof(value);
+                return true;
+            }
+
+            bool readText(std::string &text)
+            {
+                std::int32_t length = 0;
+                if (!readInt(length) || length < 0 || blob_.size() - pos_ < static_cast<size_t>(length)) return false;
+                text.assign(blob_.data() + pos_, static_cast<size_t>(length));
+                pos_ += static_cast<size_t>(length);
+                return true;
+            }
+
+        private:
+            std::string_view blob_;
+            size_t pos_ = 1;
+        };
+
+        // Overlays the fields stored in `blob` onto `card`
+        bool decode(const std::string_view blob, TodoCard &card)
+        {
+            if (blob.empty()) return false;
+            const auto fields = static_cast<std::uint8_t>(blob[0]);
+
+            DiffReader reader(blob);
+            std::int32_t value = 0;
+            bool ok = true;
+            if (ok && (fields & Title)) ok = reader.readText(card.title);
+            if (ok && (fields & Description)) ok = reader.readText(card.description);
+            if (ok && (fields & Status) && (ok = reader.readInt(value))) card.status = intToStatus(value);
+            if (ok && (fields & Sequence) && (ok = reader.readInt(value))) card.sequence = value;
+            if (ok && (fields & Project) && (ok = reader.readInt(value))) card.projectId = value;
+            if (ok && (fields & CompletedAt)) ok = reader.readText(card.completedAt);
+            if (ok && (fields & CreatedAt)) ok = reader.readText(card.createdAt);
+            return ok;
+        }
+
+        struct CardChange
+        {
+            int cardId = 0;
+            std::optional<std::string> before; // nullopt: the card did not exist
+            std::optional<std::string> after; // nullopt: the card was deleted
+        };
+
+        std::optional<std::string> columnBlob(sqlite3_stmt *stmt, const int column)
+        {
+            if (sqlite3_column_type(stmt, column) == SQLITE_NULL) return std::nullopt;
+            const auto *data = static_cast<const char *>(sqlite3_column_blob(stmt, column));
+            return std::string(data, static_cast<size_t>(sqlite3_column_bytes(stmt, column)));
+        }
+
+        void bindBlob(sqlite3_stmt *stmt, const int index, const std::optional<std::string> &blob)
+        {
+            if (blob) sqlite3_bind_blob(stmt, index, blob->data(), static_cast<int>(blob->size()), SQLITE_STATIC);
+            else sqlite3_bind_null(stmt, index);
+        }
+
+        std::unordered_map<int, TodoCard> cardsById(std::vector<TodoCard> cards)
+        {
+            std::unordered_map<int, TodoCard> byId;
+            byId.reserve(cards.size());
+            for (auto &card: cards) byId.emplace(card.id, std::move(card));
+            return byId;
+        }
+    }
+
+    OperationJournal::OperationJournal(CardDatabase &db) : db_(db), handle_(db.handle())
+    {
+    }
+
+    bool OperationJournal::apply(const CardBatch &batch, const std::string &label)
+    {
+        if (batch.empty()) return true;
+
+        if (sqlite3_exec(handle_, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK)
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(handle_));
+            return false;
+        }
+
+        std::vector<int> ids;
+        ids.reserve(batch.size());
+        for (const auto &mutation: batch.mutations())
+        {
+            if (mutation.kind != CardMutation::Kind::Insert) ids.push_back(mutation.card.id);
+        }
+        std::ranges::sort(ids);
+        ids.erase(std::ranges::unique(ids).begin(), ids.end());
+        const auto before = cardsById(CardDatabase::readCards(handle_, ids));
+
+        // Nested in this transaction, so the batch and its journal entry commit together
+        std::vector<int> inserted;
+        if (!db_.applyBatch(batch.mutations(), &inserted))
+        {
+            sqlite3_exec(handle_, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
+        ids.insert(ids.end(), inserted.begin(), inserted.end());
+        const auto after = cardsById(CardDatabase::readCards(handle_, ids));
+
+        std::vector<CardChange> changes;
+        for (const int id: ids)
+        {
+            const auto from = before.find(id);
+            const auto to = after.find(id);
+            CardChange change{id};
+            if (from != before.end() && to != after.end())
+            {
+                const std::uint8_t fields = changedFields(from->second, to->second);
+                if (fields == 0) continue;
+                change.before = encode(from->second, fields);
+                change.after = encode(to->second, fields);
+            } else if (from != before.end())
+            {
+                change.before = encode(from->second, AllFields);
+            } else if (to != after.end())
+            {
+                change.after = encode(to->second, AllFields);
+            } else
+            {
+                continue;
+            }
+            changes.push_back(std::move(change));
+        }
+
+        bool success = true;
+        if (!changes.empty())
+        {
+            // A new action forks history: what was undone can no longer be redone
+            success = sqlite3_exec(handle_,
+                                   "DELETE FROM journal_changes WHERE entry IN (SELECT id FROM journal WHERE undone = 1);"
+                                   "DELETE FROM journal WHERE undone = 1;", nullptr, nullptr, nullptr) == SQLITE_OK;
+
+            sqlite3_stmt *stmt = nullptr;
+            if (success && sqlite3_prepare_v2(handle_, "INSERT INTO journal (label) VALUES (?);", -1, &stmt,
+                                              nullptr) == SQLITE_OK)
+            {
+                sqlite3_bind_text(stmt, 1, label.c_str(), -1, SQLITE_TRANSIENT);
+                success = sqlite3_step(stmt) == SQLITE_DONE;
+            } else
+            {
+                success = false;
+            }
+            sqlite3_finalize(stmt);
+            const sqlite3_int64 entry = sqlite3_last_insert_rowid(handle_);
+
+            stmt = nullptr;
+            const char *sql = "INSERT INTO journal_changes (entry, card_id, before, after) VALUES (?, ?, ?, ?);";
+            if (success && sqlite3_prepare_v2(handle_, sql, -1, &stmt, nullptr) == SQLITE_OK)
+            {
+                for (const auto &change: changes)
+                {
+                    sqlite3_bind_int64(stmt, 1, entry);
+                    sqlite3_bind_int(stmt, 2, change.cardId);
+                    bindBlob(stmt, 3, change.before);
+                    bindBlob(stmt, 4, change.after);
+                    if (sqlite3_step(stmt) != SQLITE_DONE)
+                    {
+                        success = false;
+                        break;
+                    }
+                    sqlite3_reset(stmt);
+                }
+            } else
+            {
+                success = false;
+            }
+            sqlite3_finalize(stmt);
+        }
+
+        if (!success || sqlite3_exec(handle_, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK)
+        {
+            spdlog::error("Failed to record '{}': {}", label, sqlite3_errmsg(handle_));
+            sqlite3_exec(handle_, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
+        return true;
+    }
+
+    bool OperationJournal::undo()
+    {
+        return replay(true);
+    }
+
+    bool OperationJournal::redo()
+    {
+        return replay(false);
+    }
+
+    bool OperationJournal::replay(const bool undo)
+    {
+        if (sqlite3_exec(handle_, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK)
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(handle_));
+            return false;
+        }
+        auto fail = [this]
+        {
+            sqlite3_exec(handle_, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        };
+
+        // Undo takes the newest applied entry, redo the oldest undone one
+        const char *findSql = undo
+                                  ? "SELECT id, label FROM journal WHERE undone = 0 ORDER BY id DESC LIMIT 1;"
+                                  : "SELECT id, label FROM journal WHERE undone = 1 ORDER BY id ASC LIMIT 1;";
+        sqlite3_int64 entry = 0;
+        std::string label;
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(handle_, findSql, -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            entry = sqlite3_column_int64(stmt, 0);
+            label = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1));
+        }
+        sqlite3_finalize(stmt);
+        if (entry == 0) return fail();
+
+        std::vector<CardChange> changes;
+        std::vector<int> ids;
+        stmt = nullptr;
+        if (sqlite3_prepare_v2(handle_, "SELECT card_id, before, after FROM journal_changes WHERE entry = ?;", -1,
+                               &stmt, nullptr) != SQLITE_OK)
+        {
+            spdlog::error("SQL error: {}", sqlite3_errmsg(handle_));
+            return fail();
+        }
+        sqlite3_bind_int64(stmt, 1, entry);
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            // Replaying backwards is replaying forwards with before and after swapped
+            CardChange change{sqlite3_column_int(stmt, 0), columnBlob(stmt, 1), columnBlob(stmt, 2)};
+            if (undo) std::swap(change.before, change.after);
+            ids.push_back(change.cardId);
+            changes.push_back(std::move(change));
+        }
+        sqlite3_finalize(stmt);
+
+        auto current = cardsById(CardDatabase::readCards(handle_, ids));
+        CardBatch batch;
+        batch.reserve(changes.size());
+        for (const auto &change: changes)
+        {
+            const auto found = current.find(change.cardId);
+            if (!change.after)
+            {
+                if (found != current.end()) batch.remove(change.cardId);
+            } else if (found != current.end())
+            {
+                // Only the recorded fields are put back; anything else edited since is kept.
+                // A move leaves title and description alone, and so the search index.
+                if (!decode(*change.after, found->second)) return fail();
+                const auto fields = static_cast<std::uint8_t>((*change.after)[0]);
+                if ((fields & ~(Status | Sequence | CompletedAt)) == 0) batch.move(found->second);
+                else batch.update(found->second);
+            } else if (!change.before)
+            {
+                TodoCard card;
+                card.id = change.cardId;
+                if (!decode(*change.after, card)) return fail();
+                batch.restore(card);
+            }
+            // else: changed by the entry but deleted since; there is nothing left to revert
+        }
+
+        if (!db_.applyBatch(batch.mutations())) return fail();
+
+        stmt = nullptr;
+        bool success = sqlite3_prepare_v2(handle_, "UPDATE journal SET undone = ? WHERE id = ?;", -1, &stmt,
+                                          nullptr) == SQLITE_OK;
+        if (success)
+        {
+            sqlite3_bind_int(stmt, 1, undo ? 1 : 0);
+            sqlite3_bind_int64(stmt, 2, entry);
+            success = sqlite3_step(stmt) == SQLITE_DONE;
+        }
+        sqlite3_finalize(stmt);
+
+        if (!success || sqlite3_exec(handle_, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK)
+        {
+            spdlog::error("Failed to {} '{}': {}", undo ? "undo" : "redo", label, sqlite3_errmsg(handle_));
+            return fail();
+        }
+        spdlog::info("{} '{}' ({} cards)", undo ? "Undid" : "Redid", label, batch.size());
+        return true;
+    }
+
+    std::string OperationJournal::undoLabel() const
+    {
+        return label(false);
+    }
+
+    std::string OperationJournal::redoLabel() const
+    {
+        return label(true);
+    }
+
+    std::string OperationJournal::label(const bool undone) const
+    {
+        const char *sql = undone
+                              ? "SELECT label FROM journal WHERE undone = 1 ORDER BY id ASC LIMIT 1;"
+                              : "SELECT label FROM journal WHERE undone = 0 ORDER BY id DESC LIMIT 1;";
+        std::string label;
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(handle_, sql, -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            label = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
+        }
+        sqlite3_finalize(stmt);
+        return label;
+    }
+
+    void OperationJournal::compact(const int keep) const
+    {
+        // Changes first: if the second delete never runs, the leftover entries are merely empty
+        const char *sqls[] = {
+            "DELETE FROM journal_changes WHERE entry NOT IN (SELECT id FROM journal ORDER BY id DESC LIMIT ?);",
+            "DELETE FROM journal WHERE id NOT IN (SELECT id FROM journal ORDER BY id DESC LIMIT ?);"
+        };
+        for (const char *sql: sqls)
+        {
+            sqlite3_stmt *stmt = nullptr;
+            if (sqlite3_prepare_v2(handle_, sql, -1, &stmt, nullptr) != SQLITE_OK)
+            {
+                spdlog::error("SQL error: {}", sqlite3_errmsg(handle_));
+                return;
+            }
+            sqlite3_bind_int(stmt, 1, keep);
+            if (sqlite3_step(stmt) != SQLITE_DONE) spdlog::error("SQL error: {}", sqlite3_errmsg(handle_));
+            sqlite3_finalize(stmt);
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <string>
+
+#include "card_batch.h"
+#include "sqlite3.h"
+
+namespace todo {
+    class CardDatabase;
+
+    // Append-only undo/redo history of board edits, persisted in the `journal` tables so it
+    // survives restarts. Each apply() is one entry holding, per touched card, only the fields
+    // that changed (before and after), not whole card copies. Undo and redo replay an entry
+    // as one CardBatch, so reverting a 500-card move is a single transaction.
+    //
+    // Undoing restores just the fields the entry changed, so edits made to other fields since
+    // (by another window or a synced device) are kept.
+    class OperationJournal
+    {
+    public:
+        explicit OperationJournal(CardDatabase &db);
+
+        OperationJournal(const OperationJournal &) = delete;
+        OperationJournal &operator=(const OperationJournal &) = delete;
+
+        // Applies the batch and records it under `label` in the same transaction. A new entry
+        // discards whatever could have been redone.
+        bool apply(const CardBatch &batch, const std::string &label);
+
+        bool undo();
+        bool redo();
+
+        // Labels of the entries undo() and redo() would replay; empty when there is none
+        [[nodiscard]] std::string undoLabel() const;
+        [[nodiscard]] std::string redoLabel() const;
+
+        // Drops all but the newest `keep` entries
+        void compact(int keep) const;
+
+    private:
+        bool replay(bool undo);
+        [[nodiscard]] std::string label(bool undone) const;
+
+        CardDatabase &db_;
+        sqlite3 *handle_ = nullptr;
+    };
+}
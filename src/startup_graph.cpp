@@ -0,0 +1,151 @@
+#include "startup_graph.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "job_system.h"
+#include "spdlog/spdlog.h"
+
+namespace todo {
+    StartupGraph::TaskId StartupGraph::add(std::string name, const Affinity affinity, std::function<void()> work,
+                                           const std::initializer_list<TaskId> dependencies)
+    {
+        const TaskId id = tasks_.size();
+        for (const TaskId dependency: dependencies)
+        {
+            if (dependency >= id) throw std::invalid_argument("startup task depends on a task added after it");
+            tasks_[dependency].dependents.push_back(id);
+        }
+
+        Task &task = tasks_.emplace_back();
+        task.name = std::move(name);
+        task.affinity = affinity;
+        task.work = std::move(work);
+        task.dependencies = dependencies;
+        task.remaining = dependencies.size();
+        return id;
+    }
+
+    void StartupGraph::run()
+    {
+        std::unique_lock lock(mutex_);
+        origin_ = std::chrono::steady_clock::now();
+        for (TaskId id = 0; id < tasks_.size(); id++)
+        {
+            if (tasks_[id].remaining == 0) schedule(id);
+        }
+
+        while (finished_ < tasks_.size())
+        {
+            if (mainReady_.empty())
+            {
+                changed_.wait(lock);
+                continue;
+            }
+
+            const TaskId id = mainReady_.front();
+            mainReady_.pop_front();
+            lock.unlock();
+            execute(id);
+            lock.lock();
+        }
+        wall_ = elapsed();
+
+        if (error_) std::rethrow_exception(error_);
+    }
+
+    void StartupGraph::schedule(const TaskId id)
+    {
+        if (tasks_[id].affinity == Affinity::Main)
+        {
+            mainReady_.push_back(id);
+            changed_.notify_all();
+        } else
+        {
+            jobs_.submit([this, id] { execute(id); });
+        }
+    }
+
+    void StartupGraph::execute(const TaskId id)
+    {
+        Task &task = tasks_[id];
+
+        bool skip;
+        {
+            std::lock_guard lock(mutex_);
+            skip = error_ != nullptr;
+        }
+
+        std::exception_ptr error;
+        if (!skip)
+        {
+            task.start = elapsed();
+            try
+            {
+                task.work();
+            } catch (...)
+            {
+                error = std::current_exception();
+            }
+            task.end = elapsed();
+            task.ran = true;
+        }
+
+        // Skipped tasks still release their dependents, which are then skipped in turn
+        std::lock_guard lock(mutex_);
+        if (error && !error_)
+        {
+            spdlog::error("Startup task '{}' failed", task.name);
+            error_ = std::move(error);
+        }
+        error = nullptr; // dropped before run() can return and rethrow
+        for (const TaskId dependent: task.dependents)
+        {
+            if (--tasks_[dependent].remaining == 0) schedule(dependent);
+        }
+        finished_++;
+        changed_.notify_all();
+    }
+
+    double StartupGraph::elapsed() const
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - origin_).count();
+    }
+
+    void StartupGraph::logTimeline() const
+    {
+        constexpr int kBarWidth = 40;
+
+        // Tasks are stored in dependency order, so one pass finds the longest chain
+        std::vector<double> chain(tasks_.size(), 0.0);
+        double criticalPath = 0.0;
+        double work = 0.0;
+        for (TaskId id = 0; id < tasks_.size(); id++)
+        {
+            const Task &task = tasks_[id];
+            double before = 0.0;
+            for (const TaskId dependency: task.dependencies) before = std::max(before, chain[dependency]);
+            chain[id] = before + (task.end - task.start);
+            criticalPath = std::max(criticalPath, chain[id]);
+            work += task.end - task.start;
+        }
+
+        spdlog::info("Startup: {:.1f} ms wall, {:.1f} ms critical path, {:.1f} ms of work", wall_, criticalPath,
+                     work);
+        const double scale = wall_ > 0.0 ? kBarWidth / wall_ : 0.0;
+        for (const Task &task: tasks_)
+        {
+            if (!task.ran)
+            {
+                spdlog::info("  {:<14} skipped", task.name);
+                continue;
+            }
+            const int from = std::min(kBarWidth - 1, static_cast<int>(task.start * scale));
+            const int to = std::clamp(static_cast<int>(task.end * scale + 0.5), from + 1, kBarWidth);
+            std::string bar(kBarWidth, ' ');
+            std::fill(bar.begin() + from, bar.begin() + to, '#');
+            spdlog::info("  {:<14} {:<6} {:7.1f} {:7.1f} ms |{}|", task.name,
+                         task.affinity == Affinity::Main ? "main" : "worker", task.start, task.end, bar);
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace todo {
+    class JobSystem;
+
+    // Startup work as a small dependency graph. Each task names the tasks it needs and whether it
+    // must run on the main thread (GLFW windows, the swapchain, ImGui) or may run on a job worker
+    // (file I/O, decoding, Vulkan instance and device creation). A task starts as soon as its last
+    // dependency finishes, so launch time follows the longest dependency chain, not the sum.
+    class StartupGraph
+    {
+    public:
+        using TaskId = std::size_t;
+
+        enum class Affinity
+        {
+            Main,
+            Worker
+        };
+
+        explicit StartupGraph(JobSystem &jobs) : jobs_(jobs)
+        {
+        }
+
+        // Dependencies must be added first, which also keeps the graph acyclic
+        TaskId add(std::string name, Affinity affinity, std::function<void()> work,
+                   std::initializer_list<TaskId> dependencies = {});
+
+        // Runs every task, main-thread ones on the calling thread, and returns when all are done.
+        // After a task throws, tasks that have not started yet are skipped and the first
+        // exception is rethrown once the running ones finish.
+        void run();
+
+        // One line per task with its thread and span, then wall time against the critical path
+        void logTimeline() const;
+
+    private:
+        struct Task
+        {
+            std::string name;
+            Affinity affinity;
+            std::function<void()> work;
+            std::vector<TaskId> dependencies;
+            std::vector<TaskId> dependents;
+            std::size_t remaining = 0; // unfinished dependencies
+            bool ran = false;
+            double start = 0.0; // ms since run()
+            double end = 0.0;
+        };
+
+        void schedule(TaskId id); // with mutex_ held
+        void execute(TaskId id);
+        [[nodiscard]] double elapsed() const;
+
+        JobSystem &jobs_;
+        std::vector<Task> tasks_;
+
+        std::mutex mutex_;
+        std::condition_variable changed_;
+        std::deque<TaskId> mainReady_;
+        std::size_t finished_ = 0;
+        std::exception_ptr error_;
+
+        std::chrono::steady_clock::time_point origin_;
+        double wall_ = 0.0;
+    };
+}
@@ -0,0 +1,201 @@
+#include "tdigest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numbers>
+
+namespace todo {
+    namespace {
+        constexpr std::uint32_t kFormatVersion = 1;
+
+        // k1 scale function: centroids are small near q = 0 and q = 1 and large in the middle
+        double scale(const double q, const double compression)
+        {
+            return compression / (2.0 * std::numbers::pi) * std::asin(2.0 * q - 1.0);
+        }
+
+        double inverseScale(const double k, const double compression)
+        {
+            return (std::sin(std::min(k * 2.0 * std::numbers::pi / compression, std::numbers::pi / 2.0)) + 1.0) / 2.0;
+        }
+
+        template<typename T>
+        void put(std::string &out, const T value)
+        {
+            char bytes[sizeof(T)];
+            std::memcpy(bytes, &value, sizeof(T));
+            out.append(bytes, sizeof(T));
+        }
+
+        template<typename T>
+        bool get(std::string_view &in, T &value)
+        {
+            if (in.size() < sizeof(T)) return false;
+            std::memcpy(&value, in.data(), sizeof(T));
+            in.remove_prefix(sizeof(T));
+            return true;
+        }
+    }
+
+    TDigest::TDigest(const double compression) : compression_(compression)
+    {
+    }
+
+    void TDigest::add(const double value, const double weight)
+    {
+        if (!std::isfinite(value) || weight <= 0.0) return;
+
+        if (empty())
+        {
+            min_ = max_ = value;
+        } else
+        {
+            min_ = std::min(min_, value);
+            max_ = std::max(max_, value);
+        }
+        buffer_.push_back({value, weight});
+        bufferedWeight_ += weight;
+
+        if (buffer_.size() >= static_cast<size_t>(5 * compression_)) compress();
+    }
+
+    void TDigest::merge(const TDigest &other)
+    {
+        if (other.empty()) return;
+        other.compress();
+
+        if (empty())
+        {
+            min_ = other.min_;
+            max_ = other.max_;
+        } else
+        {
+            min_ = std::min(min_, other.min_);
+            max_ = std::max(max_, other.max_);
+        }
+        buffer_.insert(buffer_.end(), other.centroids_.begin(), other.centroids_.end());
+        bufferedWeight_ += other.totalWeight_;
+        compress();
+    }
+
+    void TDigest::compress() const
+    {
+        if (buffer_.empty()) return;
+
+        buffer_.insert(buffer_.end(), centroids_.begin(), centroids_.end());
+        std::ranges::sort(buffer_, {}, &Centroid::mean);
+
+        const double total = totalWeight_ + bufferedWeight_;
+        centroids_.clear();
+
+        // Greedily merge neighbours while the merged centroid stays within one unit of k
+        Centroid current = buffer_.front();
+        double weightSoFar = 0.0;
+        double limit = total * inverseScale(scale(0.0, compression_) + 1.0, compression_);
+        for (size_t i = 1; i < buffer_.size(); i++)
+        {
+            const Centroid &next = buffer_[i];
+            if (weightSoFar + current.weight + next.weight <= limit)
+            {
+                current.mean += (next.mean - current.mean) * next.weight / (current.weight + next.weight);
+                current.weight += next.weight;
+            } else
+            {
+                weightSoFar += current.weight;
+                centroids_.push_back(current);
+                limit = total * inverseScale(scale(weightSoFar / total, compression_) + 1.0, compression_);
+                current = next;
+            }
+        }
+        centroids_.push_back(current);
+
+        buffer_.clear();
+        totalWeight_ = total;
+        bufferedWeight_ = 0.0;
+    }
+
+    double TDigest::quantile(double q) const
+    {
+        compress();
+        if (centroids_.empty()) return std::numeric_limits<double>::quiet_NaN();
+        if (centroids_.size() == 1) return centroids_.front().mean;
+
+        q = std::clamp(q, 0.0, 1.0);
+        const double target = q * totalWeight_;
+
+        // Each centroid's weight is centred on its mean; interpolate between neighbouring
+        // centres, and between the extremes and the outer centres
+        const Centroid &first = centroids_.front();
+        if (target < first.weight / 2.0)
+        {
+            return min_ + (first.mean - min_) * target / (first.weight / 2.0);
+        }
+
+        double cumulative = first.weight / 2.0;
+        for (size_t i = 0; i + 1 < centroids_.size(); i++)
+        {
+            const Centroid &left = centroids_[i];
+            const Centroid &right = centroids_[i + 1];
+            const double gap = (left.weight + right.weight) / 2.0;
+            if (target <= cumulative + gap)
+            {
+                return left.mean + (right.mean - left.mean) * (target - cumulative) / gap;
+            }
+            cumulative += gap;
+        }
+
+        const Centroid &last = centroids_.back();
+        const double tail = last.weight / 2.0;
+        return last.mean + (max_ - last.mean) * std::min(1.0, (target - cumulative) / tail);
+    }
+
+    std::string TDigest::serialize() const
+    {
+        compress();
+
+        std::string out;
+        out.reserve(4 * sizeof(double) + sizeof(std::uint32_t) * 2 + centroids_.size() * sizeof(Centroid));
+        put(out, kFormatVersion);
+        put(out, compression_);
+        put(out, min_);
+        put(out, max_);
+        put(out, static_cast<std::uint32_t>(centroids_.size()));
+        for (const auto &centroid: centroids_)
+        {
+            put(out, centroid.mean);
+            put(out, centroid.weight);
+        }
+        return out;
+    }
+
+    std::optional<TDigest> TDigest::deserialize(std::string_view blob)
+    {
+        std::uint32_t version = 0, count = 0;
+        double compression = 0.0;
+        if (!get(blob, version) || version != kFormatVersion || !get(blob, compression) || compression <= 0.0)
+        {
+            return std::nullopt;
+        }
+
+        TDigest digest(compression);
+        if (!get(blob, digest.min_) || !get(blob, digest.max_) || !get(blob, count) ||
+            blob.size() != count * 2 * sizeof(double))
+        {
+            return std::nullopt;
+        }
+
+        digest.centroids_.reserve(count);
+        for (std::uint32_t i = 0; i < count; i++)
+        {
+            Centroid centroid{};
+            get(blob, centroid.mean);
+            get(blob, centroid.weight);
+            digest.centroids_.push_back(centroid);
+            digest.totalWeight_ += centroid.weight;
+        }
+        return digest;
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace todo {
+    // Merging t-digest (Dunning & Ertl): a fixed-size quantile sketch that is accurate at the
+    // tails, where p85/p95 live, and can be merged, so sketches built from separate slices of
+    // the data (threads, projects) combine into the sketch of the whole.
+    // Memory is O(compression) centroids regardless of how many values were added.
+    class TDigest
+    {
+    public:
+        explicit TDigest(double compression = 100.0);
+
+        void add(double value, double weight = 1.0);
+        void merge(const TDigest &other);
+
+        // Estimated value at quantile q in [0, 1]; NaN when empty
+        [[nodiscard]] double quantile(double q) const;
+        [[nodiscard]] double count() const { return totalWeight_ + bufferedWeight_; }
+        [[nodiscard]] bool empty() const { return count() == 0.0; }
+
+        // Compact binary form for persisting; deserialize returns nullopt for damaged input
+        [[nodiscard]] std::string serialize() const;
+        static std::optional<TDigest> deserialize(std::string_view blob);
+
+    private:
+        struct Centroid
+        {
+            double mean;
+            double weight;
+        };
+
+        // Folds buffered values into the centroids. Logically const: the distribution is unchanged.
+        void compress() const;
+
+        double compression_;
+        double min_ = 0.0;
+        double max_ = 0.0;
+
+        mutable std::vector<Centroid> centroids_;
+        mutable std::vector<Centroid> buffer_;
+        mutable double totalWeight_ = 0.0;
+        mutable double bufferedWeight_ = 0.0;
+    };
+}
@@ -4,7 +4,6 @@
 
 #pragma once
 #include <string>
-#include "glm/vec4.hpp"
 #include <chrono>
 #include <iomanip>
 #include <utility>
@@ -29,12 +28,10 @@ namespace todo {
         int projectId;
         std::string createdAt;
         std::string completedAt;
-        glm::vec4 color{};
 
         // Default constructor
         TodoCard() : id(-1), status(CardStatus::Todo), sequence(-1), projectId(0)
         {
-            color = glm::vec4(0.3f, 0.3f, 0.8f, 1.0f);
         }
 
         TodoCard(const int _id, std::string _title, std::string _desc, const CardStatus _status,
@@ -44,8 +41,6 @@ namespace todo {
               , sequence(_sequence), projectId(_projectId),
               createdAt(std::move(_createdAt)), completedAt(std::move(_completedAt))
         {
-            // Assign different colors based on completion status
-            color = glm::vec4(0.3f, 0.3f, 0.8f, 1.0f);
         }
     };
 
@@ -0,0 +1,195 @@
+#include "trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+
+namespace todo {
+    namespace {
+        struct Span
+        {
+            const char *name;
+            std::int64_t start;
+            std::int64_t end;
+        };
+
+        // The owning thread is the only writer. It fills `spans` and then publishes them through
+        // `count` (release), and links a fresh chunk through `next` once this one is full; readers
+        // only ever look at what has been published.
+        struct Chunk
+        {
+            static constexpr std::size_t kCapacity = 4096;
+
+            Span spans[kCapacity];
+            std::atomic<std::size_t> count = 0;
+            std::atomic<Chunk *> next = nullptr;
+        };
+
+        // Caps a runaway span in a per-frame path at a few MB per thread
+        constexpr std::size_t kMaxChunks = 64;
+
+        struct ThreadTrace
+        {
+            int tid = 0;
+            std::string name; // guarded by the registry mutex
+            Chunk *head = nullptr;
+            Chunk *tail = nullptr; // owning thread only
+            std::size_t chunks = 0; // owning thread only
+            std::atomic<std::uint64_t> dropped = 0;
+
+            ~ThreadTrace()
+            {
+                for (Chunk *chunk = head; chunk;)
+                {
+                    Chunk *next = chunk->next.load(std::memory_order_relaxed);
+                    delete chunk;
+                    chunk = next;
+                }
+            }
+        };
+
+        // Buffers outlive their threads so spans from finished workers still get written
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ThreadTrace>> threads;
+        };
+
+        Registry &registry()
+        {
+            static Registry instance;
+            return instance;
+        }
+
+        const std::int64_t processStart = TraceScope::now();
+
+        ThreadTrace &threadTrace()
+        {
+            thread_local ThreadTrace *trace = []
+            {
+                auto created = std::make_unique<ThreadTrace>();
+                created->head = created->tail = new Chunk;
+                created->chunks = 1;
+
+                Registry &reg = registry();
+                std::lock_guard lock(reg.mutex);
+                created->tid = static_cast<int>(reg.threads.size()) + 1;
+                reg.threads.push_back(std::move(created));
+                return reg.threads.back().get();
+            }();
+            return *trace;
+        }
+
+        void record(const char *name, const std::int64_t start, const std::int64_t end)
+        {
+            ThreadTrace &trace = threadTrace();
+            Chunk *chunk = trace.tail;
+            std::size_t index = chunk->count.load(std::memory_order_relaxed);
+            if (index == Chunk::kCapacity)
+            {
+                if (trace.chunks == kMaxChunks)
+                {
+                    trace.dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                auto *next = new Chunk;
+                chunk->next.store(next, std::memory_order_release);
+                trace.tail = chunk = next;
+                trace.chunks++;
+                index = 0;
+            }
+            chunk->spans[index] = {name, start, end};
+            chunk->count.store(index + 1, std::memory_order_release);
+        }
+
+        void writeEscaped(std::FILE *file, const std::string &text)
+        {
+            for (const char c: text)
+            {
+                if (c == '"' || c == '\\') std::fputc('\\', file);
+                if (static_cast<unsigned char>(c) < 0x20) std::fprintf(file, "\\u%04x", c);
+                else std::fputc(c, file);
+            }
+        }
+    }
+
+    TraceScope::~TraceScope()
+    {
+        record(name_, start_, now());
+    }
+
+    std::int64_t TraceScope::now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void setTraceThreadName(std::string name)
+    {
+        ThreadTrace &trace = threadTrace();
+        std::lock_guard lock(registry().mutex);
+        trace.name = std::move(name);
+    }
+
+    bool writeChromeTrace(const std::string &path)
+    {
+        std::FILE *file = std::fopen(path.c_str(), "w");
+        if (!file)
+        {
+            spdlog::error("Failed to write trace {}", path);
+            return false;
+        }
+
+        // Complete ("X") events in microseconds since launch, one track per thread
+        std::size_t spans = 0;
+        std::uint64_t dropped = 0;
+        bool first = true;
+        auto separator = [&] { std::fputs(first ? "\n" : ",\n", file); first = false; };
+
+        std::fputs("{\"traceEvents\": [", file);
+        {
+            Registry &reg = registry();
+            std::lock_guard lock(reg.mutex);
+            for (const auto &thread: reg.threads)
+            {
+                separator();
+                std::fprintf(file, R"({"name":"thread_name","ph":"M","pid":1,"tid":%d,"args":{"name":")",
+                             thread->tid);
+                writeEscaped(file, thread->name.empty() ? "thread " + std::to_string(thread->tid) : thread->name);
+                std::fputs("\"}}", file);
+
+                for (const Chunk *chunk = thread->head; chunk; chunk = chunk->next.load(std::memory_order_acquire))
+                {
+                    const std::size_t count = chunk->count.load(std::memory_order_acquire);
+                    for (std::size_t i = 0; i < count; i++)
+                    {
+                        const Span &span = chunk->spans[i];
+                        separator();
+                        std::fputs(R"({"name":")", file);
+                        writeEscaped(file, span.name);
+                        std::fprintf(file, R"(","ph":"X","pid":1,"tid":%d,"ts":%.3f,"dur":%.3f})", thread->tid,
+                                     static_cast<double>(span.start - processStart) / 1000.0,
+                                     static_cast<double>(span.end - span.start) / 1000.0);
+                    }
+                    spans += count;
+                }
+                dropped += thread->dropped.load(std::memory_order_relaxed);
+            }
+        }
+        std::fputs("\n]}\n", file);
+
+        if (std::fclose(file) != 0)
+        {
+            spdlog::error("Failed to write trace {}", path);
+            return false;
+        }
+        if (dropped > 0) spdlog::warn("Trace buffers were full; {} spans were dropped", dropped);
+        spdlog::info("Wrote {} trace spans to {}", spans, path);
+        return true;
+    }
+}
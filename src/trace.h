@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace todo {
+    // Scoped spans for startup and shutdown, written out as Chrome trace_event JSON that opens in
+    // Perfetto or chrome://tracing. Every thread records into its own append-only buffer, with
+    // no locks or allocation on the recording path beyond one buffer chunk per 4096 spans, and
+    // writeChromeTrace() can run while other threads keep recording.
+    //
+    // Span names are stored as pointers, so they must be string literals.
+    class TraceScope
+    {
+    public:
+        explicit TraceScope(const char *name) : name_(name), start_(now())
+        {
+        }
+
+        ~TraceScope();
+
+        TraceScope(const TraceScope &) = delete;
+        TraceScope &operator=(const TraceScope &) = delete;
+
+        // Nanoseconds on the steady clock
+        static std::int64_t now();
+
+    private:
+        const char *name_;
+        std::int64_t start_;
+    };
+
+    // Labels the calling thread's track; unnamed threads are shown by number
+    void setTraceThreadName(std::string name);
+
+    // Every span recorded so far, as {"traceEvents": [...]}
+    bool writeChromeTrace(const std::string &path);
+}
+
+#define TODO_TRACE_CONCAT_(a, b) a##b
+#define TODO_TRACE_CONCAT(a, b) TODO_TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) ::todo::TraceScope TODO_TRACE_CONCAT(traceScope_, __LINE__)(name)
@@ -0,0 +1,43 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+
+#include "spdlog/spdlog.h"
+
+namespace todo {
+    // Return type of fire-and-forget UI coroutines. The coroutine starts right away, runs on
+    // the UI thread up to its first co_await on a DatabaseReader read, and continues in a later
+    // frame when the main loop drains completions. There is no handle to keep or join; a
+    // coroutine still waiting at shutdown is destroyed without being resumed.
+    //
+    //     UiTask ImGuiRenderer::refreshStatistics(int days, int projectId)
+    //     {
+    //         statsSummary_ = co_await app_->queries().stats(days, projectId);
+    //     }
+    //
+    // Take parameters by value: references to the caller's locals dangle after the first co_await.
+    struct UiTask
+    {
+        struct promise_type
+        {
+            UiTask get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+
+            void unhandled_exception() noexcept
+            {
+                try
+                {
+                    throw;
+                } catch (const std::exception &e)
+                {
+                    spdlog::error("UI task failed: {}", e.what());
+                } catch (...)
+                {
+                    spdlog::error("UI task failed");
+                }
+            }
+        };
+    };
+}
@@ -38,14 +38,42 @@ std::string getDatabasePath() {
     return getAppDataPath() + "/todos.db";
 }
 
+std::string getArchivePath() {
+    return getAppDataPath() + "/archive.db";
+}
+
+std::string getSnapshotPath() {
+    return getAppDataPath() + "/board.snapshot";
+}
+
+std::string getTracePath() {
+    return getAppDataPath() + "/trace.json";
+}
+
 #else
 std::string getResourcesPath() {
     return "./assets/";
 }
 
+std::string getAppDataPath() {
+    return ".";  // Fallback for other platforms
+}
+
 std::string getDatabasePath() {
     return "./todos.db";  // Fallback for other platforms
 }
+
+std::string getArchivePath() {
+    return "./archive.db";  // Fallback for other platforms
+}
+
+std::string getSnapshotPath() {
+    return "./board.snapshot";  // Fallback for other platforms
+}
+
+std::string getTracePath() {
+    return "./trace.json";  // Fallback for other platforms
+}
 #endif
 
 std::string getCurrentTimestamp() {
@@ -5,4 +5,7 @@
 std::string getResourcesPath();
 std::string getAppDataPath();
 std::string getDatabasePath();
+std::string getArchivePath();
+std::string getSnapshotPath();
+std::string getTracePath();
 std::string getCurrentTimestamp();
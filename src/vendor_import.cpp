@@ -0,0 +1,616 @@
+#include "vendor_import.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "card_database.h"
+#include "json_stream.h"
+#include "spdlog/spdlog.h"
+
+namespace todo {
+    namespace {
+        constexpr size_t kChunkSize = 16384;
+        constexpr std::uint64_t kProgressInterval = 4 << 20;
+
+        // Tracks where the parser is as a path such as ".cards[].name" (array elements share
+        // the "[]" segment), so subclasses can match fields without building a DOM.
+        class PathHandler : public JsonReader::Handler
+        {
+        public:
+            bool startObject() override
+            {
+                frames_.push_back(path_.size());
+                return enter(path_);
+            }
+
+            bool endObject() override
+            {
+                path_.resize(frames_.back());
+                frames_.pop_back();
+                return leave(path_);
+            }
+
+            bool startArray() override
+            {
+                frames_.push_back(path_.size());
+                path_ += "[]";
+                return true;
+            }
+
+            bool endArray() override
+            {
+                path_.resize(frames_.back());
+                frames_.pop_back();
+                return true;
+            }
+
+            bool key(const std::string_view name) override
+            {
+                path_.resize(frames_.back());
+                path_ += '.';
+                path_ += name;
+                return true;
+            }
+
+            bool string(const std::string_view value) override { return this->value(path_, value); }
+            bool number(const std::string_view value) override { return this->value(path_, value); }
+            bool boolean(const bool value) override { return this->value(path_, value ? "true" : "false"); }
+            bool null() override { return this->value(path_, {}); }
+
+        protected:
+            // Object start/end, with the object's own path
+            virtual bool enter(std::string_view path) { return true; }
+            virtual bool leave(std::string_view path) { return true; }
+            virtual bool value(std::string_view path, std::string_view value) = 0;
+
+        private:
+            std::string path_;
+            std::vector<size_t> frames_;
+        };
+
+        bool contains(const std::string_view text, const std::string_view word)
+        {
+            return text.find(word) != std::string_view::npos;
+        }
+
+        std::string lowercase(const std::string_view text)
+        {
+            std::string out(text);
+            std::ranges::transform(out, out.begin(), [](const unsigned char c) { return std::tolower(c); });
+            return out;
+        }
+
+        // Trello lists and Jira statuses are free-form; map the common workflow names
+        CardStatus statusForName(const std::string_view name)
+        {
+            const std::string lower = lowercase(name);
+            for (const auto word: {"done", "complete", "finished", "closed", "resolved", "shipped"})
+            {
+                if (contains(lower, word)) return CardStatus::Done;
+            }
+            for (const auto word: {"doing", "progress", "review", "testing", "active", "wip"})
+            {
+                if (contains(lower, word)) return CardStatus::InProgress;
+            }
+            return CardStatus::Todo;
+        }
+
+        // "YYYY-MM-DD HH:MM:SS" in UTC, like CURRENT_TIMESTAMP
+        std::string formatUtc(const std::time_t seconds)
+        {
+            std::tm tm{};
+#ifdef _WIN32
+            gmtime_s(&tm, &seconds);
+#else
+            gmtime_r(&seconds, &tm);
+#endif
+            char buffer[20];
+            std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
+            return buffer;
+        }
+
+        // Fixed-width decimal field; -1 if it is not all digits
+        int digits(const std::string_view text, const size_t pos, const size_t count)
+        {
+            if (pos + count > text.size()) return -1;
+            int value = 0;
+            for (const char c: text.substr(pos, count))
+            {
+                if (!std::isdigit(static_cast<unsigned char>(c))) return -1;
+                value = value * 10 + (c - '0');
+            }
+            return value;
+        }
+
+        // "2024-03-01T12:34:56.789Z" (Trello) or "2024-03-01T12:34:56.789+0100" (Jira) -> UTC
+        // "2024-03-01 11:34:56". No zone designator is read as UTC.
+        std::string sqliteTimestamp(const std::string_view iso)
+        {
+            const int year = digits(iso, 0, 4), month = digits(iso, 5, 2), day = digits(iso, 8, 2);
+            const int hour = digits(iso, 11, 2), minute = digits(iso, 14, 2), second = digits(iso, 17, 2);
+            if (year < 0 || month < 0 || day < 0 || hour < 0 || minute < 0 || second < 0) return {};
+
+            // Skip fractional seconds, then read +hh:mm, +hhmm or +hh
+            size_t pos = 19;
+            if (pos < iso.size() && iso[pos] == '.')
+            {
+                for (pos++; pos < iso.size() && std::isdigit(static_cast<unsigned char>(iso[pos])); pos++)
+                {
+                }
+            }
+            int offsetMinutes = 0;
+            if (pos < iso.size() && (iso[pos] == '+' || iso[pos] == '-'))
+            {
+                const int sign = iso[pos] == '-' ? -1 : 1;
+                const int offsetHours = digits(iso, pos + 1, 2);
+                if (offsetHours < 0) return {};
+                size_t minutesAt = pos + 3;
+                if (minutesAt < iso.size() && iso[minutesAt] == ':') minutesAt++;
+                const int offsetMins = minutesAt < iso.size() ? digits(iso, minutesAt, 2) : 0;
+                if (offsetMins < 0) return {};
+                offsetMinutes = sign * (offsetHours * 60 + offsetMins);
+            }
+
+            using namespace std::chrono;
+            const year_month_day date{std::chrono::year{year}, std::chrono::month{static_cast<unsigned>(month)},
+                                      std::chrono::day{static_cast<unsigned>(day)}};
+            if (!date.ok()) return {};
+            const sys_seconds local = sys_days{date} + hours{hour} + minutes{minute} + seconds{second};
+            return formatUtc(system_clock::to_time_t(local - minutes{offsetMinutes}));
+        }
+
+        // Trello ids are Mongo ObjectIds: the first 8 hex digits are the creation time
+        std::string trelloCreatedAt(const std::string_view id)
+        {
+            if (id.size() < 8) return {};
+
+            std::time_t seconds = 0;
+            for (const char c: id.substr(0, 8))
+            {
+                const int digit = std::isdigit(static_cast<unsigned char>(c))
+                                      ? c - '0'
+                                      : std::tolower(static_cast<unsigned char>(c)) - 'a' + 10;
+                if (digit < 0 || digit > 15) return {};
+                seconds = seconds * 16 + digit;
+            }
+            return formatUtc(seconds);
+        }
+
+        // Shared write side: chunks of cards through applyBatch, each committed on its own so the
+        // writer lock is released between chunks, and throttled progress reports
+        class ImportSink
+        {
+        public:
+            ImportSink(CardDatabase &db, TransferStats &stats, const TransferProgress &progress, const std::uint64_t total)
+                : db_(db), stats_(stats), progress_(progress), total_(total)
+            {
+                batch_.reserve(kChunkSize);
+            }
+
+            bool addProject(const std::string &name, int &projectId)
+            {
+                if (!db_.addProject(name, proj::statusToInt(proj::ProjectStatus::ACTIVE), &projectId))
+                {
+                    failed_ = true;
+                    return false;
+                }
+                stats_.projects++;
+                return true;
+            }
+
+            bool addCard(TodoCard card)
+            {
+                batch_.insert(std::move(card));
+                return batch_.size() < kChunkSize || flush();
+            }
+
+            bool flush()
+            {
+                if (batch_.empty()) return true;
+                if (!db_.applyBatch(batch_.mutations(), nullptr, true))
+                {
+                    failed_ = true;
+                    return false;
+                }
+                stats_.cards += batch_.size();
+                batch_.clear();
+                return true;
+            }
+
+            // `done` is the overall byte position (both passes for Trello)
+            bool report(const std::uint64_t done)
+            {
+                if (!progress_ || done < lastReported_ + kProgressInterval) return true;
+                lastReported_ = done;
+                if (!progress_(done, total_))
+                {
+                    cancelled_ = true;
+                    return false;
+                }
+                return true;
+            }
+
+            [[nodiscard]] bool failed() const { return failed_; }
+            [[nodiscard]] bool cancelled() const { return cancelled_; }
+
+        private:
+            CardDatabase &db_;
+            TransferStats &stats_;
+            const TransferProgress &progress_;
+            std::uint64_t total_;
+            std::uint64_t lastReported_ = 0;
+
+            CardBatch batch_;
+            bool failed_ = false;
+            bool cancelled_ = false;
+        };
+
+        struct TrelloList
+        {
+            CardStatus status = CardStatus::Todo;
+            bool closed = false;
+        };
+
+        // Pass 1: the board name and every list. Lists may come after the cards in the export.
+        class TrelloListsHandler final : public PathHandler
+        {
+        public:
+            TrelloListsHandler(ImportSink &sink, const JsonReader &reader) : sink_(sink), reader_(reader)
+            {
+            }
+
+            std::string boardName;
+            std::unordered_map<std::string, TrelloList> lists;
+
+        protected:
+            bool enter(const std::string_view path) override
+            {
+                if (path == ".lists[]") current_ = {};
+                return true;
+            }
+
+            bool leave(const std::string_view path) override
+            {
+                if (path == ".lists[]" && !current_.id.empty())
+                {
+                    lists[current_.id] = {statusForName(current_.name), current_.closed};
+                }
+                return sink_.report(reader_.bytesConsumed());
+            }
+
+            bool value(const std::string_view path, const std::string_view value) override
+            {
+                if (path == ".name") boardName.assign(value);
+                else if (path == ".lists[].id") current_.id.assign(value);
+                else if (path == ".lists[].name") current_.name.assign(value);
+                else if (path == ".lists[].closed") current_.closed = value == "true";
+                return true;
+            }
+
+        private:
+            struct
+            {
+                std::string id;
+                std::string name;
+                bool closed = false;
+            } current_;
+
+            ImportSink &sink_;
+            const JsonReader &reader_;
+        };
+
+        // Pass 2: cards, written as they complete
+        class TrelloCardsHandler final : public PathHandler
+        {
+        public:
+            TrelloCardsHandler(ImportSink &sink, const JsonReader &reader, const TrelloListsHandler &lists,
+                               const int projectId, const std::uint64_t offset)
+                : sink_(sink), reader_(reader), lists_(lists), projectId_(projectId), offset_(offset)
+            {
+            }
+
+            std::uint64_t skipped = 0;
+
+        protected:
+            bool enter(const std::string_view path) override
+            {
+                if (path == ".cards[]")
+                {
+                    id_.clear();
+                    name_.clear();
+                    desc_.clear();
+                    listId_.clear();
+                    lastActivity_.clear();
+                    closed_ = false;
+                }
+                return true;
+            }
+
+            bool leave(const std::string_view path) override
+            {
+                if (path == ".cards[]" && !addCard()) return false;
+                return sink_.report(offset_ + reader_.bytesConsumed());
+            }
+
+            bool value(const std::string_view path, const std::string_view value) override
+            {
+                if (!path.starts_with(".cards[].")) return true;
+
+                const std::string_view field = path.substr(9);
+                if (field == "id") id_.assign(value);
+                else if (field == "name") name_.assign(value);
+                else if (field == "desc") desc_.assign(value);
+                else if (field == "idList") listId_.assign(value);
+                else if (field == "dateLastActivity") lastActivity_.assign(value);
+                else if (field == "closed") closed_ = value == "true";
+                return true;
+            }
+
+        private:
+            bool addCard()
+            {
+                // Archived cards and cards on archived lists stay behind
+                const auto list = lists_.lists.find(listId_);
+                if (closed_ || (list != lists_.lists.end() && list->second.closed))
+                {
+                    skipped++;
+                    return true;
+                }
+
+                const CardStatus status = list != lists_.lists.end() ? list->second.status : CardStatus::Todo;
+                return sink_.addCard(TodoCard(-1, name_, desc_, status, -1, projectId_, trelloCreatedAt(id_),
+                                              status == CardStatus::Done ? sqliteTimestamp(lastActivity_) : ""));
+            }
+
+            ImportSink &sink_;
+            const JsonReader &reader_;
+            const TrelloListsHandler &lists_;
+            int projectId_;
+            std::uint64_t offset_;
+
+            std::string id_;
+            std::string name_;
+            std::string desc_;
+            std::string listId_;
+            std::string lastActivity_;
+            bool closed_ = false;
+        };
+
+        // Single pass over {"issues": [{"key": ..., "fields": {...}}]}
+        class JiraIssuesHandler final : public PathHandler
+        {
+        public:
+            JiraIssuesHandler(ImportSink &sink, const JsonReader &reader) : sink_(sink), reader_(reader)
+            {
+            }
+
+        protected:
+            bool enter(const std::string_view path) override
+            {
+                if (path == ".issues[]")
+                {
+                    key_.clear();
+                    summary_.clear();
+                    description_.clear();
+                    statusName_.clear();
+                    statusCategory_.clear();
+                    project_.clear();
+                    created_.clear();
+                    resolved_.clear();
+                }
+                return true;
+            }
+
+            bool leave(const std::string_view path) override
+            {
+                if (path == ".issues[]" && !addIssue()) return false;
+
+                // Rich-text (ADF) descriptions: one line per top-level block
+                if (path == ".issues[].fields.description.content[]" && !description_.empty() &&
+                    description_.back() != '\n')
+                {
+                    description_ += '\n';
+                }
+                return sink_.report(reader_.bytesConsumed());
+            }
+
+            bool value(const std::string_view path, const std::string_view value) override
+            {
+                if (path == ".issues[].key") key_.assign(value);
+                else if (path == ".issues[].fields.summary") summary_.assign(value);
+                else if (path == ".issues[].fields.description") description_.assign(value);
+                else if (path.starts_with(".issues[].fields.description.") && path.ends_with(".text"))
+                {
+                    description_.append(value);
+                }
+                else if (path == ".issues[].fields.status.name") statusName_.assign(value);
+                else if (path == ".issues[].fields.status.statusCategory.key") statusCategory_.assign(value);
+                else if (path == ".issues[].fields.project.name") project_.assign(value);
+                else if (path == ".issues[].fields.project.key" && project_.empty()) project_.assign(value);
+                else if (path == ".issues[].fields.created") created_.assign(value);
+                else if (path == ".issues[].fields.resolutiondate") resolved_.assign(value);
+                return true;
+            }
+
+        private:
+            bool addIssue()
+            {
+                int projectId = 0;
+                if (!project_.empty())
+                {
+                    const auto it = projects_.find(project_);
+                    if (it != projects_.end())
+                    {
+                        projectId = it->second;
+                    } else
+                    {
+                        if (!sink_.addProject(project_, projectId)) return false;
+                        projects_.emplace(project_, projectId);
+                    }
+                }
+
+                // Status categories are fixed across Jira workflows; names are only a fallback
+                CardStatus status = statusForName(statusName_);
+                if (statusCategory_ == "done") status = CardStatus::Done;
+                else if (statusCategory_ == "indeterminate") status = CardStatus::InProgress;
+                else if (statusCategory_ == "new") status = CardStatus::Todo;
+
+                while (!description_.empty() && description_.back() == '\n') description_.pop_back();
+
+                std::string title = key_.empty() ? summary_ : key_ + " " + summary_;
+                return sink_.addCard(TodoCard(-1, std::move(title), description_, status, -1, projectId,
+                                              sqliteTimestamp(created_),
+                                              status == CardStatus::Done ? sqliteTimestamp(resolved_) : ""));
+            }
+
+            ImportSink &sink_;
+            const JsonReader &reader_;
+            std::unordered_map<std::string, int> projects_;
+
+            std::string key_;
+            std::string summary_;
+            std::string description_;
+            std::string statusName_;
+            std::string statusCategory_;
+            std::string project_;
+            std::string created_;
+            std::string resolved_;
+        };
+
+        // Stops at the first top-level key that identifies the format
+        class SniffHandler final : public PathHandler
+        {
+        public:
+            explicit SniffHandler(const JsonReader &reader) : reader_(reader)
+            {
+            }
+
+            std::optional<VendorFormat> format;
+
+            bool key(const std::string_view name) override
+            {
+                if (!PathHandler::key(name)) return false;
+                if (depth_ == 1)
+                {
+                    if (name == "issues") format = VendorFormat::Jira;
+                    else if (name == "lists" || name == "cards" || name == "idOrganization" || name == "shortLink")
+                    {
+                        format = VendorFormat::Trello;
+                    }
+                }
+                // Give up on files that do not say what they are early on
+                return !format && reader_.bytesConsumed() < (1 << 20);
+            }
+
+        protected:
+            bool enter(std::string_view) override
+            {
+                depth_++;
+                return true;
+            }
+
+            bool leave(std::string_view) override
+            {
+                // One top-level object is enough (JSON Lines files have many)
+                return --depth_ > 0;
+            }
+
+            bool value(std::string_view, std::string_view) override { return true; }
+
+        private:
+            const JsonReader &reader_;
+            int depth_ = 0;
+        };
+    }
+
+    std::optional<VendorFormat> detectVendorFormat(const std::string &path)
+    {
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        if (!file) return std::nullopt;
+
+        JsonReader reader(file, 64 << 10);
+        SniffHandler handler(reader);
+        reader.parse(handler);
+        std::fclose(file);
+        return handler.format;
+    }
+
+    bool importVendorExport(CardDatabase &db, const std::string &path, const VendorFormat format,
+                            TransferStats *stats, const TransferProgress &progress)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        TransferStats local;
+        TransferStats &counts = stats ? *stats : local;
+        counts = {};
+
+        std::error_code ec;
+        const std::uint64_t size = std::filesystem::file_size(path, ec);
+        // Trello is read twice: lists first, then cards
+        const std::uint64_t total = format == VendorFormat::Trello ? size * 2 : size;
+
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        if (!file)
+        {
+            spdlog::error("Failed to open {} for import", path);
+            return false;
+        }
+
+        ImportSink sink(db, counts, progress, total);
+        std::string parseError;
+        std::uint64_t skipped = 0;
+        bool success;
+
+        if (format == VendorFormat::Trello)
+        {
+            JsonReader listsReader(file);
+            TrelloListsHandler lists(sink, listsReader);
+            success = listsReader.parse(lists);
+            if (!success) parseError = listsReader.error();
+
+            int projectId = 0;
+            success = success && sink.addProject(lists.boardName.empty() ? "Trello board" : lists.boardName, projectId);
+
+            if (success)
+            {
+                std::rewind(file);
+                JsonReader cardsReader(file);
+                TrelloCardsHandler cards(sink, cardsReader, lists, projectId, size);
+                success = cardsReader.parse(cards) && sink.flush();
+                if (!success) parseError = cardsReader.error();
+                skipped = cards.skipped;
+            }
+        } else
+        {
+            JsonReader reader(file);
+            JiraIssuesHandler issues(sink, reader);
+            success = reader.parse(issues) && sink.flush();
+            if (!success) parseError = reader.error();
+        }
+        std::fclose(file);
+
+        // Like importBoard, chunks already written stay; the counts say how far it got
+        if (!success)
+        {
+            if (sink.cancelled()) spdlog::info("Import from {} cancelled after {} cards", path, counts.cards);
+            else
+                spdlog::error("Import from {} stopped after {} cards{}{}", path, counts.cards,
+                              parseError.empty() ? "" : ": ", parseError);
+            return false;
+        }
+
+        counts.bytes = size;
+        counts.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (progress) progress(total, total);
+        spdlog::info("Imported {} projects and {} cards from {} in {:.2f} s", counts.projects, counts.cards, path,
+                     counts.seconds);
+        if (skipped > 0) spdlog::info("Skipped {} archived Trello cards", skipped);
+        return true;
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <optional>
+#include <string>
+
+#include "board_transfer.h"
+
+namespace todo {
+    class CardDatabase;
+
+    // Board exports of other tools, read with the streaming JsonReader:
+    //   Trello: the board JSON export; the board becomes a project, lists map to a CardStatus
+    //   Jira:   a search/export response ({"issues": [...]}); each Jira project becomes a project
+    enum class VendorFormat
+    {
+        Trello,
+        Jira
+    };
+
+    // Looks at the first top-level keys only, so large files are not read in full
+    std::optional<VendorFormat> detectVendorFormat(const std::string &path);
+
+    // Streams the export into the board in fixed-size chunks, one transaction per chunk like
+    // importBoard, so memory use stays flat and other writers get the lock between chunks.
+    // Chunks written before a failure or cancel are kept; `stats` counts them.
+    bool importVendorExport(CardDatabase &db, const std::string &path, VendorFormat format,
+                            TransferStats *stats = nullptr, const TransferProgress &progress = {});
+}